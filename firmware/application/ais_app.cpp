@@ -298,7 +298,6 @@ void AISRecentEntryDetailView::set_entry(const AISRecentEntry& entry) {
 AISAppView::AISAppView(NavigationView&) {
 	add_children({ {
 		&label_channel,
-		&options_channel,
 		&recent_entries_view,
 		&recent_entry_detail_view,
 	} });
@@ -314,8 +313,6 @@ AISAppView::AISAppView(NavigationView&) {
 			}
 		}
 	);
-	
-	target_frequency_ = initial_target_frequency;
 
 	radio::enable({
 		tuning_frequency(),
@@ -332,11 +329,6 @@ AISAppView::AISAppView(NavigationView&) {
 		.decimation_factor = 1,
 	});
 
-	options_channel.on_change = [this](size_t, OptionsField::value_t v) {
-		this->on_frequency_changed(v);
-	};
-	options_channel.set_by_value(target_frequency());
-
 	recent_entries_view.on_select = [this](const AISRecentEntry& entry) {
 		this->on_show_detail(entry);
 	};
@@ -355,7 +347,7 @@ AISAppView::~AISAppView() {
 }
 
 void AISAppView::focus() {
-	options_channel.focus();
+	recent_entries_view.focus();
 }
 
 void AISAppView::set_parent_rect(const Rect new_parent_rect) {
@@ -371,7 +363,7 @@ void AISAppView::on_packet(const ais::Packet& packet) {
 	}
 
 	const auto updated_entry = recent.on_packet(packet.source_id(), packet);
-	recent_entries_view.set_dirty();
+	recent_entries_view.on_entry_updated(updated_entry.key());
 
 	// TODO: Crude hack, should be a more formal listener arrangement...
 	if( updated_entry.key() == recent_entry_detail_view.entry().key() ) {
@@ -392,21 +384,8 @@ void AISAppView::on_show_detail(const AISRecentEntry& entry) {
 	recent_entry_detail_view.focus();
 }
 
-void AISAppView::on_frequency_changed(const uint32_t new_target_frequency) {
-	set_target_frequency(new_target_frequency);
-}
-
-void AISAppView::set_target_frequency(const uint32_t new_value) {
-	target_frequency_ = new_value;
-	radio::set_tuning_frequency(tuning_frequency());
-}
-
-uint32_t AISAppView::target_frequency() const {
-	return target_frequency_;
-}
-
 uint32_t AISAppView::tuning_frequency() const {
-	return target_frequency() - (sampling_rate / 4);
+	return target_frequency - (sampling_rate / 4);
 }
 
 } /* namespace ui */
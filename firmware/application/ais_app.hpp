@@ -147,7 +147,8 @@ public:
 	std::string title() const override { return "AIS"; };
 
 private:
-	static constexpr uint32_t initial_target_frequency = 162025000;
+	/* Between 87B (161.975MHz) and 88B (162.025MHz), both decoded at once. */
+	static constexpr uint32_t target_frequency = 162000000;
 	static constexpr uint32_t sampling_rate = 2457600;
 	static constexpr uint32_t baseband_bandwidth = 1750000;
 
@@ -160,30 +161,14 @@ private:
 	static constexpr auto header_height = 1 * 16;
 
 	Text label_channel {
-		{ 0 * 8, 0 * 16, 2 * 8, 1 * 16 },
-		"Ch"
+		{ 0 * 8, 0 * 16, 10 * 8, 1 * 16 },
+		"Ch 87B+88B"
 	};
 
-	OptionsField options_channel {
-		{ 3 * 8, 0 * 16 },
-		3,
-		{
-			{ "87B", 161975000 },
-			{ "88B", 162025000 },
-		}
-	};
-
-	uint32_t target_frequency_ = initial_target_frequency;
-
 	void on_packet(const ais::Packet& packet);
 	void on_show_list();
 	void on_show_detail(const AISRecentEntry& entry);
 
-	void on_frequency_changed(const uint32_t new_target_frequency);
-
-	uint32_t target_frequency() const;
-	void set_target_frequency(const uint32_t new_value);
-
 	uint32_t tuning_frequency() const;
 };
 
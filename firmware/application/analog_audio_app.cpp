@@ -285,6 +285,9 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 		.mode = toUType(modulation),
 		.sampling_rate = is_wideband_spectrum_mode ? 20000000U : 3072000U,
 		.decimation_factor = 1,
+		/* At 20MHz, larger transfers halve the buffer rate. */
+		.transfer_samples = is_wideband_spectrum_mode ? 4096U : 2048U,
+		.transfers = is_wideband_spectrum_mode ? 2U : 4U,
 	});
 	receiver_model.set_baseband_bandwidth(is_wideband_spectrum_mode ? 12000000 : 1750000);
 	receiver_model.enable();
@@ -86,10 +86,15 @@ void shutdown() {
 	shared_memory.baseband_queue.push(shutdown_message);
 }
 
-void spectrum_streaming_start() {
+void spectrum_streaming_start(
+	const SpectrumStreamingConfigMessage::Window window,
+	const SpectrumStreamingConfigMessage::Trace trace
+) {
 	shared_memory.baseband_queue.push_and_wait(
 		SpectrumStreamingConfigMessage {
-			SpectrumStreamingConfigMessage::Mode::Running
+			SpectrumStreamingConfigMessage::Mode::Running,
+			window,
+			trace
 		}
 	);
 }
@@ -102,4 +107,34 @@ void spectrum_streaming_stop() {
 	);
 }
 
+void spectrum_sweep_start() {
+	shared_memory.baseband_queue.push_and_wait(
+		SpectrumStreamingConfigMessage {
+			SpectrumStreamingConfigMessage::Mode::Sweeping
+		}
+	);
+}
+
+bool spectrum_sweep_step(const uint32_t step, const uint32_t settle_samples) {
+	const SpectrumSweepStepMessage message { step, settle_samples };
+	return shared_memory.baseband_queue.push(message);
+}
+
+void capture_streaming_start(const size_t decimation_factor) {
+	shared_memory.baseband_queue.push_and_wait(
+		CaptureStreamingConfigMessage {
+			CaptureStreamingConfigMessage::Mode::Running,
+			decimation_factor
+		}
+	);
+}
+
+void capture_streaming_stop() {
+	shared_memory.baseband_queue.push_and_wait(
+		CaptureStreamingConfigMessage {
+			CaptureStreamingConfigMessage::Mode::Stopped
+		}
+	);
+}
+
 } /* namespace baseband */
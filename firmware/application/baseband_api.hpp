@@ -55,9 +55,20 @@ void stop();
 
 void shutdown();
 
-void spectrum_streaming_start();
+void spectrum_streaming_start(
+	const SpectrumStreamingConfigMessage::Window window = SpectrumStreamingConfigMessage::Window::Hann,
+	const SpectrumStreamingConfigMessage::Trace trace = SpectrumStreamingConfigMessage::Trace::Average
+);
 void spectrum_streaming_stop();
 
+/* WidebandSpectrum only. Stop with spectrum_streaming_stop(). */
+void spectrum_sweep_start();
+/* False if the queue to the M4 was full and the step didn't go out. */
+bool spectrum_sweep_step(const uint32_t step, const uint32_t settle_samples);
+
+void capture_streaming_start(const size_t decimation_factor);
+void capture_streaming_stop();
+
 } /* namespace baseband */
 
 #endif/*__BASEBAND_API_H__*/
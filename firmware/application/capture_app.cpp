@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "capture_app.hpp"
+
+#include "event_m0.hpp"
+
+#include "baseband_api.hpp"
+#include "radio.hpp"
+
+#include "portapack.hpp"
+using namespace portapack;
+
+#include "string_format.hpp"
+
+#include "ff.h"
+
+namespace ui {
+
+static std::string next_capture_stem() {
+	for(uint32_t n=0; n<10000; n++) {
+		const auto stem = "BBD_" + to_string_dec_uint(n, 4, '0');
+		FILINFO info;
+		if( f_stat((stem + ".TXT").c_str(), &info) == FR_NO_FILE ) {
+			return stem;
+		}
+	}
+	return { };
+}
+
+CaptureAppView::CaptureAppView(
+	NavigationView& nav
+) {
+	add_children({ {
+		&options_rate,
+		&field_frequency,
+		&field_lna,
+		&field_vga,
+		&rssi,
+		&channel,
+		&button_record,
+		&text_file,
+		&text_status,
+	} });
+
+	EventDispatcher::message_map().register_handler(Message::ID::CaptureFIFO,
+		[this](Message* const p) {
+			const auto message = static_cast<const CaptureFIFOMessage*>(p);
+			this->on_capture_fifo(message->fifo);
+		}
+	);
+	EventDispatcher::message_map().register_handler(Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
+		}
+	);
+
+	options_rate.set_by_value(decimation_factor_);
+	options_rate.on_change = [this](size_t, OptionsField::value_t v) {
+		this->decimation_factor_ = v;
+	};
+
+	target_frequency_ = receiver_model.tuning_frequency();
+	field_frequency.set_value(target_frequency_);
+	field_frequency.set_step(receiver_model.frequency_step());
+	field_frequency.on_change = [this](rf::Frequency f) {
+		this->set_target_frequency(f);
+	};
+	field_frequency.on_edit = [this, &nav]() {
+		auto new_view = nav.push<FrequencyKeypadView>(this->target_frequency_);
+		new_view->on_changed = [this](rf::Frequency f) {
+			this->set_target_frequency(f);
+			this->field_frequency.set_value(f);
+		};
+	};
+
+	field_lna.set_value(receiver_model.lna());
+	field_lna.on_change = [](int32_t v_db) {
+		radio::set_lna_gain(v_db);
+	};
+
+	field_vga.set_value(receiver_model.vga());
+	field_vga.on_change = [](int32_t v_db) {
+		radio::set_vga_gain(v_db);
+	};
+
+	button_record.on_select = [this](Button&) {
+		if( this->is_recording() ) {
+			this->stop();
+		} else {
+			this->start();
+		}
+	};
+
+	radio::enable({
+		target_frequency_ - (sampling_rate / 4),
+		sampling_rate,
+		baseband_bandwidth,
+		rf::Direction::Receive,
+		receiver_model.rf_amp(),
+		static_cast<int8_t>(receiver_model.lna()),
+		static_cast<int8_t>(receiver_model.vga()),
+		1,
+	});
+
+	baseband::start({
+		.mode = 7,
+		.sampling_rate = sampling_rate,
+		.decimation_factor = 1,
+		/* Throughput over latency: half the buffers, same ring storage. */
+		.transfer_samples = 4096,
+		.transfers = 2,
+	});
+}
+
+CaptureAppView::~CaptureAppView() {
+	stop();
+
+	baseband::stop();
+	radio::disable();
+
+	EventDispatcher::message_map().unregister_handler(Message::ID::DisplayFrameSync);
+	EventDispatcher::message_map().unregister_handler(Message::ID::CaptureFIFO);
+}
+
+void CaptureAppView::focus() {
+	button_record.focus();
+}
+
+bool CaptureAppView::is_recording() const {
+	return pending_file || capture_thread;
+}
+
+void CaptureAppView::start() {
+	const auto stem = next_capture_stem();
+	if( stem.empty() ) {
+		text_status.set("No free file name");
+		return;
+	}
+
+	const auto extension = (decimation_factor_ == 1) ? ".C8" : ".C16";
+	auto file = std::make_unique<File>();
+	if( !file->create(stem + extension) || !write_metadata(stem + ".TXT") ) {
+		text_status.set("Can't create file");
+		return;
+	}
+
+	pending_file = std::move(file);
+	text_file.set(stem + extension);
+	button_record.set_text("Stop");
+	/* The metadata says where the radio is tuned: keep it there. */
+	options_rate.set_focusable(false);
+	field_frequency.set_focusable(false);
+
+	/* The writer starts when the baseband answers with its FIFO. */
+	baseband::capture_streaming_start(decimation_factor_);
+}
+
+void CaptureAppView::stop() {
+	if( is_recording() ) {
+		baseband::capture_streaming_stop();
+		update_status();
+		capture_thread.reset();
+		pending_file.reset();
+		fifo = nullptr;
+
+		button_record.set_text("Start");
+		options_rate.set_focusable(true);
+		field_frequency.set_focusable(true);
+	}
+}
+
+void CaptureAppView::on_capture_fifo(BlockFIFO* const fifo) {
+	if( pending_file ) {
+		capture_thread = std::make_unique<CaptureThread>(std::move(pending_file), fifo);
+		this->fifo = fifo;
+	}
+}
+
+void CaptureAppView::on_frame_sync() {
+	/* Four status updates a second is plenty. */
+	if( ++frame_count >= 15 ) {
+		frame_count = 0;
+		if( capture_thread ) {
+			update_status();
+		}
+	}
+}
+
+void CaptureAppView::update_status() {
+	if( !capture_thread ) {
+		return;
+	}
+
+	if( capture_thread->write_error() ) {
+		text_status.set("Write error, card full?");
+		return;
+	}
+
+	const auto kib_written = capture_thread->bytes_written() / 1024;
+	std::string status = to_string_dec_uint(kib_written / 1024, 5) + "." + to_string_dec_uint((kib_written % 1024) * 10 / 1024) + "MB";
+	if( fifo && fifo->dropped() ) {
+		status += " drop " + to_string_dec_uint(fifo->dropped() / 1024) + "KB";
+	}
+	if( capture_thread->short_allocation() ) {
+		status += " card full?";
+	}
+	text_status.set(status);
+}
+
+rf::Frequency CaptureAppView::center_frequency() const {
+	/* The radio sits fs/4 below the target, and the decimator shifts the
+	 * target back down to DC. The raw baseband keeps the tuner's center.
+	 */
+	if( decimation_factor_ == 1 ) {
+		return target_frequency_ - (sampling_rate / 4);
+	} else {
+		return target_frequency_;
+	}
+}
+
+void CaptureAppView::set_target_frequency(const rf::Frequency f) {
+	target_frequency_ = f;
+	radio::set_tuning_frequency(target_frequency_ - (sampling_rate / 4));
+}
+
+bool CaptureAppView::write_metadata(const std::string& file_path) {
+	File file;
+	if( !file.create(file_path) ) {
+		return false;
+	}
+
+	const auto format = (decimation_factor_ == 1) ? "complex8" : "complex16";
+
+	return file.puts("sample_rate=" + to_string_dec_uint(sampling_rate / decimation_factor_) + "\r\n")
+		&& file.puts("center_frequency=" + to_string_dec_uint64(center_frequency()) + "\r\n")
+		&& file.puts(std::string("format=") + format + "\r\n");
+}
+
+} /* namespace ui */
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CAPTURE_APP_H__
+#define __CAPTURE_APP_H__
+
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_rssi.hpp"
+#include "ui_channel.hpp"
+
+#include "capture_thread.hpp"
+#include "file.hpp"
+
+#include "max2837.hpp"
+
+#include <string>
+#include <memory>
+
+namespace ui {
+
+/* Streams baseband IQ to the SD card, for replaying real-world signals later.
+ *
+ * BBD_nnnn.C8 is the raw complex<int8_t> baseband, BBD_nnnn.C16 the
+ * complex<int16_t> ChannelDecimator output, both interleaved I/Q. Sampling
+ * rate and center frequency go alongside, in BBD_nnnn.TXT.
+ */
+
+class CaptureAppView : public View {
+public:
+	CaptureAppView(NavigationView& nav);
+	~CaptureAppView();
+
+	void focus() override;
+
+	std::string title() const override { return "Capture"; };
+
+private:
+	static constexpr uint32_t sampling_rate = 3072000;
+	static constexpr uint32_t baseband_bandwidth = 1750000;
+
+	rf::Frequency target_frequency_ { 0 };
+	size_t decimation_factor_ { 4 };
+
+	std::unique_ptr<File> pending_file;
+	std::unique_ptr<CaptureThread> capture_thread;
+	BlockFIFO* fifo { nullptr };
+	size_t frame_count { 0 };
+
+	OptionsField options_rate {
+		{ 0 * 8, 0 * 16 },
+		4,
+		{
+			{ "3M07", 1 },
+			{ "768k", 4 },
+			{ "384k", 8 },
+			{ "192k", 16 },
+			{ " 96k", 32 },
+		}
+	};
+
+	FrequencyField field_frequency {
+		{ 5 * 8, 0 * 16 },
+	};
+
+	LNAGainField field_lna {
+		{ 15 * 8, 0 * 16 }
+	};
+
+	NumberField field_vga {
+		{ 18 * 8, 0 * 16},
+		2,
+		{ max2837::vga::gain_db_range.minimum, max2837::vga::gain_db_range.maximum },
+		max2837::vga::gain_db_step,
+		' ',
+	};
+
+	RSSI rssi {
+		{ 21 * 8, 0, 6 * 8, 4 },
+	};
+
+	Channel channel {
+		{ 21 * 8, 5, 6 * 8, 4 },
+	};
+
+	Button button_record {
+		{ 0 * 8, 2 * 16, 8 * 8, 2 * 16 },
+		"Start"
+	};
+
+	Text text_file {
+		{ 0 * 8, 5 * 16, 30 * 8, 1 * 16 },
+	};
+
+	Text text_status {
+		{ 0 * 8, 6 * 16, 30 * 8, 1 * 16 },
+	};
+
+	bool is_recording() const;
+
+	void start();
+	void stop();
+
+	void on_capture_fifo(BlockFIFO* const fifo);
+	void on_frame_sync();
+	void update_status();
+
+	rf::Frequency center_frequency() const;
+	void set_target_frequency(const rf::Frequency f);
+
+	bool write_metadata(const std::string& file_path);
+};
+
+} /* namespace ui */
+
+#endif/*__CAPTURE_APP_H__*/
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "capture_thread.hpp"
+
+CaptureThread::CaptureThread(
+	std::unique_ptr<File> file,
+	BlockFIFO* const fifo
+) : file { std::move(file) },
+	fifo { fifo }
+{
+	thread = chThdCreateFromHeap(NULL, THD_WA_SIZE(1024),
+		NORMALPRIO + 10, CaptureThread::static_fn,
+		this
+	);
+}
+
+CaptureThread::~CaptureThread() {
+	if( thread ) {
+		chThdTerminate(thread);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+
+	file->truncate();
+	file->close();
+}
+
+msg_t CaptureThread::static_fn(void* arg) {
+	auto obj = static_cast<CaptureThread*>(arg);
+	obj->run();
+	return 0;
+}
+
+void CaptureThread::run() {
+	while( !chThdShouldTerminate() ) {
+		allocate_ahead();
+		if( !write_ready_blocks() ) {
+			return;
+		}
+		chThdSleepMilliseconds(2);
+	}
+
+	/* The baseband has stopped streaming by now. Save the complete blocks
+	 * still in the ring; a partly filled last block is lost.
+	 */
+	write_ready_blocks();
+}
+
+void CaptureThread::allocate_ahead() {
+	if( short_allocation_ ) {
+		return;
+	}
+
+	/* Allocating a chunk holds up writing for a while; the ring absorbs that
+	 * as long as it happens well before the allocated space runs out.
+	 */
+	if( (allocated_bytes - bytes_written_) < (allocate_chunk_bytes / 2) ) {
+		if( file->preallocate(allocate_chunk_bytes) ) {
+			allocated_bytes = bytes_written_ + allocate_chunk_bytes;
+		} else {
+			short_allocation_ = true;
+		}
+	}
+}
+
+bool CaptureThread::write_ready_blocks() {
+	while( const auto block = fifo->peek_block() ) {
+		if( !file->write(block, fifo->block_size()) ) {
+			write_error_ = true;
+			return false;
+		}
+		fifo->release_block();
+		bytes_written_ += fifo->block_size();
+	}
+	return true;
+}
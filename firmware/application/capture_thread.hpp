@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CAPTURE_THREAD_H__
+#define __CAPTURE_THREAD_H__
+
+#include "file.hpp"
+#include "block_fifo.hpp"
+
+#include <ch.h>
+
+#include <cstdint>
+#include <memory>
+
+/* Drains a baseband capture stream into a file. Runs in its own thread, above
+ * the UI, so painting doesn't hold up the card and the card doesn't hold up
+ * painting. Blocks go to the card straight out of the M4's ring, one
+ * multi-sector write apiece.
+ *
+ * The file is grown ahead of the writes a chunk at a time, from this thread,
+ * so each write lands on clusters that are already allocated. The unused
+ * tail is truncated when the thread is destroyed.
+ */
+
+class CaptureThread {
+public:
+	CaptureThread(
+		std::unique_ptr<File> file,
+		BlockFIFO* const fifo
+	);
+	~CaptureThread();
+
+	CaptureThread(const CaptureThread&) = delete;
+	CaptureThread& operator=(const CaptureThread&) = delete;
+
+	uint32_t bytes_written() const {
+		return bytes_written_;
+	}
+
+	/* Stays set once a write fails; nothing more goes to the file. */
+	bool write_error() const {
+		return write_error_;
+	}
+
+	/* Stays set once the file couldn't be grown ahead of the writes. Writing
+	 * carries on into whatever space is left, so the card is nearly full.
+	 */
+	bool short_allocation() const {
+		return short_allocation_;
+	}
+
+private:
+	/* Grow the file by this much whenever less than half of it is left. */
+	static constexpr uint32_t allocate_chunk_bytes = 4 * 1024 * 1024;
+
+	std::unique_ptr<File> file;
+	BlockFIFO* const fifo;
+	Thread* thread { nullptr };
+
+	volatile uint32_t bytes_written_ { 0 };
+	volatile bool write_error_ { false };
+	volatile bool short_allocation_ { false };
+	uint32_t allocated_bytes { 0 };
+
+	static msg_t static_fn(void* arg);
+
+	void run();
+	void allocate_ahead();
+	bool write_ready_blocks();
+};
+
+#endif/*__CAPTURE_THREAD_H__*/
@@ -177,7 +177,7 @@ void ERTAppView::on_packet(const ert::Packet& packet) {
 
 	if( packet.crc_ok() ) {
 		recent.on_packet(packet.id(), packet);
-		recent_entries_view.set_dirty();
+		recent_entries_view.on_entry_updated(packet.id());
 	}
 }
 
@@ -37,6 +37,7 @@
 using namespace lpc43xx;
 
 #include <array>
+#include <algorithm>
 
 extern "C" {
 
@@ -144,6 +145,10 @@ void EventDispatcher::handle_rtc_tick() {
 	sd_card::poll_inserted();
 
 	portapack::temperature_logger.second_tick();
+
+	PaintStatisticsMessage message { paint_statistics };
+	message_map().send(&message);
+	paint_statistics = { };
 }
 
 ui::Widget* EventDispatcher::touch_widget(ui::Widget* const w, ui::TouchEvent event) {
@@ -189,9 +194,16 @@ void EventDispatcher::on_touch_event(ui::TouchEvent event) {
 }
 
 void EventDispatcher::handle_lcd_frame_sync() {
+	const auto pixels_start = portapack::display.pixels_written();
+
 	DisplayFrameSyncMessage message;
 	message_map().send(&message);
 	painter.paint_widget_tree(top_widget);
+
+	const uint32_t pixels = portapack::display.pixels_written() - pixels_start;
+	paint_statistics.frames += 1;
+	paint_statistics.pixels += pixels;
+	paint_statistics.pixels_max = std::max(paint_statistics.pixels_max, pixels);
 }
 
 void EventDispatcher::handle_switches() {
@@ -246,8 +258,10 @@ void EventDispatcher::event_bubble_encoder(const ui::EncoderEvent event) {
 }
 
 void EventDispatcher::init_message_queues() {
+	/* Only the UI thread talks to the baseband. */
 	new (&shared_memory.baseband_queue) MessageQueue(
-		shared_memory.baseband_queue_data, SharedMemory::baseband_queue_k
+		shared_memory.baseband_queue_data, SharedMemory::baseband_queue_k,
+		MessageQueue::Producers::Single
 	);
 	new (&shared_memory.application_queue) MessageQueue(
 		shared_memory.application_queue_data, SharedMemory::application_queue_k
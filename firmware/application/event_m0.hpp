@@ -85,6 +85,7 @@ private:
 	bool is_running = true;
 	bool sd_card_present = false;
 	bool display_sleep = false;
+	PaintStatistics paint_statistics;
 
 	eventmask_t wait();
 	void dispatch(const eventmask_t events);
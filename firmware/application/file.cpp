@@ -43,6 +43,11 @@ bool File::open_for_append(const std::string& file_path) {
 	return false;
 }
 
+bool File::create(const std::string& file_path) {
+	const auto open_result = f_open(&f, file_path.c_str(), FA_WRITE | FA_CREATE_ALWAYS);
+	return (open_result == FR_OK);
+}
+
 bool File::close() {
 	f_close(&f);
 	return true;
@@ -69,6 +74,27 @@ bool File::puts(const std::string& string) {
 	return (result >= 0);
 }
 
+bool File::seek(const uint32_t offset) {
+	const auto result = f_lseek(&f, offset);
+	return (result == FR_OK) && (f_tell(&f) == offset);
+}
+
+bool File::truncate() {
+	const auto result = f_truncate(&f);
+	return (result == FR_OK);
+}
+
+uint32_t File::size() {
+	return f_size(&f);
+}
+
+bool File::preallocate(const uint32_t bytes) {
+	/* Seeking past the end of a file open for writing extends it. */
+	const auto position = f_tell(&f);
+	const bool expanded = seek(position + bytes);
+	return seek(position) && expanded;
+}
+
 bool File::sync() {
 	const auto result = f_sync(&f);
 	return (result == FR_OK);
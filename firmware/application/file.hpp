@@ -24,6 +24,7 @@
 
 #include "ff.h"
 
+#include <cstdint>
 #include <cstddef>
 #include <string>
 #include <array>
@@ -34,6 +35,7 @@ public:
 
 	bool open(const std::string& file_path);
 	bool open_for_append(const std::string& file_path);
+	bool create(const std::string& file_path);
 	bool close();
 
 	bool is_ready();
@@ -48,6 +50,17 @@ public:
 
 	bool puts(const std::string& string);
 
+	bool seek(const uint32_t offset);
+	bool truncate();
+	uint32_t size();
+
+	/* Allocates clusters for "bytes" ahead of the write pointer, so later
+	 * writes don't have to extend the cluster chain (and on a freshly
+	 * formatted card, land in one contiguous run). truncate() after the
+	 * last write to give back what wasn't used.
+	 */
+	bool preallocate(const uint32_t bytes);
+
 	bool sync();
 
 private:
@@ -27,60 +27,180 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <list>
+#include <array>
+#include <limits>
+#include <new>
+#include <type_traits>
 #include <utility>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 
-template<class Packet, class Entry>
+/* Hash of an entry key, for the RecentEntries index. Keys that aren't
+ * integers or enums get an overload next to their type, found by ADL.
+ */
+template<typename T>
+constexpr typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint32_t>::type
+hash_key(const T value) {
+	return static_cast<uint32_t>(value);
+}
+
+template<typename T1, typename T2>
+uint32_t hash_key(const std::pair<T1, T2>& value) {
+	return (hash_key(value.first) * 31U) ^ hash_key(value.second);
+}
+
+/* The most recently heard of up to Capacity entries, most recent first.
+ *
+ * Entries live in a fixed pool of nodes, threaded onto an intrusive doubly
+ * linked list in recency order. An open-addressed hash table, at most half
+ * full, maps keys to nodes. Finding an entry, moving it to the front and
+ * evicting the oldest are all constant time, and nothing touches the heap
+ * after construction.
+ */
+template<class Packet, class Entry, size_t Capacity = 64>
 class RecentEntries {
+	static_assert(Capacity > 0, "RecentEntries needs room for at least one entry");
+
+	using Index = typename std::conditional<(Capacity < 0xffff), uint16_t, uint32_t>::type;
+	static constexpr Index none = std::numeric_limits<Index>::max();
+
 public:
 	using EntryType = Entry;
 	using Key = typename Entry::Key;
-	using ContainerType = std::list<Entry>;
-	using const_reference = typename ContainerType::const_reference;
-	using const_iterator = typename ContainerType::const_iterator;
+	using const_reference = const Entry&;
+
+	class const_iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Entry*;
+		using reference = const Entry&;
+
+		const_iterator(
+			const RecentEntries* const owner,
+			const Index node
+		) : owner { owner },
+			node { node }
+		{
+		}
+
+		reference operator*() const {
+			return owner->entry(node);
+		}
+
+		pointer operator->() const {
+			return &owner->entry(node);
+		}
+
+		const_iterator& operator++() {
+			node = owner->nodes[node].next;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const auto result = *this;
+			++*this;
+			return result;
+		}
+
+		/* Stepping back from end() lands on the oldest entry. */
+		const_iterator& operator--() {
+			node = (node == none) ? owner->tail : owner->nodes[node].prev;
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			const auto result = *this;
+			--*this;
+			return result;
+		}
+
+		bool operator==(const const_iterator& other) const {
+			return node == other.node;
+		}
+
+		bool operator!=(const const_iterator& other) const {
+			return node != other.node;
+		}
+
+	private:
+		const RecentEntries* owner;
+		Index node;
+	};
+
 	using RangeType = std::pair<const_iterator, const_iterator>;
-	
+
+	static constexpr size_t capacity = Capacity;
+
+	RecentEntries() {
+		clear();
+	}
+
+	~RecentEntries() {
+		release_all();
+	}
+
+	RecentEntries(const RecentEntries&) = delete;
+	RecentEntries& operator=(const RecentEntries&) = delete;
+
 	const Entry& on_packet(const Key key, const Packet& packet) {
-		auto matching_recent = find(key);
-		if( matching_recent != std::end(entries) ) {
-			// Found within. Move to front of list, increment counter.
-			entries.push_front(*matching_recent);
-			entries.erase(matching_recent);
+		auto n = lookup(key);
+		if( n != none ) {
+			unlink(n);
 		} else {
-			entries.emplace_front(key);
-			truncate_entries();
+			if( count == Capacity ) {
+				evict(tail);
+			}
+			n = free_head;
+			free_head = nodes[n].next;
+			new (&nodes[n].storage) Entry(key);
+			index_insert(key, n);
+			count++;
 		}
+		link_front(n);
 
-		auto& entry = entries.front();
+		auto& entry = this->entry(n);
 		entry.update(packet);
 
 		return entry;
 	}
 
 	const_reference front() const {
-		return entries.front();
+		return entry(head);
 	}
 
 	const_iterator find(const Key key) const {
-		return std::find_if(
-			std::begin(entries), std::end(entries),
-			[key](const Entry& e) { return e.key() == key; }
-		);
+		return { this, lookup(key) };
 	}
 
 	const_iterator begin() const {
-		return entries.begin();
+		return { this, head };
 	}
 
 	const_iterator end() const {
-		return entries.end();
+		return { this, none };
 	}
 
 	bool empty() const {
-		return entries.empty();
+		return count == 0;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	void clear() {
+		release_all();
+
+		for(size_t i=0; i<Capacity; i++) {
+			nodes[i].next = (i + 1 < Capacity) ? static_cast<Index>(i + 1) : none;
+		}
+		free_head = 0;
+		head = tail = none;
+		count = 0;
+		index.fill(none);
 	}
 
 	RangeType range_around(
@@ -91,13 +211,13 @@ public:
 		size_t i = 0;
 
 		// Move start iterator toward first entry.
-		while( (start != std::begin(entries)) && (i < count / 2) ) {
+		while( (start != begin()) && (i < count / 2) ) {
 			std::advance(start, -1);
 			i++;
 		}
 
 		// Move end iterator toward last entry.
-		while( (end != std::end(entries)) && (i < count) ) {
+		while( (end != this->end()) && (i < count) ) {
 			std::advance(end, 1);
 			i++;
 		}
@@ -106,22 +226,137 @@ public:
 	}
 
 private:
-	ContainerType entries;
-	const size_t entries_max = 64;
+	static constexpr size_t bits_for(const size_t n, const size_t bits = 0) {
+		return ((size_t(1) << bits) >= n) ? bits : bits_for(n, bits + 1);
+	}
 
-	void truncate_entries() {
-		while(entries.size() > entries_max) {
-			entries.pop_back();
+	/* At least twice as many slots as entries keeps probe runs short. */
+	static constexpr size_t index_bits = bits_for(Capacity * 2);
+	static constexpr size_t index_mask = (size_t(1) << index_bits) - 1;
+
+	struct Node {
+		typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage;
+		Index prev;
+		Index next;
+	};
+
+	std::array<Node, Capacity> nodes;
+	std::array<Index, size_t(1) << index_bits> index;
+	Index head { none };
+	Index tail { none };
+	Index free_head { none };
+	size_t count { 0 };
+
+	Entry& entry(const Index n) {
+		return *reinterpret_cast<Entry*>(&nodes[n].storage);
+	}
+
+	const Entry& entry(const Index n) const {
+		return *reinterpret_cast<const Entry*>(&nodes[n].storage);
+	}
+
+	static size_t home_slot(const Key& key) {
+		/* Fibonacci hashing spreads sequential IDs over the whole table. */
+		return (hash_key(key) * 2654435761U) >> (32 - index_bits);
+	}
+
+	Index lookup(const Key& key) const {
+		for(size_t slot=home_slot(key); index[slot] != none; slot=(slot + 1) & index_mask) {
+			if( entry(index[slot]).key() == key ) {
+				return index[slot];
+			}
 		}
+		return none;
+	}
+
+	void index_insert(const Key& key, const Index n) {
+		size_t slot = home_slot(key);
+		while( index[slot] != none ) {
+			slot = (slot + 1) & index_mask;
+		}
+		index[slot] = n;
+	}
+
+	/* Linear probing can't leave holes in a probe run, so later entries in
+	 * the run are shifted back into the gap, unless that would move one
+	 * ahead of its home slot.
+	 */
+	void index_remove(const Index n) {
+		size_t gap = home_slot(entry(n).key());
+		while( index[gap] != n ) {
+			gap = (gap + 1) & index_mask;
+		}
+
+		for(size_t slot=(gap + 1) & index_mask; index[slot] != none; slot=(slot + 1) & index_mask) {
+			const size_t home = home_slot(entry(index[slot]).key());
+			const bool stays = (gap < slot)
+				? ((gap < home) && (home <= slot))
+				: ((gap < home) || (home <= slot));
+			if( !stays ) {
+				index[gap] = index[slot];
+				gap = slot;
+			}
+		}
+		index[gap] = none;
+	}
+
+	void link_front(const Index n) {
+		nodes[n].prev = none;
+		nodes[n].next = head;
+		if( head != none ) {
+			nodes[head].prev = n;
+		} else {
+			tail = n;
+		}
+		head = n;
+	}
+
+	void unlink(const Index n) {
+		const auto prev = nodes[n].prev;
+		const auto next = nodes[n].next;
+		if( prev != none ) {
+			nodes[prev].next = next;
+		} else {
+			head = next;
+		}
+		if( next != none ) {
+			nodes[next].prev = prev;
+		} else {
+			tail = prev;
+		}
+	}
+
+	void evict(const Index n) {
+		index_remove(n);
+		unlink(n);
+		entry(n).~Entry();
+		nodes[n].next = free_head;
+		free_head = n;
+		count--;
+	}
+
+	void release_all() {
+		for(auto n=head; n!=none; n=nodes[n].next) {
+			entry(n).~Entry();
+		}
+		head = tail = none;
+		count = 0;
 	}
 };
 
+template<class Packet, class Entry, size_t Capacity>
+constexpr typename RecentEntries<Packet, Entry, Capacity>::Index RecentEntries<Packet, Entry, Capacity>::none;
+
+template<class Packet, class Entry, size_t Capacity>
+constexpr size_t RecentEntries<Packet, Entry, Capacity>::capacity;
+
 namespace ui {
 
 template<class Entries>
 class RecentEntriesView : public View {
 public:
 	using Entry = typename Entries::EntryType;
+	using EntryKey = typename Entry::Key;
 
 	std::function<void(const Entry& entry)> on_select;
 
@@ -137,7 +372,6 @@ public:
 		const auto& s = style();
 
 		Rect target_rect { r.pos, { r.width(), s.font.line_height() }};
-		const size_t visible_item_count = r.height() / s.font.line_height();
 
 		const Style style_header {
 			.font = font::fixed_8x16,
@@ -148,19 +382,20 @@ public:
 		draw_header(target_rect, painter, style_header);
 		target_rect.pos.y += target_rect.height();
 
-		auto selected = recent.find(selected_key);
-		if( selected == std::end(recent) ) {
-			selected = std::begin(recent);
-		}
-
-		auto range = recent.range_around(selected, visible_item_count);
+		const auto range = visible_range();
 
+		drawn_rows_count = 0;
 		for(auto p = range.first; p != range.second; p++) {
 			const auto& entry = *p;
-			const auto is_selected_key = (selected_key == entry.key());
-			draw(entry, target_rect, painter, s, (has_focus() && is_selected_key));
+			const auto highlighted = is_highlighted(entry);
+			draw(entry, target_rect, painter, s, highlighted);
 			target_rect.pos.y += target_rect.height();
+
+			if( drawn_rows_count < drawn_rows.size() ) {
+				drawn_rows[drawn_rows_count++] = { entry.key(), highlighted };
+			}
 		}
+		drawn = true;
 
 		painter.fill_rectangle(
 			{ target_rect.left(), target_rect.top(), target_rect.width(), r.bottom() - target_rect.top() },
@@ -190,12 +425,78 @@ public:
 		advance(0);
 	}
 
+	/* Call after recent.on_packet(). Repaints the row showing the updated
+	 * entry and any rows that moved, instead of the whole list.
+	 */
+	void on_entry_updated(const EntryKey key) {
+		invalidate_rows(key);
+	}
+
 private:
 	Entries& recent;
 	
-	using EntryKey = typename Entry::Key;
 	EntryKey selected_key = Entry::invalid_key;
 
+	/* What each row showed at the last paint. */
+	struct DrawnRow {
+		EntryKey key;
+		bool highlighted;
+	};
+
+	std::array<DrawnRow, 20> drawn_rows { };
+	size_t drawn_rows_count { 0 };
+	bool drawn { false };
+
+	typename Entries::RangeType visible_range() const {
+		auto selected = recent.find(selected_key);
+		if( selected == std::end(recent) ) {
+			selected = std::begin(recent);
+		}
+
+		const size_t visible_item_count = size().h / style().font.line_height();
+		return recent.range_around(selected, visible_item_count);
+	}
+
+	bool is_highlighted(const Entry& entry) {
+		return has_focus() && (selected_key == entry.key());
+	}
+
+	void invalidate_rows(const EntryKey updated_key) {
+		if( !drawn ) {
+			set_dirty();
+			return;
+		}
+
+		const auto line_height = style().font.line_height();
+		const auto row_rect = [this, line_height](const size_t row) {
+			return Rect { 0, static_cast<int>((row + 1) * line_height), size().w, line_height };
+		};
+
+		const auto range = visible_range();
+		size_t row = 0;
+		for(auto p = range.first; p != range.second; p++, row++) {
+			if( row >= drawn_rows.size() ) {
+				set_dirty();
+				return;
+			}
+
+			const auto& entry = *p;
+			const bool unchanged =
+				(row < drawn_rows_count)
+				&& (drawn_rows[row].key == entry.key())
+				&& (drawn_rows[row].highlighted == is_highlighted(entry))
+				&& !(entry.key() == updated_key);
+			if( !unchanged ) {
+				set_dirty(row_rect(row));
+			}
+		}
+
+		// Rows that no longer have an entry get cleared.
+		for(; row<drawn_rows_count; row++) {
+			set_dirty(row_rect(row));
+		}
+	}
+
 	void advance(const int32_t amount) {
 		auto selected = recent.find(selected_key);
 		if( selected == std::end(recent) ) {
@@ -219,7 +520,7 @@ private:
 			selected_key = selected->key();
 		}
 
-		set_dirty();
+		invalidate_rows(Entry::invalid_key);
 	}
 
 	void draw_header(
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "spectrum_sweep_app.hpp"
+
+#include "event_m0.hpp"
+
+#include "baseband_api.hpp"
+#include "spectrum_color_lut.hpp"
+
+#include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
+using namespace portapack;
+
+#include "string_format.hpp"
+
+#include <algorithm>
+
+namespace ui {
+
+SpectrumSweepView::SpectrumSweepView(
+	NavigationView&
+) {
+	add_children({ {
+		&field_start,
+		&text_to,
+		&field_stop,
+		&text_mhz,
+		&text_rate,
+		&waterfall,
+	} });
+
+	EventDispatcher::message_map().register_handler(Message::ID::ChannelSpectrumConfig,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
+			this->fifo = message.fifo;
+		}
+	);
+	EventDispatcher::message_map().register_handler(Message::ID::SpectrumSweepCaptured,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const SpectrumSweepCapturedMessage*>(p);
+			this->on_sweep_captured(message.step);
+		}
+	);
+	EventDispatcher::message_map().register_handler(Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
+		}
+	);
+
+	/* Sweeping moves the tuned frequency all over; put it back after. */
+	tuning_frequency_saved = receiver_model.tuning_frequency();
+
+	const auto start_mhz = std::max(static_cast<int32_t>(tuning_frequency_saved / 1000000) - 50, 1);
+	field_start.set_value(start_mhz);
+	field_stop.set_value(start_mhz + 100);
+	/* Pushing the other end along restarts the sweep from there. */
+	field_start.on_change = [this](int32_t v) {
+		if( this->field_stop.value() <= v ) {
+			this->field_stop.set_value(v + 10);
+		} else {
+			this->start_sweep();
+		}
+	};
+	field_stop.on_change = [this](int32_t v) {
+		if( this->field_start.value() >= v ) {
+			this->field_start.set_value(v - 10);
+		} else {
+			this->start_sweep();
+		}
+	};
+
+	receiver_model.set_baseband_configuration({
+		.mode = toUType(ReceiverModel::Mode::SpectrumAnalysis),
+		.sampling_rate = sampling_rate,
+		.decimation_factor = 1,
+		.transfer_samples = 4096,
+		.transfers = 2,
+	});
+	receiver_model.set_baseband_bandwidth(baseband_bandwidth);
+	receiver_model.enable();
+
+	start_sweep();
+}
+
+SpectrumSweepView::~SpectrumSweepView() {
+	baseband::spectrum_streaming_stop();
+	receiver_model.disable();
+
+	persistent_memory::set_tuned_frequency(tuning_frequency_saved);
+
+	EventDispatcher::message_map().unregister_handler(Message::ID::DisplayFrameSync);
+	EventDispatcher::message_map().unregister_handler(Message::ID::SpectrumSweepCaptured);
+	EventDispatcher::message_map().unregister_handler(Message::ID::ChannelSpectrumConfig);
+}
+
+void SpectrumSweepView::set_parent_rect(const Rect new_parent_rect) {
+	View::set_parent_rect(new_parent_rect);
+
+	constexpr Dim header_height = 1 * 16;
+	waterfall.set_parent_rect({
+		0, header_height,
+		new_parent_rect.width(),
+		static_cast<Dim>(new_parent_rect.height() - header_height)
+	});
+}
+
+void SpectrumSweepView::focus() {
+	field_start.focus();
+}
+
+/* The range is rounded up to whole steps. */
+void SpectrumSweepView::start_sweep() {
+	sweep_start = static_cast<rf::Frequency>(field_start.value()) * 1000000;
+	const rf::Frequency span = static_cast<rf::Frequency>(field_stop.value() - field_start.value()) * 1000000;
+	sweep_steps = std::max(static_cast<size_t>((span + step_width - 1) / step_width), size_t(1));
+
+	sweep_db.fill(0);
+	frame_db.fill(0);
+	frame_ready = false;
+
+	rate_time_start = chTimeNow();
+	rate_steps = 0;
+
+	/* Starts the M4 over too: whatever it had of the old range is gone. */
+	baseband::spectrum_sweep_start();
+
+	sweep_first_step = step_next;
+	retune(step_next);
+}
+
+void SpectrumSweepView::retune(const uint32_t step) {
+	const size_t index = (step - sweep_first_step) % sweep_steps;
+	const rf::Frequency center = sweep_start + index * step_width + step_width / 2;
+	receiver_model.set_tuning_frequency(center);
+
+	step_next = step + 1;
+	send_step();
+}
+
+void SpectrumSweepView::send_step() {
+	constexpr uint32_t settle_samples = static_cast<uint64_t>(sampling_rate) * settle_time_us / 1000000;
+	step_sent = baseband::spectrum_sweep_step(step_next - 1, settle_samples);
+	step_frames = 0;
+}
+
+void SpectrumSweepView::on_sweep_captured(const uint32_t step) {
+	/* Anything else is from before the range changed. */
+	if( step != (step_next - 1) ) {
+		return;
+	}
+
+	retune(step_next);
+	rate_steps++;
+
+	/* Pick up the spectrum of the step before while it's at hand, rather
+	 * than letting the FIFO fill up and hold back the sweep.
+	 */
+	drain_fifo();
+}
+
+void SpectrumSweepView::drain_fifo() {
+	if( fifo ) {
+		ChannelSpectrum spectrum;
+		while( fifo->out(spectrum) ) {
+			on_channel_spectrum(spectrum);
+		}
+	}
+}
+
+void SpectrumSweepView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
+	if( (spectrum.sweep_step - sweep_first_step) >= (step_next - sweep_first_step) ) {
+		return;
+	}
+	if( spectrum.sampling_rate == 0 ) {
+		return;
+	}
+
+	const size_t index = (spectrum.sweep_step - sweep_first_step) % sweep_steps;
+	const int64_t span = sweep_steps * step_width;
+	const int32_t bin_count = spectrum.bin_count;
+	const int32_t bins_kept_half = step_width * bin_count / (2 * static_cast<int64_t>(spectrum.sampling_rate));
+
+	/* Bin 0 is the LO leakage at DC: stand in its neighbours. */
+	const uint8_t db_dc = (spectrum.db[1] + spectrum.db[bin_count - 1]) / 2;
+
+	for(int32_t b=-bins_kept_half; b<bins_kept_half; b++) {
+		const int64_t f = index * step_width + step_width / 2 + b * static_cast<int64_t>(spectrum.sampling_rate) / bin_count;
+		const size_t x = f * pixels / span;
+		if( x < pixels ) {
+			const uint8_t db = (b == 0) ? db_dc : spectrum.db[b & (bin_count - 1)];
+			sweep_db[x] = std::max(sweep_db[x], db);
+		}
+	}
+
+	if( index == (sweep_steps - 1) ) {
+		for(size_t x=0; x<pixels; x++) {
+			frame_db[x] = std::max(frame_db[x], sweep_db[x]);
+		}
+		sweep_db.fill(0);
+		frame_ready = true;
+	}
+}
+
+void SpectrumSweepView::on_frame_sync() {
+	/* A step that didn't make it into the queue, or whose capture was never
+	 * reported, would hold up the sweep for good. Send it (again); a second
+	 * report of the same step is ignored.
+	 */
+	if( !step_sent || (++step_frames >= step_timeout_frames) ) {
+		send_step();
+	}
+
+	drain_fifo();
+
+	if( frame_ready ) {
+		std::array<Color, pixels> pixel_row;
+		for(size_t x=0; x<pixels; x++) {
+			pixel_row[x] = spectrum_rgb3_lut[frame_db[x]];
+		}
+		waterfall.on_pixel_row(pixel_row);
+
+		frame_db.fill(0);
+		frame_ready = false;
+	}
+
+	update_rate();
+}
+
+/* Once a second: megahertz of spectrum captured per second. */
+void SpectrumSweepView::update_rate() {
+	const auto now = chTimeNow();
+	const auto elapsed = now - rate_time_start;
+	if( elapsed >= S2ST(1) ) {
+		const uint64_t swept_hz = static_cast<uint64_t>(rate_steps) * step_width;
+		const uint32_t mhz_per_second = swept_hz * CH_FREQUENCY / elapsed / 1000000;
+		text_rate.set(to_string_dec_uint(mhz_per_second, 6) + " MHz/s");
+
+		rate_time_start = now;
+		rate_steps = 0;
+	}
+}
+
+} /* namespace ui */
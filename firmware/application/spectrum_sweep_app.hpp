@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SPECTRUM_SWEEP_APP_H__
+#define __SPECTRUM_SWEEP_APP_H__
+
+#include "ui_widget.hpp"
+#include "ui_navigation.hpp"
+#include "ui_spectrum.hpp"
+
+#include "receiver_model.hpp"
+#include "message.hpp"
+
+#include <ch.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+
+namespace ui {
+
+/* Spectrum across a range wider than the baseband, one waterfall row per
+ * sweep (or per display frame, whichever is slower).
+ *
+ * The radio steps across the range step_width at a time. At each step the
+ * M4 throws away the samples from while the synthesizers settled, captures
+ * a few buffers and says so; the next retune goes out right away, and the
+ * M4 works out the spectrum of the step just captured while the radio
+ * settles on the next one. The middle step_width of each step's spectrum
+ * is stitched into the panorama.
+ */
+
+class SpectrumSweepView : public View {
+public:
+	SpectrumSweepView(NavigationView& nav);
+	~SpectrumSweepView();
+
+	void set_parent_rect(const Rect new_parent_rect) override;
+
+	void focus() override;
+
+	std::string title() const override { return "Sweep"; };
+
+private:
+	static constexpr uint32_t sampling_rate = 20000000;
+	static constexpr uint32_t baseband_bandwidth = 12000000;
+
+	/* The part of each step kept for the panorama: well inside the baseband
+	 * filter's passband.
+	 */
+	static constexpr rf::Frequency step_width = 10000000;
+
+	/* Covers the first and second LO PLLs locking, with margin. */
+	static constexpr uint32_t settle_time_us = 250;
+
+	static constexpr size_t pixels = 240;
+
+	/* A step takes a millisecond or two. Give up on hearing back after this
+	 * many display frames.
+	 */
+	static constexpr uint32_t step_timeout_frames = 10;
+
+	rf::Frequency tuning_frequency_saved { 0 };
+
+	rf::Frequency sweep_start { 0 };
+	size_t sweep_steps { 1 };
+
+	/* Steps are numbered from when the view opened, never reused, so a
+	 * message about a step from before the range changed is recognised as
+	 * such. sweep_first_step is the step the current range started on.
+	 */
+	uint32_t step_next { 0 };
+	uint32_t sweep_first_step { 0 };
+
+	/* Whether the step in progress (step_next - 1) went out to the M4, and
+	 * display frames since it did.
+	 */
+	bool step_sent { false };
+	uint32_t step_frames { 0 };
+
+	ChannelSpectrumFIFO* fifo { nullptr };
+
+	/* The sweep in progress, and the peak of every sweep completed since
+	 * the last row was drawn.
+	 */
+	std::array<uint8_t, pixels> sweep_db;
+	std::array<uint8_t, pixels> frame_db;
+	bool frame_ready { false };
+
+	systime_t rate_time_start { 0 };
+	uint32_t rate_steps { 0 };
+
+	NumberField field_start {
+		{ 0 * 8, 0 * 16 },
+		4,
+		{ 1, 7200 },
+		10,
+		' ',
+	};
+
+	Text text_to {
+		{ 4 * 8, 0 * 16, 1 * 8, 1 * 16 },
+		"-",
+	};
+
+	NumberField field_stop {
+		{ 5 * 8, 0 * 16 },
+		4,
+		{ 11, 7210 },
+		10,
+		' ',
+	};
+
+	Text text_mhz {
+		{ 9 * 8, 0 * 16, 3 * 8, 1 * 16 },
+		"MHz",
+	};
+
+	Text text_rate {
+		{ 13 * 8, 0 * 16, 17 * 8, 1 * 16 },
+	};
+
+	spectrum::WaterfallView waterfall;
+
+	void start_sweep();
+	void retune(const uint32_t step);
+	void send_step();
+
+	void on_sweep_captured(const uint32_t step);
+	void on_channel_spectrum(const ChannelSpectrum& spectrum);
+	void on_frame_sync();
+
+	void drain_fifo();
+	void update_rate();
+};
+
+} /* namespace ui */
+
+#endif/*__SPECTRUM_SWEEP_APP_H__*/
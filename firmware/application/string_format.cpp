@@ -72,6 +72,19 @@ std::string to_string_dec_uint(
 	return q;
 }
 
+std::string to_string_dec_uint64(
+	const uint64_t n
+) {
+	/* Nine digits at a time: only the split needs a 64-bit divide. */
+	constexpr uint32_t base = 1000000000;
+	const uint64_t high = n / base;
+	const uint32_t low = n % base;
+	if( high == 0 ) {
+		return to_string_dec_uint(low);
+	}
+	return to_string_dec_uint64(high) + to_string_dec_uint(low, 9, '0');
+}
+
 std::string to_string_dec_int(
 	const int32_t n,
 	const int32_t l,
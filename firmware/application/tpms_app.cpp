@@ -105,8 +105,8 @@ size_t Packet::crc_valid_length() const {
 	}
 
 	uint32_t checksum = 0;
-	CRC<8> crc_72 { 0x01, 0x00 };
-	CRC<8> crc_80 { 0x01, 0x00 };
+	TableCRC<8, 0x01> crc_72 { 0x00 };
+	TableCRC<8, 0x01> crc_80 { 0x00 };
 
 	for(size_t i=0; i<bytes.size(); i++) {
 		const uint32_t byte_mask = 1 << i;
@@ -285,8 +285,8 @@ void TPMSAppView::on_packet(const tpms::Packet& packet) {
 	const auto reading_opt = packet.reading();
 	if( reading_opt.is_valid() ) {
 		const auto reading = reading_opt.value();
-		recent.on_packet({ reading.type(), reading.id() }, reading);
-		recent_entries_view.set_dirty();
+		const auto& updated_entry = recent.on_packet({ reading.type(), reading.id() }, reading);
+		recent_entries_view.on_entry_updated(updated_entry.key());
 	}
 }
 
@@ -61,6 +61,10 @@ private:
 	uint32_t id_;
 };
 
+inline uint32_t hash_key(const TransponderID& id) {
+	return id.value();
+}
+
 class Reading {
 public:
 	enum Type {
@@ -38,6 +38,9 @@ namespace ui {
 BasebandStatsView::BasebandStatsView() {
 	add_children({ {
 		&text_stats,
+		&text_queue,
+		&text_switch,
+		&text_dma,
 	} });
 }
 
@@ -72,6 +75,66 @@ void BasebandStatsView::on_statistics_update(const BasebandStatistics& statistic
 		+ " " + ticks_to_percent_string(statistics.baseband_ticks);
 
 	text_stats.set(message);
+
+	/* M4->M0 queue: deepest it has been (bytes), and messages dropped. */
+	text_queue.set(
+		"Q " + to_string_dec_uint(statistics.application_queue_depth_max, 4)
+		+ " drop " + to_string_dec_uint(statistics.application_queue_dropped)
+	);
+
+	/* Last mode switch, DMA stop to DMA restart. */
+	text_switch.set(
+		"Switch " + to_string_dec_uint(statistics.mode_switch_cycles / (base_m4_clk_f / 1000000)) + "us"
+	);
+
+	/* Receive deadline: transfers skipped, buffers overwritten while still
+	 * in use, and the least/average time to spare per buffer.
+	 */
+	text_dma.set(
+		"Skip " + to_string_dec_uint(statistics.dma_skipped)
+		+ " ovr " + to_string_dec_uint(statistics.dma_overwritten)
+		+ " slk " + to_string_dec_int(statistics.dma_slack_min_cycles / static_cast<int32_t>(base_m4_clk_f / 1000000))
+		+ "/" + to_string_dec_int(statistics.dma_slack_avg_cycles / static_cast<int32_t>(base_m4_clk_f / 1000000)) + "us"
+	);
+}
+
+/* BasebandStageStatsView ************************************************/
+
+BasebandStageStatsView::BasebandStageStatsView() {
+	add_child(&text_header);
+	for(size_t i=0; i<text_stages.size(); i++) {
+		text_stages[i].set_parent_rect({ 0 * 8, static_cast<Coord>((i + 1) * 16), 30 * 8, 1 * 16 });
+		add_child(&text_stages[i]);
+	}
+}
+
+void BasebandStageStatsView::on_show() {
+	EventDispatcher::message_map().register_handler(Message::ID::StageStatistics,
+		[this](const Message* const p) {
+			this->on_statistics_update(static_cast<const StageStatisticsMessage*>(p)->statistics);
+		}
+	);
+}
+
+void BasebandStageStatsView::on_hide() {
+	EventDispatcher::message_map().unregister_handler(Message::ID::StageStatistics);
+}
+
+static std::string cycles_to_us_string(const uint32_t cycles) {
+	return to_string_dec_uint(cycles / (base_m4_clk_f / 1000000), 8);
+}
+
+void BasebandStageStatsView::on_statistics_update(const StageStatistics& statistics) {
+	for(size_t i=0; i<text_stages.size(); i++) {
+		if( i < statistics.stage_count ) {
+			const auto& stage = statistics.stages[i];
+			std::string name { stage.name };
+			name.resize(11, ' ');
+			text_stages[i].set(name + cycles_to_us_string(stage.avg) + " " + cycles_to_us_string(stage.max));
+		} else {
+			text_stages[i].set("");
+		}
+	}
 }
 
 } /* namespace ui */
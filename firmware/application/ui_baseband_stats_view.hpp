@@ -25,6 +25,8 @@
 #include "ui_widget.hpp"
 #include "message.hpp"
 
+#include <array>
+
 namespace ui {
 
 class BasebandStatsView : public View {
@@ -40,9 +42,45 @@ private:
 		"",
 	};
 
+	Text text_queue {
+		{  0 * 8, 1 * 16, (4 * 4 + 3) * 8, 1 * 16 },
+		"",
+	};
+
+	Text text_switch {
+		{  0 * 8, 2 * 16, (4 * 4 + 3) * 8, 1 * 16 },
+		"",
+	};
+
+	Text text_dma {
+		{  0 * 8, 3 * 16, 30 * 8, 1 * 16 },
+		"",
+	};
+
 	void on_statistics_update(const BasebandStatistics& statistics);
 };
 
+/* Per-stage breakdown of the running processor, from StageStatistics:
+ * average and worst-case time per buffer for each stage, in microseconds.
+ */
+class BasebandStageStatsView : public View {
+public:
+	BasebandStageStatsView();
+
+	void on_show() override;
+	void on_hide() override;
+
+private:
+	Text text_header {
+		{  0 * 8, 0, 30 * 8, 1 * 16 },
+		"Stage        avg us   max us",
+	};
+
+	std::array<Text, StageStatistics::stages_max> text_stages;
+
+	void on_statistics_update(const StageStatistics& statistics);
+};
+
 } /* namespace ui */
 
 #endif/*__UI_BASEBAND_STATS_VIEW_H__*/
@@ -23,6 +23,8 @@
 
 #include "ch.h"
 
+#include "event_m0.hpp"
+
 #include "radio.hpp"
 #include "string_format.hpp"
 
@@ -146,6 +148,53 @@ void TemperatureView::focus() {
 	button_done.focus();
 }
 
+/* PaintStatsView ********************************************************/
+
+PaintStatsView::PaintStatsView(
+	const Rect parent_rect
+) : View { parent_rect }
+{
+	add_children({ {
+		&text_stats,
+	} });
+}
+
+void PaintStatsView::on_show() {
+	EventDispatcher::message_map().register_handler(Message::ID::PaintStatistics,
+		[this](const Message* const p) {
+			this->on_statistics_update(static_cast<const PaintStatisticsMessage*>(p)->statistics);
+		}
+	);
+}
+
+void PaintStatsView::on_hide() {
+	EventDispatcher::message_map().unregister_handler(Message::ID::PaintStatistics);
+}
+
+void PaintStatsView::on_statistics_update(const PaintStatistics& statistics) {
+	const auto pixels_avg = statistics.frames ? (statistics.pixels / statistics.frames) : 0;
+	text_stats.set(
+		"Px/frame " + to_string_dec_uint(pixels_avg, 5)
+		+ " max " + to_string_dec_uint(statistics.pixels_max, 5)
+	);
+}
+
+/* DebugPaintView *******************************************************/
+
+DebugPaintView::DebugPaintView(NavigationView& nav) {
+	add_children({ {
+		&text_title,
+		&paint_stats_view,
+		&button_done,
+	} });
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+}
+
+void DebugPaintView::focus() {
+	button_done.focus();
+}
+
 /* RegistersWidget *******************************************************/
 
 RegistersWidget::RegistersWidget(
@@ -269,12 +318,13 @@ DebugPeripheralsMenuView::DebugPeripheralsMenuView(NavigationView& nav) {
 /* DebugMenuView *********************************************************/
 
 DebugMenuView::DebugMenuView(NavigationView& nav) {
-	add_items<5>({ {
+	add_items<6>({ {
 		{ "Memory",      [&nav](){ nav.push<DebugMemoryView>(); } },
 		{ "Radio State", [&nav](){ nav.push<NotImplementedView>(); } },
 		{ "SD Card",     [&nav](){ nav.push<NotImplementedView>(); } },
 		{ "Peripherals", [&nav](){ nav.push<DebugPeripheralsMenuView>(); } },
 		{ "Temperature", [&nav](){ nav.push<TemperatureView>(); } },
+		{ "Paint",       [&nav](){ nav.push<DebugPaintView>(); } },
 	} });
 	on_left = [&nav](){ nav.pop(); };
 }
@@ -31,6 +31,7 @@
 #include "rffc507x.hpp"
 #include "max2837.hpp"
 #include "portapack.hpp"
+#include "message.hpp"
 
 #include <functional>
 #include <utility>
@@ -129,6 +130,48 @@ private:
 	};
 };
 
+/* Drop-in status line for measuring paint cost: average and worst-case
+ * pixels written per display frame, over the last second.
+ */
+class PaintStatsView : public View {
+public:
+	explicit PaintStatsView(const Rect parent_rect);
+
+	void on_show() override;
+	void on_hide() override;
+
+private:
+	Text text_stats {
+		{ 0 * 8, 0, 30 * 8, 1 * 16 },
+		"",
+	};
+
+	void on_statistics_update(const PaintStatistics& statistics);
+};
+
+/* Paint cost of a screen that isn't changing: should be next to nothing. */
+class DebugPaintView : public View {
+public:
+	explicit DebugPaintView(NavigationView& nav);
+
+	void focus() override;
+
+private:
+	Text text_title {
+		{ 56, 16, 128, 16 },
+		"Paint Statistics",
+	};
+
+	PaintStatsView paint_stats_view {
+		{ 0, 40, 240, 16 },
+	};
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+};
+
 struct RegistersWidgetConfig {
 	int registers_count;
 	int legend_length;
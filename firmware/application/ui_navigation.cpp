@@ -31,6 +31,8 @@
 #include "ais_app.hpp"
 #include "ert_app.hpp"
 #include "tpms_app.hpp"
+#include "capture_app.hpp"
+#include "spectrum_sweep_app.hpp"
 
 #include "core_control.hpp"
 
@@ -79,12 +81,13 @@ void SystemStatusView::set_title(const std::string new_value) {
 }
 
 void SystemStatusView::on_camera() {
-	PNGWriter png { "capture.png" };
+	// Compressor state is several KiB, too much for the stack.
+	auto png = std::make_unique<PNGWriter>("capture.png");
 
 	for(int i=0; i<320; i++) {
 		std::array<ColorRGB888, 240> row;
 		portapack::display.read_pixels({ 0, i, 240, 1 }, row);
-		png.write_scanline(row);
+		png->write_scanline(row);
 	}
 }
 
@@ -156,8 +159,9 @@ TranspondersMenuView::TranspondersMenuView(NavigationView& nav) {
 /* ReceiverMenuView ******************************************************/
 
 ReceiverMenuView::ReceiverMenuView(NavigationView& nav) {
-	add_items<2>({ {
+	add_items<3>({ {
 		{ "Audio",        [&nav](){ nav.push<AnalogAudioView>(); } },
+		{ "Sweep",        [&nav](){ nav.push<SpectrumSweepView>(); } },
 		{ "Transponders", [&nav](){ nav.push<TranspondersMenuView>(); } },
 	} });
 	on_left = [&nav](){ nav.pop(); };
@@ -168,7 +172,7 @@ ReceiverMenuView::ReceiverMenuView(NavigationView& nav) {
 SystemMenuView::SystemMenuView(NavigationView& nav) {
 	add_items<7>({ {
 		{ "Receiver", [&nav](){ nav.push<ReceiverMenuView>(); } },
-		{ "Capture",  [&nav](){ nav.push<NotImplementedView>(); } },
+		{ "Capture",  [&nav](){ nav.push<CaptureAppView>(); } },
 		{ "Analyze",  [&nav](){ nav.push<NotImplementedView>(); } },
 		{ "Setup",    [&nav](){ nav.push<SetupMenuView>(); } },
 		{ "About",    [&nav](){ nav.push<AboutView>(); } },
@@ -34,6 +34,7 @@ using namespace portapack;
 
 #include <cmath>
 #include <array>
+#include <algorithm>
 
 namespace ui {
 namespace spectrum {
@@ -59,7 +60,8 @@ void FrequencyScale::set_channel_filter(
 		(channel_filter_stop_frequency != stop_frequency) ) {
 		channel_filter_pass_frequency = pass_frequency;
 		channel_filter_stop_frequency = stop_frequency;
-		set_dirty();
+		// Only the filter band along the bottom edge changes.
+		set_dirty({ 0, size().h - filter_band_height, size().w, filter_band_height });
 	}
 }
 
@@ -197,19 +199,30 @@ void WaterfallView::paint(Painter& painter) {
 void WaterfallView::on_channel_spectrum(
 	const ChannelSpectrum& spectrum
 ) {
-	/* TODO: static_assert that message.spectrum.db.size() >= pixel_row.size() */
+	/* Pixel 120 is DC. The full span is 256 pixels wide (see FrequencyScale),
+	 * so the outermost bins aren't shown. With more than 256 bins, each pixel
+	 * shows the peak of the bins it covers.
+	 */
+	const size_t bin_count = spectrum.bin_count;
+	const size_t bins_per_pixel = std::max(bin_count / 256, size_t(1));
 
 	std::array<Color, 240> pixel_row;
-	for(size_t i=0; i<120; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[256 - 120 + i]];
-		pixel_row[i] = pixel_color;
+	for(size_t i=0; i<pixel_row.size(); i++) {
+		const int bin_offset = (static_cast<int>(i) - 120) * static_cast<int>(bin_count) / 256;
+		const size_t bin_first = bin_offset & (bin_count - 1);
+		uint8_t db = 0;
+		for(size_t n=0; n<bins_per_pixel; n++) {
+			db = std::max(db, spectrum.db[bin_first + n]);
+		}
+		pixel_row[i] = spectrum_rgb3_lut[db];
 	}
 
-	for(size_t i=120; i<240; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[i - 120]];
-		pixel_row[i] = pixel_color;
-	}
+	on_pixel_row(pixel_row);
+}
 
+void WaterfallView::on_pixel_row(
+	const std::array<Color, 240>& pixel_row
+) {
 	const auto draw_y = display.scroll(1);
 
 	display.draw_pixels(
@@ -229,9 +242,21 @@ void WaterfallView::clear() {
 
 WaterfallWidget::WaterfallWidget() {
 	add_children({
+		&options_window,
+		&options_trace,
 		&waterfall_view,
 		&frequency_scale,
 	});
+
+	/* Either change starts the averages and holds over. */
+	options_window.on_change = [this](size_t, OptionsField::value_t v) {
+		this->window = static_cast<Window>(v);
+		this->streaming_start();
+	};
+	options_trace.on_change = [this](size_t, OptionsField::value_t v) {
+		this->trace = static_cast<Trace>(v);
+		this->streaming_start();
+	};
 }
 
 void WaterfallWidget::on_show() {
@@ -252,7 +277,7 @@ void WaterfallWidget::on_show() {
 		}
 	);
 
-	baseband::spectrum_streaming_start();
+	streaming_start();
 }
 
 void WaterfallWidget::on_hide() {
@@ -263,17 +288,22 @@ void WaterfallWidget::on_hide() {
 }
 
 void WaterfallWidget::set_parent_rect(const Rect new_parent_rect) {
+	constexpr Dim options_height = 16;
 	constexpr Dim scale_height = 20;
 
 	View::set_parent_rect(new_parent_rect);
-	frequency_scale.set_parent_rect({ 0, 0, new_parent_rect.width(), scale_height });
+	frequency_scale.set_parent_rect({ 0, options_height, new_parent_rect.width(), scale_height });
 	waterfall_view.set_parent_rect({
-		0, scale_height,
+		0, options_height + scale_height,
 		new_parent_rect.width(),
-		new_parent_rect.height() - scale_height
+		new_parent_rect.height() - options_height - scale_height
 	});
 }
 
+void WaterfallWidget::streaming_start() {
+	baseband::spectrum_streaming_start(window, trace);
+}
+
 void WaterfallWidget::paint(Painter& painter) {
 	// TODO:
 	(void)painter;
@@ -27,8 +27,11 @@
 
 #include "message.hpp"
 
+#include "utility.hpp"
+
 #include <cstdint>
 #include <cstddef>
+#include <array>
 
 namespace ui {
 namespace spectrum {
@@ -46,7 +49,8 @@ private:
 	static constexpr int filter_band_height = 4;
 
 	int spectrum_sampling_rate { 0 };
-	const int spectrum_bins = std::tuple_size<decltype(ChannelSpectrum::db)>::value;
+	/* Pixels across the full spectrum span, independent of bin count. */
+	const int spectrum_bins = 256;
 	int channel_filter_pass_frequency { 0 };
 	int channel_filter_stop_frequency { 0 };
 
@@ -66,6 +70,9 @@ public:
 
 	void on_channel_spectrum(const ChannelSpectrum& spectrum);
 
+	/* Scrolls in one row, already mapped to pixels. */
+	void on_pixel_row(const std::array<Color, 240>& pixel_row);
+
 private:
 	void clear();
 };
@@ -82,10 +89,38 @@ public:
 	void paint(Painter& painter) override;
 
 private:
+	using Window = SpectrumStreamingConfigMessage::Window;
+	using Trace = SpectrumStreamingConfigMessage::Trace;
+
+	Window window { Window::Hann };
+	Trace trace { Trace::Average };
+
+	OptionsField options_window {
+		{ 0 * 8, 0 * 16 },
+		4,
+		{
+			{ "Hann", toUType(Window::Hann) },
+			{ "B-H ", toUType(Window::BlackmanHarris) },
+			{ "Flat", toUType(Window::FlatTop) },
+		}
+	};
+
+	OptionsField options_trace {
+		{ 5 * 8, 0 * 16 },
+		3,
+		{
+			{ "Avg", toUType(Trace::Average) },
+			{ "Max", toUType(Trace::MaxHold) },
+			{ "Min", toUType(Trace::MinHold) },
+		}
+	};
+
 	WaterfallView waterfall_view;
 	FrequencyScale frequency_scale;
 	ChannelSpectrumFIFO* fifo { nullptr };
 
+	void streaming_start();
+
 	void on_channel_spectrum(const ChannelSpectrum& spectrum);
 };
 
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <algorithm>
 
 #include "hal.h"
 #include "gpdma.hpp"
@@ -86,24 +87,44 @@ constexpr gpdma::channel::Config config(const baseband::Direction direction) {
 	};
 }
 
-constexpr size_t buffer_samples_log2n = 13;
-constexpr size_t buffer_samples = (1 << buffer_samples_log2n);
-constexpr size_t transfers_per_buffer_log2n = 2;
-constexpr size_t transfers_per_buffer = (1 << transfers_per_buffer_log2n);
-constexpr size_t transfer_samples = buffer_samples / transfers_per_buffer;
-constexpr size_t transfers_mask = transfers_per_buffer - 1;
+static std::array<gpdma::channel::LLI, transfers_max> lli_loop;
 
-constexpr size_t buffer_bytes = buffer_samples * sizeof(baseband::sample_t);
-constexpr size_t transfer_bytes = transfer_samples * sizeof(baseband::sample_t);
-
-constexpr size_t msg_count = transfers_per_buffer - 1;
-
-static std::array<gpdma::channel::LLI, transfers_per_buffer> lli_loop;
+/* Current geometry, set by configure(). */
+static size_t transfer_samples { 2048 };
+static size_t transfers_per_buffer { 4 };
+static size_t transfers_mask { 3 };
 static constexpr auto& gpdma_channel_sgpio = gpdma::channels[portapack::sgpio_gpdma_channel_number];
 
 static ThreadWait thread_wait;
 
+/* Written by the transfer complete interrupt only. */
+static volatile uint32_t transfers_completed { 0 };
+static volatile halrtcnt_t transfer_complete_cycles { 0 };
+static volatile halrtcnt_t transfer_period_cycles { 0 };
+
+/* Receive thread side: the transfer behind the buffer it holds. */
+static bool buffer_held { false };
+static uint32_t buffer_transfer { 0 };
+static halrtcnt_t buffer_deadline_cycles { 0 };
+
+struct StatisticsAccumulator {
+	uint32_t transfers_first { 0 };
+	uint32_t buffers { 0 };
+	uint32_t skipped { 0 };
+	uint32_t overwritten { 0 };
+	int32_t slack_min { INT32_MAX };
+	int64_t slack_sum { 0 };
+	uint32_t slack_count { 0 };
+};
+
+static StatisticsAccumulator accumulator;
+
 static void transfer_complete() {
+	const auto now = halGetCounterValue();
+	transfer_period_cycles = now - transfer_complete_cycles;
+	transfer_complete_cycles = now;
+	transfers_completed = transfers_completed + 1;
+
 	const auto next_lli_index = gpdma_channel_sgpio.next_lli() - &lli_loop[0];
 	thread_wait.wake_from_interrupt(next_lli_index);
 }
@@ -122,20 +143,30 @@ void init() {
 
 void configure(
 	baseband::sample_t* const buffer_base,
-	const baseband::Direction direction
+	const baseband::Direction direction,
+	const size_t new_transfer_samples,
+	const size_t new_transfers
 ) {
+	transfer_samples = new_transfer_samples;
+	transfers_per_buffer = new_transfers;
+	transfers_mask = transfers_per_buffer - 1;
+
+	const size_t transfer_bytes = transfer_samples * sizeof(baseband::sample_t);
 	const auto peripheral = reinterpret_cast<uint32_t>(&LPC_SGPIO->REG_SS[0]);
 	const auto control_value = control(direction, gpdma::buffer_words(transfer_bytes, 4));
-	for(size_t i=0; i<lli_loop.size(); i++) {
+	for(size_t i=0; i<transfers_per_buffer; i++) {
 		const auto memory = reinterpret_cast<uint32_t>(&buffer_base[i * transfer_samples]);
 		lli_loop[i].srcaddr = (direction == Direction::Transmit) ? memory : peripheral;
 		lli_loop[i].destaddr = (direction == Direction::Transmit) ? peripheral : memory;
-		lli_loop[i].lli = lli_pointer(&lli_loop[(i + 1) % lli_loop.size()]);
+		lli_loop[i].lli = lli_pointer(&lli_loop[(i + 1) & transfers_mask]);
 		lli_loop[i].control = control_value;
 	}
 }
 
 void enable(const baseband::Direction direction) {
+	/* The ring starts over: nothing held, nothing missed yet. */
+	buffer_held = false;
+
 	const auto gpdma_config = config(direction);
 	gpdma_channel_sgpio.configure(lli_loop[0], gpdma_config);
 	gpdma_channel_sgpio.enable();
@@ -149,16 +180,75 @@ void disable() {
 	gpdma_channel_sgpio.disable();
 }
 
+/* The thread is done with the buffer it held. If all but one of the other
+ * transfers in the ring have completed since it was handed over, the DMA
+ * has wrapped around and is writing into it: whatever the processor read after that point
+ * was newer than the rest of the buffer.
+ */
+static void buffer_released() {
+	const int32_t slack = buffer_deadline_cycles - halGetCounterValue();
+	accumulator.slack_min = std::min(accumulator.slack_min, slack);
+	accumulator.slack_sum += slack;
+	accumulator.slack_count++;
+
+	if( (transfers_completed - buffer_transfer) >= (transfers_per_buffer - 1) ) {
+		accumulator.overwritten++;
+	}
+}
+
+/* Expected: the transfer after the one behind the last buffer. Observed:
+ * the one that just woke the thread. Any in between completed while the
+ * thread was busy, and their wake-ups were lost.
+ */
+static void buffer_acquired() {
+	const uint32_t transfer = transfers_completed;
+	if( buffer_held ) {
+		const uint32_t expected = buffer_transfer + 1;
+		accumulator.skipped += transfer - expected;
+	}
+
+	buffer_held = true;
+	buffer_transfer = transfer;
+	buffer_deadline_cycles = transfer_complete_cycles + transfer_period_cycles;
+	accumulator.buffers++;
+}
+
 baseband::buffer_t wait_for_rx_buffer() {
+	if( buffer_held ) {
+		buffer_released();
+	}
+
 	const auto next_index = thread_wait.sleep();
 	
 	if( next_index >= 0 ) {
+		buffer_acquired();
+
 		const size_t free_index = (next_index + transfers_per_buffer - 2) & transfers_mask;
 		return { reinterpret_cast<sample_t*>(lli_loop[free_index].destaddr), transfer_samples };
 	} else {
+		buffer_held = false;
 		return { };
 	}
 }
 
+Statistics capture_statistics() {
+	const uint32_t transfers_now = transfers_completed;
+
+	Statistics statistics;
+	statistics.transfers = transfers_now - accumulator.transfers_first;
+	statistics.buffers = accumulator.buffers;
+	statistics.skipped = accumulator.skipped;
+	statistics.overwritten = accumulator.overwritten;
+	if( accumulator.slack_count > 0 ) {
+		statistics.slack_min = accumulator.slack_min;
+		statistics.slack_avg = accumulator.slack_sum / accumulator.slack_count;
+	}
+
+	accumulator = StatisticsAccumulator { };
+	accumulator.transfers_first = transfers_now;
+
+	return statistics;
+}
+
 } /* namespace dma */
 } /* namespace baseband */
@@ -22,21 +22,41 @@
 #ifndef __BASEBAND_DMA_H__
 #define __BASEBAND_DMA_H__
 
+#include <cstdint>
 #include <cstddef>
 #include <array>
 
 #include "complex.hpp"
 #include "baseband.hpp"
+#include "baseband_source.hpp"
 
 namespace baseband {
 namespace dma {
 
 using Handler = void (*)();
 
+/* Ring geometry limits. The ring has to fit the sample storage the
+ * baseband thread sets aside, each transfer is at most 4095 words (the
+ * GPDMA transfer size field is 12 bits), and the thread needs at least one
+ * transfer in flight beside the one it is processing.
+ */
+constexpr size_t ring_samples_max = 8192;
+constexpr size_t transfer_samples_min = 256;
+constexpr size_t transfer_samples_max = 4096;
+constexpr size_t transfers_min = 2;
+constexpr size_t transfers_max = 16;
+
 void init();
+
+/* Rebuilds the LLI chain: "transfers" transfers of "transfer_samples"
+ * each, back to back from buffer_base, looping. Both must be powers of two
+ * within the limits above. Only while the DMA is disabled.
+ */
 void configure(
 	baseband::sample_t* const buffer_base,
-	const baseband::Direction direction
+	const baseband::Direction direction,
+	const size_t transfer_samples,
+	const size_t transfers
 );
 
 void enable(const baseband::Direction direction);
@@ -46,6 +66,37 @@ void disable();
 
 baseband::buffer_t wait_for_rx_buffer();
 
+/* How well the receive thread keeps up with the DMA ring, since the last
+ * capture_statistics() call.
+ *
+ * Every transfer completion is a deadline: the buffer it hands over has to
+ * be processed before the next one completes. Slack is the time left
+ * before that deadline when the thread comes back for another buffer;
+ * negative slack means the deadline was missed.
+ */
+struct Statistics {
+	/* Transfers the DMA completed, and how many reached the thread. */
+	uint32_t transfers { 0 };
+	uint32_t buffers { 0 };
+	/* Completed transfers the thread never saw: it was still busy with an
+	 * earlier buffer when they finished.
+	 */
+	uint32_t skipped { 0 };
+	/* Buffers the DMA started refilling while the thread still had them. */
+	uint32_t overwritten { 0 };
+	int32_t slack_min { 0 };
+	int32_t slack_avg { 0 };
+};
+
+Statistics capture_statistics();
+
+class DMASource : public SampleSource {
+public:
+	baseband::buffer_t read() override {
+		return wait_for_rx_buffer();
+	}
+};
+
 } /* namespace dma */
 } /* namespace baseband */
 
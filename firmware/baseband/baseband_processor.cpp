@@ -25,6 +25,22 @@
 
 #include "message.hpp"
 
+#include <algorithm>
+
+constexpr size_t BasebandProcessor::buffer_samples_max;
+
+void BasebandProcessor::execute_transfer(const buffer_c8_t& transfer) {
+	for(size_t offset=0; offset<transfer.count; offset+=buffer_samples_max) {
+		const buffer_c8_t buffer {
+			&transfer.p[offset],
+			std::min(transfer.count - offset, buffer_samples_max),
+			transfer.sampling_rate,
+			transfer.timestamp
+		};
+		execute(buffer);
+	}
+}
+
 void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
 	channel_stats.feed(
 		channel,
@@ -34,3 +50,13 @@ void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
 		}
 	);
 }
+
+void BasebandProcessor::feed_stage_stats(const buffer_c8_t& buffer) {
+	stage_profiler.feed(
+		buffer,
+		[](const StageStatistics& statistics) {
+			const StageStatisticsMessage stage_stats_message { statistics };
+			shared_memory.application_queue.push(stage_stats_message);
+		}
+	);
+}
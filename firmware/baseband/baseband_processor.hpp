@@ -25,6 +25,7 @@
 #include "dsp_types.hpp"
 
 #include "channel_stats_collector.hpp"
+#include "stage_profiler.hpp"
 
 #include "message.hpp"
 
@@ -36,9 +37,29 @@ public:
 
 	virtual void on_message(const Message* const) { };
 
+	/* The processors' intermediate arrays are sized for at most this many
+	 * samples per execute(). Larger DMA transfers go through
+	 * execute_transfer(), which hands them over in pieces of this size.
+	 */
+	static constexpr size_t buffer_samples_max = 2048;
+
+	/* Smallest transfer execute() copes with. Decimation chains need enough
+	 * input to produce whole output samples at every stage.
+	 */
+	virtual size_t buffer_samples_min() const { return 256; }
+
+	void execute_transfer(const buffer_c8_t& transfer);
+
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
 
+	/* Processors that want a per-stage breakdown call stage_profiler.start()
+	 * and lap() in execute(), then feed_stage_stats() at the end.
+	 */
+	StageProfiler stage_profiler;
+
+	void feed_stage_stats(const buffer_c8_t& buffer);
+
 private:
 	ChannelStatsCollector channel_stats;
 };
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BASEBAND_SOURCE_H__
+#define __BASEBAND_SOURCE_H__
+
+#include "baseband.hpp"
+
+namespace baseband {
+
+/* Where BasebandThread gets its receive buffers from. On the device that's
+ * the SGPIO DMA ring (dma::DMASource). The host replay tool substitutes a
+ * recording, so a processor sees exactly the same samples every run.
+ */
+class SampleSource {
+public:
+	virtual ~SampleSource() = default;
+
+	/* Blocks until the next buffer is ready. Returns an empty buffer on a
+	 * timeout or when the source has run dry.
+	 */
+	virtual buffer_t read() = 0;
+};
+
+} /* namespace baseband */
+
+#endif/*__BASEBAND_SOURCE_H__*/
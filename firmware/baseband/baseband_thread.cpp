@@ -38,12 +38,41 @@
 #include "proc_wideband_spectrum.hpp"
 #include "proc_tpms.hpp"
 #include "proc_ert.hpp"
+#include "proc_capture.hpp"
+
+#include "processor_arena.hpp"
 
 #include "portapack_shared_memory.hpp"
 
+#include "utility.hpp"
+
 #include <array>
+#include <algorithm>
 
 static baseband::SGPIO baseband_sgpio;
+static baseband::dma::DMASource baseband_dma_source;
+
+static baseband::ProcessorArena<
+	NarrowbandAMAudio,
+	NarrowbandFMAudio,
+	WidebandFMAudio,
+	AISProcessor,
+	WidebandSpectrum,
+	TPMSProcessor,
+	ERTProcessor,
+	CaptureProcessor
+> processor_arena;
+
+/* The arena replaces the heap block the biggest processor used to take at
+ * mode switch. It shares the M4's 96KiB with the 16KiB DMA ring, the stacks
+ * and the DSP state arena: keep it to under half.
+ */
+static_assert(sizeof(processor_arena) <= 48 * 1024, "processors outgrew their share of M4 RAM");
+
+/* What one buffer sends the M0: statistics, now and then a packet. More than
+ * this goes over in two or more publishes.
+ */
+static std::array<uint8_t, 512> application_batch_data;
 
 WORKING_AREA(baseband_thread_wa, 4096);
 
@@ -54,21 +83,79 @@ Thread* BasebandThread::start(const tprio_t priority) {
 	);
 }
 
+/* Largest power of two no greater than n, within [lo, hi]. */
+static size_t power_of_two_within(const size_t n, const size_t lo, const size_t hi) {
+	return std::min(std::max(size_t(1) << log_2(n), lo), hi);
+}
+
+/* The nearest ring geometry to the one asked for that the DMA and the
+ * processor can both run: the transfer no smaller than the processor
+ * accepts, and as many transfers as fit the ring storage.
+ */
+static BasebandConfiguration ring_geometry(
+	BasebandConfiguration configuration,
+	const BasebandProcessor* const processor
+) {
+	const size_t transfer_samples_min = std::max(
+		baseband::dma::transfer_samples_min,
+		processor ? processor->buffer_samples_min() : 0
+	);
+	configuration.transfer_samples = power_of_two_within(
+		configuration.transfer_samples,
+		transfer_samples_min, baseband::dma::transfer_samples_max
+	);
+	configuration.transfers = power_of_two_within(
+		configuration.transfers,
+		baseband::dma::transfers_min,
+		std::min(baseband::dma::transfers_max, baseband::dma::ring_samples_max / configuration.transfer_samples)
+	);
+	return configuration;
+}
+
 void BasebandThread::set_configuration(const BasebandConfiguration& new_configuration) {
-	if( new_configuration.mode != baseband_configuration.mode ) {
+	const bool mode_changed = (new_configuration.mode != baseband_configuration.mode);
+	const bool geometry_changed =
+		(new_configuration.transfer_samples != requested_transfer_samples) ||
+		(new_configuration.transfers != requested_transfers);
+
+	auto configuration = new_configuration;
+	if( mode_changed || geometry_changed ) {
+		const auto switch_start = halGetCounterValue();
+
 		disable();
 
-		// TODO: Timing problem around disabling DMA and nulling and deleting old processor
-		auto old_p = baseband_processor;
-		baseband_processor = nullptr;
-		delete old_p;
+		if( mode_changed ) {
+			/* This runs on the event loop thread, which the baseband thread
+			 * outranks: the baseband thread is waiting for a buffer, not inside
+			 * the processor. With the pointer cleared first, a buffer completing
+			 * mid-switch is skipped instead of reaching a half-built processor.
+			 */
+			baseband_processor = nullptr;
+			baseband_processor = create_processor(new_configuration.mode);
+		}
 
-		baseband_processor = create_processor(new_configuration.mode);
+		/* The LLI chain is rebuilt for every switch: the new processor may
+		 * not accept the transfers the old one ran with.
+		 */
+		configuration = ring_geometry(new_configuration, baseband_processor);
+		baseband::dma::configure(
+			baseband_buffer,
+			direction(),
+			configuration.transfer_samples,
+			configuration.transfers
+		);
 
 		enable();
+
+		mode_switch_cycles = halGetCounterValue() - switch_start;
+	} else {
+		configuration.transfer_samples = baseband_configuration.transfer_samples;
+		configuration.transfers = baseband_configuration.transfers;
 	}
 
-	baseband_configuration = new_configuration;
+	requested_transfer_samples = new_configuration.transfer_samples;
+	requested_transfers = new_configuration.transfers;
+	baseband_configuration = configuration;
 }
 
 void BasebandThread::on_message(const Message* const message) {
@@ -85,12 +172,14 @@ void BasebandThread::run() {
 	baseband_sgpio.init();
 	baseband::dma::init();
 
-	const auto baseband_buffer = new std::array<baseband::sample_t, 8192>();
+	const auto ring = new std::array<baseband::sample_t, baseband::dma::ring_samples_max>();
+	baseband_buffer = ring->data();
 	baseband::dma::configure(
-		baseband_buffer->data(),
-		direction()
+		baseband_buffer,
+		direction(),
+		baseband_configuration.transfer_samples,
+		baseband_configuration.transfers
 	);
-	//baseband::dma::allocate(4, 2048);
 
 	BasebandStatsCollector stats {
 		chSysGetIdleThread(),
@@ -99,40 +188,68 @@ void BasebandThread::run() {
 		chThdSelf()
 	};
 
+	if( sample_source == nullptr ) {
+		sample_source = &baseband_dma_source;
+	}
+
+	MessageQueue::Batch application_batch {
+		application_batch_data.data(),
+		application_batch_data.size()
+	};
+
 	while(true) {
 		// TODO: Place correct sampling rate into buffer returned here:
-		const auto buffer_tmp = baseband::dma::wait_for_rx_buffer();
+		const auto buffer_tmp = sample_source->read();
 		if( buffer_tmp ) {
 			buffer_c8_t buffer {
 				buffer_tmp.p, buffer_tmp.count, baseband_configuration.sampling_rate
 			};
 
+			/* Everything this buffer produces goes across to the M0 in one go. */
+			shared_memory.application_queue.batch_begin(application_batch);
+
 			if( baseband_processor ) {
-				baseband_processor->execute(buffer);
+				baseband_processor->execute_transfer(buffer);
 			}
 
 			stats.process(buffer,
-				[](const BasebandStatistics& statistics) {
+				[this](BasebandStatistics statistics) {
+					statistics.mode_switch_cycles = mode_switch_cycles;
+					statistics.application_queue_depth_max = shared_memory.application_queue.depth_max();
+					statistics.application_queue_dropped = shared_memory.application_queue.dropped();
+					if( sample_source == &baseband_dma_source ) {
+						const auto dma_statistics = baseband::dma::capture_statistics();
+						statistics.dma_skipped = dma_statistics.skipped;
+						statistics.dma_overwritten = dma_statistics.overwritten;
+						statistics.dma_slack_min_cycles = dma_statistics.slack_min;
+						statistics.dma_slack_avg_cycles = dma_statistics.slack_avg;
+					}
 					const BasebandStatisticsMessage message { statistics };
 					shared_memory.application_queue.push(message);
 				}
 			);
+
+			shared_memory.application_queue.batch_end();
 		}
 	}
 
-	delete baseband_buffer;
+	baseband_buffer = nullptr;
+	delete ring;
 }
 
 BasebandProcessor* BasebandThread::create_processor(const int32_t mode) {
 	switch(mode) {
-	case 0:		return new NarrowbandAMAudio();
-	case 1:		return new NarrowbandFMAudio();
-	case 2:		return new WidebandFMAudio();
-	case 3:		return new AISProcessor();
-	case 4:		return new WidebandSpectrum();
-	case 5:		return new TPMSProcessor();
-	case 6:		return new ERTProcessor();
-	default:	return nullptr;
+	case 0:		return processor_arena.create<NarrowbandAMAudio>();
+	case 1:		return processor_arena.create<NarrowbandFMAudio>();
+	case 2:		return processor_arena.create<WidebandFMAudio>();
+	case 3:		return processor_arena.create<AISProcessor>();
+	case 4:		return processor_arena.create<WidebandSpectrum>();
+	case 5:		return processor_arena.create<TPMSProcessor>();
+	case 6:		return processor_arena.create<ERTProcessor>();
+	case 7:		return processor_arena.create<CaptureProcessor>();
+	default:
+		processor_arena.destroy();
+		return nullptr;
 	}
 }
 
@@ -25,6 +25,7 @@
 #include "thread_base.hpp"
 #include "message.hpp"
 #include "baseband_processor.hpp"
+#include "baseband_source.hpp"
 
 #include <ch.h>
 
@@ -44,8 +45,25 @@ public:
 	Thread* thread_rssi { nullptr };
 	BasebandProcessor* baseband_processor { nullptr };
 
+	/* Replaces the DMA ring as the source of receive buffers. Set before
+	 * start(); nullptr (the default) means DMA.
+	 */
+	baseband::SampleSource* sample_source { nullptr };
+
 private:
+	/* As running: ring geometry as clamped by ring_geometry(). */
 	BasebandConfiguration baseband_configuration;
+	/* Ring geometry as last asked for, so a repeat of the same request is
+	 * not mistaken for a change.
+	 */
+	size_t requested_transfer_samples { 0 };
+	size_t requested_transfers { 0 };
+
+	/* Ring storage for the receive DMA, ring_samples_max samples. */
+	baseband::sample_t* baseband_buffer { nullptr };
+
+	/* How long the last mode switch took, DMA stop to DMA restart. */
+	uint32_t mode_switch_cycles { 0 };
 
 	void run() override;
 
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <algorithm>
 
 #include "dsp_types.hpp"
 #include "complex.hpp"
@@ -60,6 +61,18 @@ public:
 		return factor_;
 	}
 
+	void set_block_size(const size_t new_block_size) {
+		const auto clamped_block_size = std::min(new_block_size, N);
+		if( clamped_block_size != block_size() ) {
+			block_size_ = clamped_block_size;
+			reset_state();
+		}
+	}
+
+	size_t block_size() const {
+		return block_size_;
+	}
+
 	uint32_t output_sampling_rate() const {
 		return input_sampling_rate() / factor();
 	}
@@ -72,8 +85,8 @@ public:
 
 		while( src_i < src.count ) {
 			buffer[dst_i++] = src.p[src_i];
-			if( dst_i == buffer.size() ) {
-				callback({ buffer.data(), buffer.size(), output_sampling_rate() });
+			if( dst_i == block_size() ) {
+				callback({ buffer.data(), block_size(), output_sampling_rate() });
 				reset_state();
 				dst_i = 0;
 			}
@@ -88,6 +101,7 @@ private:
 	std::array<T, N> buffer;
 	uint32_t input_sampling_rate_ { 0 };
 	size_t factor_ { 1 };
+	size_t block_size_ { N };
 	size_t src_i { 0 };
 	size_t dst_i { 0 };
 
@@ -646,8 +646,7 @@ buffer_s16_t FIR64AndDecimateBy2Real::execute(
 void FIRAndDecimateComplex::configure_common(
 	const size_t taps_count, const size_t decimation_factor
 ) {
-	samples_ = std::make_unique<samples_t>(taps_count);
-	taps_reversed_ = std::make_unique<taps_t>(taps_count);
+	samples_.configure(taps_count);
 	taps_count_ = taps_count;
 	decimation_factor_ = decimation_factor;
 }
@@ -669,64 +668,22 @@ buffer_c16_t FIRAndDecimateComplex::execute(
 	const sample_t* src_p = src.p;
 	size_t outer_count = output_samples;
 	while(outer_count > 0) {
-		/* Put new samples into delay buffer */
-		auto z_new_p = &samples_[taps_count_ - decimation_factor_];
+		/* Put new samples into delay line. No shifting, the delay line
+		 * presents the most recent taps_count samples contiguously.
+		 */
 		for(size_t i=0; i<decimation_factor_; i++) {
-			*__SIMD32(z_new_p)++ = *__SIMD32(src_p)++;
+			samples_.push(*(src_p++));
 		}
 
-		size_t loop_count = taps_count_ / 8;
-		auto t_p = &taps_reversed_[0];
-		auto z_p = &samples_[0];
-
-		int64_t t_real = 0;
-		int64_t t_imag = 0;
-
-		while(loop_count > 0) {
-			const auto tap0 = *__SIMD32(t_p)++;
-			const auto sample0 = *__SIMD32(z_p)++;
-			const auto tap1 = *__SIMD32(t_p)++;
-			const auto sample1 = *__SIMD32(z_p)++;
-			t_real = __SMLSLD(sample0, tap0, t_real);
-			t_imag = __SMLALDX(sample0, tap0, t_imag);
-			t_real = __SMLSLD(sample1, tap1, t_real);
-			t_imag = __SMLALDX(sample1, tap1, t_imag);
-
-			const auto tap2 = *__SIMD32(t_p)++;
-			const auto sample2 = *__SIMD32(z_p)++;
-			const auto tap3 = *__SIMD32(t_p)++;
-			const auto sample3 = *__SIMD32(z_p)++;
-			t_real = __SMLSLD(sample2, tap2, t_real);
-			t_imag = __SMLALDX(sample2, tap2, t_imag);
-			t_real = __SMLSLD(sample3, tap3, t_real);
-			t_imag = __SMLALDX(sample3, tap3, t_imag);
-
-			const auto tap4 = *__SIMD32(t_p)++;
-			const auto sample4 = *__SIMD32(z_p)++;
-			const auto tap5 = *__SIMD32(t_p)++;
-			const auto sample5 = *__SIMD32(z_p)++;
-			t_real = __SMLSLD(sample4, tap4, t_real);
-			t_imag = __SMLALDX(sample4, tap4, t_imag);
-			t_real = __SMLSLD(sample5, tap5, t_real);
-			t_imag = __SMLALDX(sample5, tap5, t_imag);
-
-			const auto tap6 = *__SIMD32(t_p)++;
-			const auto sample6 = *__SIMD32(z_p)++;
-			const auto tap7 = *__SIMD32(t_p)++;
-			const auto sample7 = *__SIMD32(z_p)++;
-			t_real = __SMLSLD(sample6, tap6, t_real);
-			t_imag = __SMLALDX(sample6, tap6, t_imag);
-			t_real = __SMLSLD(sample7, tap7, t_real);
-			t_imag = __SMLALDX(sample7, tap7, t_imag);
-
-			loop_count--;
-		}
+		const auto accum = real_taps_
+			? dsp::fir::mac_real_taps(samples_.window(), &taps_real_reversed_[0], taps_count_)
+			: dsp::fir::mac_complex_taps(samples_.window(), &taps_reversed_[0], taps_count_);
 
 		/* TODO: Re-evaluate whether saturation is performed, normalization,
 		 * all that jazz.
 		 */
-		const int32_t r = t_real >> 16;
-		const int32_t i = t_imag >> 16;
+		const int32_t r = accum.real >> 16;
+		const int32_t i = accum.imag >> 16;
 		const int32_t r_sat = __SSAT(r, 16);
 		const int32_t i_sat = __SSAT(i, 16);
 		*__SIMD32(dst_p)++ = __PKHBT(
@@ -735,27 +692,6 @@ buffer_c16_t FIRAndDecimateComplex::execute(
 			16
 		);
 
-		/* Shift sample buffer left/down by decimation factor. */
-		const size_t unroll_factor = 4;
-		size_t shift_count = (taps_count_ - decimation_factor_) / unroll_factor;
-
-		sample_t* t = &samples_[0];
-		const sample_t* s = &samples_[decimation_factor_];
-		
-		while(shift_count > 0) {
-			*__SIMD32(t)++ = *__SIMD32(s)++;
-			*__SIMD32(t)++ = *__SIMD32(s)++;
-			*__SIMD32(t)++ = *__SIMD32(s)++;
-			*__SIMD32(t)++ = *__SIMD32(s)++;
-			shift_count--;
-		}
-
-		shift_count = (taps_count_ - decimation_factor_) % unroll_factor;
-		while(shift_count > 0) {
-			*(t++) = *(s++);
-			shift_count--;
-		}
-
 		outer_count--;
 	}
 
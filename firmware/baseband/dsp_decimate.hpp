@@ -24,12 +24,12 @@
 
 #include <cstdint>
 #include <array>
-#include <memory>
 #include <algorithm>
 
 #include "utility.hpp"
 
 #include "dsp_types.hpp"
+#include "dsp_fir.hpp"
 
 #include "simd.hpp"
 
@@ -203,8 +203,6 @@ public:
 	using sample_t = complex16_t;
 	using tap_t = complex16_t;
 
-	using taps_t = tap_t[];
-
 	/* NOTE! Current code makes an assumption that block of samples to be
 	 * processed will be a multiple of the taps_count.
 	 */
@@ -228,10 +226,10 @@ public:
 	);
 	
 private:
-	using samples_t = sample_t[];
-
-	std::unique_ptr<samples_t> samples_;
-	std::unique_ptr<taps_t> taps_reversed_;
+	dsp::fir::MirroredDelayLine<sample_t> samples_;
+	dsp::StateArray<tap_t> taps_reversed_;
+	dsp::StateArray<int16_t> taps_real_reversed_;
+	bool real_taps_ { false };
 	size_t taps_count_;
 	size_t decimation_factor_;
 
@@ -242,9 +240,23 @@ private:
 		const size_t decimation_factor
 	) {
 		configure_common(taps_count, decimation_factor);
+		real_taps_ = false;
+		taps_reversed_.configure(taps_count);
 		std::reverse_copy(&taps[0], &taps[taps_count], &taps_reversed_[0]);
 	}
 
+	/* Real taps (int16_t) take the real-tap MAC path. */
+	void configure(
+		const int16_t* const taps,
+		const size_t taps_count,
+		const size_t decimation_factor
+	) {
+		configure_common(taps_count, decimation_factor);
+		real_taps_ = true;
+		taps_real_reversed_.configure(taps_count);
+		std::reverse_copy(&taps[0], &taps[taps_count], &taps_real_reversed_[0]);
+	}
+
 	void configure_common(
 		const size_t taps_count,
 		const size_t decimation_factor
@@ -27,6 +27,11 @@
 
 #include <hal.h>
 
+#include <cstdlib>
+#include <cmath>
+#include <array>
+#include <algorithm>
+
 namespace dsp {
 namespace demodulate {
 
@@ -84,9 +89,113 @@ static inline float angle_precise(const complex32_t t) {
 	return atan2f(t.imag(), t.real());
 }
 
-buffer_f32_t FM::execute(
+/* Shift right so that the larger magnitude of (real, imag) fits in "bits"
+ * bits, sign included.
+ */
+static inline size_t normalize_shift(const complex32_t t, const size_t bits) {
+	const uint32_t m = static_cast<uint32_t>(std::abs(t.real())) | static_cast<uint32_t>(std::abs(t.imag()));
+	const size_t used = 32 - __CLZ(m);
+	return (used >= bits) ? (used - bits + 1) : 0;
+}
+
+static inline float angle_polynomial(const complex32_t t) {
+	/* fxpt_atan2() returns 0..65535 for one turn, so the int16_t result is
+	 * the signed angle in 1/65536ths of a turn.
+	 */
+	constexpr float k = 2.0f * pi / 65536.0f;
+	const auto shift = normalize_shift(t, 16);
+	const int16_t x = t.real() >> shift;
+	const int16_t y = t.imag() >> shift;
+	return fxpt_atan2(y, x) * k;
+}
+
+/* atan(i / 64) for i = 0..64 */
+static constexpr std::array<float, 65> atan_table { {
+	0.000000000f, 0.015623729f, 0.031239833f, 0.046840713f,
+	0.062418810f, 0.077966634f, 0.093476781f, 0.108941957f,
+	0.124354995f, 0.139708874f, 0.154996742f, 0.170211925f,
+	0.185347950f, 0.200398554f, 0.215357700f, 0.230219587f,
+	0.244978663f, 0.259629629f, 0.274167451f, 0.288587362f,
+	0.302884868f, 0.317055753f, 0.331096077f, 0.345002177f,
+	0.358770670f, 0.372398447f, 0.385882669f, 0.399220770f,
+	0.412410442f, 0.425449637f, 0.438336560f, 0.451069656f,
+	0.463647609f, 0.476069330f, 0.488333951f, 0.500440813f,
+	0.512389460f, 0.524179629f, 0.535811238f, 0.547284381f,
+	0.558599315f, 0.569756453f, 0.580756354f, 0.591599710f,
+	0.602287346f, 0.612820202f, 0.623199330f, 0.633425883f,
+	0.643501109f, 0.653426341f, 0.663202993f, 0.672832548f,
+	0.682316555f, 0.691656622f, 0.700854408f, 0.709911618f,
+	0.718830000f, 0.727611333f, 0.736257429f, 0.744770126f,
+	0.753151281f, 0.761402770f, 0.769526480f, 0.777524310f,
+	0.785398163f,
+} };
+
+static inline float angle_table(const complex32_t t) {
+	const float x = std::abs(static_cast<float>(t.real()));
+	const float y = std::abs(static_cast<float>(t.imag()));
+	const bool swap = y > x;
+	const float num = swap ? x : y;
+	const float den = swap ? y : x;
+	if( den == 0.0f ) {
+		return 0.0f;
+	}
+
+	const float n = num / den * 64.0f;
+	const size_t n_int = static_cast<size_t>(n);
+	const float n_frac = n - n_int;
+	const float p0 = atan_table[n_int];
+	const float p1 = atan_table[std::min(n_int + 1, atan_table.size() - 1)];
+	const float octant = p0 + n_frac * (p1 - p0);
+
+	const float quadrant = swap ? (pi / 2.0f - octant) : octant;
+	const float half = (t.real() < 0) ? (pi - quadrant) : quadrant;
+	return (t.imag() < 0) ? -half : half;
+}
+
+/* atan(2^-i), in 1/2^32ths of a turn */
+static constexpr std::array<int32_t, 16> cordic_atan_table { {
+	 536870912,  316933406,  167458907,   85004756,
+	  42667331,   21354465,   10679838,    5340245,
+	   2670163,    1335087,     667544,     333772,
+	    166886,      83443,      41722,      20861,
+} };
+
+static inline float angle_cordic(const complex32_t t) {
+	/* Angle accumulates in 1/2^32ths of a turn, so it wraps into a signed
+	 * angle for free. Leave two bits of headroom for the CORDIC gain.
+	 */
+	constexpr float k = 2.0f * pi / 4294967296.0f;
+	const auto shift = normalize_shift(t, 30);
+	int32_t x = t.real() >> shift;
+	int32_t y = t.imag() >> shift;
+	uint32_t z = 0;
+	if( x < 0 ) {
+		x = -x;
+		y = -y;
+		z = 0x80000000;
+	}
+
+	for(size_t i=0; i<cordic_atan_table.size(); i++) {
+		/* Rotate towards y == 0: direction is +1 while y > 0, else -1.
+		 * Branch-free, conditional negation by (v ^ mask) - mask.
+		 */
+		const int32_t mask = -static_cast<int32_t>(y <= 0);
+		const int32_t x_shifted = x >> i;
+		const int32_t y_shifted = y >> i;
+		x += (y_shifted ^ mask) - mask;
+		y -= (x_shifted ^ mask) - mask;
+		z += (cordic_atan_table[i] ^ mask) - mask;
+	}
+
+	return static_cast<int32_t>(z) * k;
+}
+
+template<float (*Angle)(const complex32_t)>
+static buffer_f32_t demodulate(
 	const buffer_c16_t& src,
-	const buffer_f32_t& dst
+	const buffer_f32_t& dst,
+	complex16_t::rep_type& z_,
+	const float k
 ) {
 	auto z = z_;
 
@@ -99,17 +208,20 @@ buffer_f32_t FM::execute(
 		const auto t0 = multiply_conjugate_s16_s32(s0, z);
 		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
 		z = s1;
-		*(dst_p++) = angle_precise(t0) * kf;
-		*(dst_p++) = angle_precise(t1) * kf;
+		*(dst_p++) = Angle(t0) * k;
+		*(dst_p++) = Angle(t1) * k;
 	}
 	z_ = z;
 
 	return { dst.p, src.count, src.sampling_rate };
 }
 
-buffer_s16_t FM::execute(
+template<float (*Angle)(const complex32_t)>
+static buffer_s16_t demodulate(
 	const buffer_c16_t& src,
-	const buffer_s16_t& dst
+	const buffer_s16_t& dst,
+	complex16_t::rep_type& z_,
+	const float k
 ) {
 	auto z = z_;
 
@@ -122,9 +234,9 @@ buffer_s16_t FM::execute(
 		const auto t0 = multiply_conjugate_s16_s32(s0, z);
 		const auto t1 = multiply_conjugate_s16_s32(s1, s0);
 		z = s1;
-		const int32_t theta0_int = angle_approx_0deg27(t0) * ks16;
+		const int32_t theta0_int = Angle(t0) * k;
 		const int32_t theta0_sat = __SSAT(theta0_int, 16);
-		const int32_t theta1_int = angle_approx_0deg27(t1) * ks16;
+		const int32_t theta1_int = Angle(t1) * k;
 		const int32_t theta1_sat = __SSAT(theta1_int, 16);
 		*__SIMD32(dst_p)++ = __PKHBT(
 			theta0_sat,
@@ -137,7 +249,42 @@ buffer_s16_t FM::execute(
 	return { dst.p, src.count, src.sampling_rate };
 }
 
-void FM::configure(const float sampling_rate, const float deviation_hz) {
+template<typename Buffer>
+static Buffer demodulate(
+	const Discriminator discriminator,
+	const buffer_c16_t& src,
+	const Buffer& dst,
+	complex16_t::rep_type& z,
+	const float k
+) {
+	switch(discriminator) {
+	case Discriminator::Rational:	return demodulate<angle_approx_0deg27>(src, dst, z, k);
+	case Discriminator::Polynomial:	return demodulate<angle_polynomial>(src, dst, z, k);
+	case Discriminator::Table:		return demodulate<angle_table>(src, dst, z, k);
+	case Discriminator::CORDIC:		return demodulate<angle_cordic>(src, dst, z, k);
+	default:						return demodulate<angle_precise>(src, dst, z, k);
+	}
+}
+
+buffer_f32_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_f32_t& dst
+) {
+	return demodulate(discriminator_, src, dst, z_, kf);
+}
+
+buffer_s16_t FM::execute(
+	const buffer_c16_t& src,
+	const buffer_s16_t& dst
+) {
+	return demodulate(discriminator_, src, dst, z_, ks16);
+}
+
+void FM::configure(
+	const float sampling_rate,
+	const float deviation_hz,
+	const Discriminator discriminator
+) {
 	/*
 	 * angle: -pi to pi. output range: -32768 to 32767.
 	 * Maximum delta-theta (output of atan2) at maximum deviation frequency:
@@ -145,6 +292,7 @@ void FM::configure(const float sampling_rate, const float deviation_hz) {
 	 */
 	kf = static_cast<float>(1.0f / (2.0 * pi * deviation_hz / sampling_rate));
 	ks16 = 32767.0f * kf;
+	discriminator_ = discriminator;
 }
 
 }
@@ -49,6 +49,17 @@ private:
 	static constexpr float k = 1.0f / 32768.0f;
 };
 
+/* Phase discriminator backends for FM. "make sinad" in firmware/host
+ * compares their angle error and audio SINAD; "make bench" their cost.
+ */
+enum class Discriminator {
+	Precise,	/* atan2f() */
+	Rational,	/* y/x / (1 + 0.28086 (y/x)^2), no octant folding: |angle| < pi/4 only */
+	Polynomial,	/* fxpt_atan2(): octant-folded 2nd-order polynomial, 16-bit inputs */
+	Table,		/* octant-folded, 64-segment linearly interpolated atan table */
+	CORDIC,		/* 16-iteration vectoring CORDIC, 32-bit inputs */
+};
+
 class FM {
 public:
 	buffer_f32_t execute(
@@ -61,12 +72,17 @@ public:
 		const buffer_s16_t& dst
 	);
 
-	void configure(const float sampling_rate, const float deviation_hz);
+	void configure(
+		const float sampling_rate,
+		const float deviation_hz,
+		const Discriminator discriminator = Discriminator::Precise
+	);
 
 private:
 	complex16_t::rep_type z_ { 0 };
 	float kf { 0 };
 	float ks16 { 0 };
+	Discriminator discriminator_ { Discriminator::Precise };
 };
 
 } /* namespace demodulate */
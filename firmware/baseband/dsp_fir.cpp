@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fir.hpp"
+
+#include <hal.h>
+
+namespace dsp {
+namespace fir {
+
+accumulator_c64_t mac_complex_taps(
+	const complex16_t* const window,
+	const complex16_t* const taps_reversed,
+	const size_t count
+) {
+	auto t_p = taps_reversed;
+	auto z_p = window;
+
+	int64_t t_real = 0;
+	int64_t t_imag = 0;
+
+	size_t loop_count = count / 8;
+	while(loop_count > 0) {
+		const auto tap0 = *__SIMD32(t_p)++;
+		const auto sample0 = *__SIMD32(z_p)++;
+		const auto tap1 = *__SIMD32(t_p)++;
+		const auto sample1 = *__SIMD32(z_p)++;
+		t_real = __SMLSLD(sample0, tap0, t_real);
+		t_imag = __SMLALDX(sample0, tap0, t_imag);
+		t_real = __SMLSLD(sample1, tap1, t_real);
+		t_imag = __SMLALDX(sample1, tap1, t_imag);
+
+		const auto tap2 = *__SIMD32(t_p)++;
+		const auto sample2 = *__SIMD32(z_p)++;
+		const auto tap3 = *__SIMD32(t_p)++;
+		const auto sample3 = *__SIMD32(z_p)++;
+		t_real = __SMLSLD(sample2, tap2, t_real);
+		t_imag = __SMLALDX(sample2, tap2, t_imag);
+		t_real = __SMLSLD(sample3, tap3, t_real);
+		t_imag = __SMLALDX(sample3, tap3, t_imag);
+
+		const auto tap4 = *__SIMD32(t_p)++;
+		const auto sample4 = *__SIMD32(z_p)++;
+		const auto tap5 = *__SIMD32(t_p)++;
+		const auto sample5 = *__SIMD32(z_p)++;
+		t_real = __SMLSLD(sample4, tap4, t_real);
+		t_imag = __SMLALDX(sample4, tap4, t_imag);
+		t_real = __SMLSLD(sample5, tap5, t_real);
+		t_imag = __SMLALDX(sample5, tap5, t_imag);
+
+		const auto tap6 = *__SIMD32(t_p)++;
+		const auto sample6 = *__SIMD32(z_p)++;
+		const auto tap7 = *__SIMD32(t_p)++;
+		const auto sample7 = *__SIMD32(z_p)++;
+		t_real = __SMLSLD(sample6, tap6, t_real);
+		t_imag = __SMLALDX(sample6, tap6, t_imag);
+		t_real = __SMLSLD(sample7, tap7, t_real);
+		t_imag = __SMLALDX(sample7, tap7, t_imag);
+
+		loop_count--;
+	}
+
+	return { t_real, t_imag };
+}
+
+accumulator_c64_t mac_real_taps(
+	const complex16_t* const window,
+	const int16_t* const taps_reversed,
+	const size_t count
+) {
+	auto t_p = taps_reversed;
+	auto z_p = window;
+
+	int64_t t_real = 0;
+	int64_t t_imag = 0;
+
+	/* Regroup two complex samples (i0, q0), (i1, q1) into (i0, i1) and
+	 * (q0, q1), so each dual multiply pairs with two consecutive taps.
+	 */
+	size_t loop_count = count / 8;
+	while(loop_count > 0) {
+		const auto tap1_tap0 = *__SIMD32(t_p)++;
+		const auto sample0 = *__SIMD32(z_p)++;
+		const auto sample1 = *__SIMD32(z_p)++;
+		t_real = __SMLALD(__PKHBT(sample0, sample1, 16), tap1_tap0, t_real);
+		t_imag = __SMLALD(__PKHTB(sample1, sample0, 16), tap1_tap0, t_imag);
+
+		const auto tap3_tap2 = *__SIMD32(t_p)++;
+		const auto sample2 = *__SIMD32(z_p)++;
+		const auto sample3 = *__SIMD32(z_p)++;
+		t_real = __SMLALD(__PKHBT(sample2, sample3, 16), tap3_tap2, t_real);
+		t_imag = __SMLALD(__PKHTB(sample3, sample2, 16), tap3_tap2, t_imag);
+
+		const auto tap5_tap4 = *__SIMD32(t_p)++;
+		const auto sample4 = *__SIMD32(z_p)++;
+		const auto sample5 = *__SIMD32(z_p)++;
+		t_real = __SMLALD(__PKHBT(sample4, sample5, 16), tap5_tap4, t_real);
+		t_imag = __SMLALD(__PKHTB(sample5, sample4, 16), tap5_tap4, t_imag);
+
+		const auto tap7_tap6 = *__SIMD32(t_p)++;
+		const auto sample6 = *__SIMD32(z_p)++;
+		const auto sample7 = *__SIMD32(z_p)++;
+		t_real = __SMLALD(__PKHBT(sample6, sample7, 16), tap7_tap6, t_real);
+		t_imag = __SMLALD(__PKHTB(sample7, sample6, 16), tap7_tap6, t_imag);
+
+		loop_count--;
+	}
+
+	return { t_real, t_imag };
+}
+
+} /* namespace fir */
+} /* namespace dsp */
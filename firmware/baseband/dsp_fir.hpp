@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FIR_H__
+#define __DSP_FIR_H__
+
+#include <cstdint>
+#include <cstddef>
+#include "dsp_state.hpp"
+
+#include "utility.hpp"
+
+#include "complex.hpp"
+
+namespace dsp {
+namespace fir {
+
+/* FIR delay line that never shifts. Each sample is written twice, at i and
+ * i + length, so the most recent "length" samples are always contiguous:
+ * window()[0] is the oldest, window()[length - 1] the newest. Pair it with
+ * taps stored in reverse order and every tap loop is a straight walk over
+ * two arrays.
+ */
+template<typename T>
+class MirroredDelayLine {
+public:
+	void configure(const size_t length) {
+		samples_.configure(length * 2);
+		length_ = length;
+		index_ = 0;
+	}
+
+	void push(const T sample) {
+		samples_[index_] = sample;
+		samples_[index_ + length_] = sample;
+		index_ = (index_ == (length_ - 1)) ? 0 : (index_ + 1);
+	}
+
+	const T* window() const {
+		return &samples_[index_];
+	}
+
+	size_t length() const {
+		return length_;
+	}
+
+private:
+	StateArray<T> samples_;
+	size_t length_ { 0 };
+	size_t index_ { 0 };
+};
+
+struct accumulator_c64_t {
+	int64_t real;
+	int64_t imag;
+};
+
+/* Sum of window[n] * taps_reversed[n] over "count" samples. count must be a
+ * multiple of eight.
+ */
+accumulator_c64_t mac_complex_taps(
+	const complex16_t* const window,
+	const complex16_t* const taps_reversed,
+	const size_t count
+);
+
+/* As above, for real taps. Half the multiplies of the complex-tap version. */
+accumulator_c64_t mac_real_taps(
+	const complex16_t* const window,
+	const int16_t* const taps_reversed,
+	const size_t count
+);
+
+} /* namespace fir */
+} /* namespace dsp */
+
+#endif/*__DSP_FIR_H__*/
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_state.hpp"
+
+#include <ch.h>
+
+#include <algorithm>
+
+namespace dsp {
+
+/* Sized for the hungriest processor (wideband spectrum, 2048 bytes of
+ * window; AM next at 1088), with some headroom. "replay_baseband --list"
+ * (firmware/host) reports each processor's use.
+ */
+constexpr size_t state_arena_size = 3 * 1024;
+
+alignas(8) static uint8_t state_arena_storage[state_arena_size];
+static StateArena state_arena_instance { state_arena_storage, state_arena_size };
+
+StateArena& state_arena() {
+	return state_arena_instance;
+}
+
+void* StateArena::allocate(const size_t bytes, const size_t alignment) {
+	const size_t start = (used_ + alignment - 1) & ~(alignment - 1);
+	if( (start + bytes) > size_ ) {
+		chDbgPanic("StateArena");
+	}
+
+	used_ = start + bytes;
+	used_max_ = std::max(used_max_, used_);
+	return &base[start];
+}
+
+} /* namespace dsp */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_STATE_H__
+#define __DSP_STATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace dsp {
+
+/* Fixed pool for the state arrays (delay lines, reversed taps, FFT buffers)
+ * of the running baseband processor. Allocation just bumps an offset, and
+ * everything is given back at once when the processor goes, so a mode
+ * switch takes bounded time and never touches the heap.
+ */
+class StateArena {
+public:
+	constexpr StateArena(
+		uint8_t* const base,
+		const size_t size
+	) : base { base },
+		size_ { size }
+	{
+	}
+
+	void* allocate(const size_t bytes, const size_t alignment);
+
+	/* Where the next allocation would start, for rewind(). */
+	size_t mark() const {
+		return used_;
+	}
+
+	/* Gives back everything handed out since mark. Each StateArray
+	 * configured after this takes fresh storage, so a processor that
+	 * reconfigures all its arrays from a mark never uses more than the
+	 * latest configuration needs.
+	 */
+	void rewind(const size_t mark) {
+		used_ = mark;
+		generation_++;
+	}
+
+	/* Invalidates everything handed out so far. */
+	void reset() {
+		rewind(0);
+	}
+
+	uint32_t generation() const {
+		return generation_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t used() const {
+		return used_;
+	}
+
+	/* Most ever in use at once, over all processors. */
+	size_t used_max() const {
+		return used_max_;
+	}
+
+private:
+	uint8_t* const base;
+	const size_t size_;
+	size_t used_ { 0 };
+	size_t used_max_ { 0 };
+	uint32_t generation_ { 0 };
+};
+
+StateArena& state_arena();
+
+/* Array of T in the state arena, sized at configure time. Reconfiguring to
+ * the same or a smaller size reuses the storage; growing takes fresh
+ * storage (the old block stays unused until the arena is rewound past it).
+ * After a rewind, configuring always takes fresh storage.
+ */
+template<typename T>
+class StateArray {
+public:
+	static_assert(std::is_trivially_destructible<T>::value, "state arrays are never destroyed");
+
+	/* Elements start out value-initialized (zero), like make_unique<T[]>. */
+	void configure(const size_t count) {
+		auto& arena = state_arena();
+		if( (count > capacity_) || (generation_ != arena.generation()) ) {
+			p_ = static_cast<T*>(arena.allocate(count * sizeof(T), alignof(T)));
+			capacity_ = count;
+			generation_ = arena.generation();
+		}
+		for(size_t i=0; i<count; i++) {
+			new (&p_[i]) T();
+		}
+		count_ = count;
+	}
+
+	size_t size() const {
+		return count_;
+	}
+
+	T* data() {
+		return p_;
+	}
+
+	const T* data() const {
+		return p_;
+	}
+
+	T& operator[](const size_t i) {
+		return p_[i];
+	}
+
+	const T& operator[](const size_t i) const {
+		return p_[i];
+	}
+
+private:
+	T* p_ { nullptr };
+	size_t capacity_ { 0 };
+	size_t count_ { 0 };
+	uint32_t generation_ { 0 };
+};
+
+} /* namespace dsp */
+
+#endif/*__DSP_STATE_H__*/
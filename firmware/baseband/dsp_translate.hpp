@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_TRANSLATE_H__
+#define __DSP_TRANSLATE_H__
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+
+#include <hal.h>
+
+#include <complex>
+#include <cmath>
+
+namespace dsp {
+namespace translate {
+
+/* Shifts a complex baseband by an arbitrary frequency, for offsets that are
+ * not a convenient fraction of the sampling rate (see
+ * TranslateByFSOver4AndDecimateBy2CIC3 for the fs/4 case).
+ *
+ * The oscillator is a recursively rotated phasor, renormalized once per
+ * block so its amplitude doesn't drift.
+ */
+class Translate {
+public:
+	void configure(
+		const float sampling_rate,
+		const float shift_frequency
+	) {
+		const float w = 2.0f * pi * shift_frequency / sampling_rate;
+		step = { std::cos(w), std::sin(w) };
+		phasor = { 1.0f, 0.0f };
+	}
+
+	/* src and dst may be the same buffer. */
+	buffer_c16_t execute(
+		const buffer_c16_t& src,
+		const buffer_c16_t& dst
+	) {
+		float phasor_r = phasor.real();
+		float phasor_i = phasor.imag();
+		const float step_r = step.real();
+		const float step_i = step.imag();
+
+		for(size_t i=0; i<src.count; i++) {
+			const float xr = src.p[i].real();
+			const float xi = src.p[i].imag();
+			dst.p[i] = {
+				static_cast<int16_t>(__SSAT(static_cast<int32_t>(xr * phasor_r - xi * phasor_i), 16)),
+				static_cast<int16_t>(__SSAT(static_cast<int32_t>(xr * phasor_i + xi * phasor_r), 16))
+			};
+
+			const float next_r = phasor_r * step_r - phasor_i * step_i;
+			phasor_i = phasor_r * step_i + phasor_i * step_r;
+			phasor_r = next_r;
+		}
+
+		const float magnitude_inv = 1.0f / std::sqrt(phasor_r * phasor_r + phasor_i * phasor_i);
+		phasor = { phasor_r * magnitude_inv, phasor_i * magnitude_inv };
+
+		return { dst.p, src.count, src.sampling_rate, src.timestamp };
+	}
+
+private:
+	std::complex<float> step { 1.0f, 0.0f };
+	std::complex<float> phasor { 1.0f, 0.0f };
+};
+
+} /* namespace translate */
+} /* namespace dsp */
+
+#endif/*__DSP_TRANSLATE_H__*/
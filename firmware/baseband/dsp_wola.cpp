@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_wola.hpp"
+
+#include <hal.h>
+
+#include <cmath>
+
+namespace dsp {
+namespace wola {
+
+constexpr size_t WindowPresum::src_count;
+constexpr size_t WindowPresum::dst_count;
+constexpr float WindowPresum::coherent_gain;
+
+/* Symmetric (DFT-odd) form, as numpy would make it:
+ *
+ *   w[n] = 0.35875 - 0.48829 cos(x) + 0.14128 cos(2x) - 0.01168 cos(3x),
+ *   x = 2 pi n / 2047
+ *
+ * in double, rounded to Q15 with 32767 full scale. Runs once per mode
+ * switch, so the soft-float cost doesn't matter.
+ */
+static int16_t window_q15(const size_t n) {
+	const double x = n * (2.0 * M_PI / (WindowPresum::src_count - 1));
+	const double w = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+	return static_cast<int16_t>(std::lround(w * 32767));
+}
+
+void WindowPresum::configure() {
+	window_pairs_.configure(dst_count / 2);
+	for(size_t k=0; k<window_pairs_.size(); k++) {
+		const uint16_t w_even = window_q15(k * 2 + 0);
+		const uint16_t w_odd = window_q15(k * 2 + 1);
+		window_pairs_[k] = (static_cast<uint32_t>(w_odd) << 16) | w_even;
+	}
+}
+
+buffer_c16_t WindowPresum::execute(
+	const buffer_c8_t& src,
+	const buffer_c16_t& dst
+) {
+	/* Two outputs, i and i + 1, per pass. Both halves of the window come
+	 * out of the one half-table: w[N + i] = w[N - 1 - i], so the second
+	 * half's pair is the word mirrored about the middle, its coefficients
+	 * swapped. Q15 window times complex8 gives int8 << 15; bring it to
+	 * int8 << 8. The two window halves sum to at most 1.0, so only -128 at
+	 * both ends of a full-scale pair can overflow, by one.
+	 */
+	constexpr size_t n = dst_count;
+	const uint32_t* a_p = reinterpret_cast<const uint32_t*>(&src.p[0]);
+	const uint32_t* b_p = reinterpret_cast<const uint32_t*>(&src.p[n]);
+	const uint32_t* const w_p = window_pairs_.data();
+	uint32_t* dst_p = reinterpret_cast<uint32_t*>(&dst.p[0]);
+	for(size_t k=0; k<n/2; k++) {
+		const uint32_t q1_i1_q0_i0_a = *(a_p++);								// 2
+		const uint32_t q1_i1_q0_i0_b = *(b_p++);								// 1
+		const uint32_t wa1_wa0 = w_p[k];										// 1: w[i+1]:w[i]
+		const uint32_t wb0_wb1 = w_p[n/2 - 1 - k];								// 1: w[N-1-i]:w[N-2-i]
+
+		const uint32_t i1_i0_a = __SXTB16(q1_i1_q0_i0_a, 0);					// 1
+		const uint32_t q1_q0_a = __SXTB16(q1_i1_q0_i0_a, 8);					// 1
+		const uint32_t i1_i0_b = __SXTB16(q1_i1_q0_i0_b, 0);					// 1
+		const uint32_t q1_q0_b = __SXTB16(q1_i1_q0_i0_b, 8);					// 1
+
+		const int32_t i0 = __SMLATB(wb0_wb1, i1_i0_b, __SMULBB(i1_i0_a, wa1_wa0));	// 2: a.i0 * wa0 + b.i0 * wb0
+		const int32_t q0 = __SMLATB(wb0_wb1, q1_q0_b, __SMULBB(q1_q0_a, wa1_wa0));	// 2
+		const int32_t i1 = __SMLATB(i1_i0_b, wb0_wb1, __SMULTT(i1_i0_a, wa1_wa0));	// 2: a.i1 * wa1 + b.i1 * wb1
+		const int32_t q1 = __SMLATB(q1_q0_b, wb0_wb1, __SMULTT(q1_q0_a, wa1_wa0));	// 2
+
+		*(dst_p++) = __PKHBT(__SSAT(i0 >> 7, 16), __SSAT(q0 >> 7, 16), 16);		// 3: ssat, ssat, pkhbt
+		*(dst_p++) = __PKHBT(__SSAT(i1 >> 7, 16), __SSAT(q1 >> 7, 16), 16);		// 3, 2 stores: 2
+	}
+
+	return { dst.p, n, src.sampling_rate, src.timestamp };
+}
+
+} /* namespace wola */
+} /* namespace dsp */
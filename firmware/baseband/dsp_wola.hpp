@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __DSP_WOLA_H__
+#define __DSP_WOLA_H__
+
+#include <cstddef>
+
+#include "dsp_types.hpp"
+#include "dsp_state.hpp"
+
+namespace dsp {
+namespace wola {
+
+/* Window-presum (WOLA) front end for an FFT of half the block length:
+ *
+ *   dst[i] = w[i] * src[i] + w[i + N] * src[i + N],  N = dst.count = 1024
+ *
+ * with w a 2048-point 4-term Blackman-Harris window. Each FFT bin then sees
+ * the leakage of the long window (sidelobes near -92dB) instead of a
+ * rectangular one, for the cost of two multiplies per sample. src holds
+ * 2048 samples; the output is complex8 scaled up by 256, times the window.
+ *
+ * The window is worked out by configure() into the DSP state arena (half
+ * of it, 2KiB: it's symmetric), rather than taking up code RAM as a table.
+ */
+class WindowPresum {
+public:
+	static constexpr size_t src_count = 2048;
+	static constexpr size_t dst_count = src_count / 2;
+
+	/* The window's gain for a tone at a bin centre, for the FFT's calibration. */
+	static constexpr float coherent_gain = 2 * 0.35875f;
+
+	void configure();
+
+	buffer_c16_t execute(
+		const buffer_c8_t& src,
+		const buffer_c16_t& dst
+	);
+
+private:
+	/* First half of the window, Q15, two coefficients to a word (even
+	 * index in the low half), for 32-bit loads.
+	 */
+	StateArray<uint32_t> window_pairs_;
+};
+
+} /* namespace wola */
+} /* namespace dsp */
+
+#endif/*__DSP_WOLA_H__*/
@@ -26,6 +26,8 @@
 
 #include "utility.hpp"
 
+#include <hal.h>
+
 namespace dsp {
 namespace matched_filter {
 
@@ -34,8 +36,8 @@ void MatchedFilter::configure(
 	const size_t taps_count,
 	const size_t decimation_factor
 ) {
-	samples_ = std::make_unique<samples_t>(taps_count);
-	taps_reversed_ = std::make_unique<taps_t>(taps_count);
+	samples_.configure(taps_count);
+	taps_reversed_.configure(taps_count);
 	taps_count_ = taps_count;
 	decimation_factor_ = decimation_factor;
 	output = 0;
@@ -45,16 +47,17 @@ void MatchedFilter::configure(
 bool MatchedFilter::execute_once(
 	const sample_t input
 ) {
-	samples_[taps_count_ - decimation_factor_ + decimation_phase] = input;
+	samples_.push(input);
 
 	advance_decimation_phase();
 	if( is_new_decimation_cycle() ) {
+		const sample_t* const window = samples_.window();
 		float sr_tr = 0.0f;
 		float si_tr = 0.0f;
 		float si_ti = 0.0f;
 		float sr_ti = 0.0f;
 		for(size_t n=0; n<taps_count_; n++) {
-			const auto sample = samples_[n];
+			const auto sample = window[n];
 			const auto tap = taps_reversed_[n];
 
 			sr_tr += sample.real() * tap.real();
@@ -75,31 +78,68 @@ bool MatchedFilter::execute_once(
 		const auto diff = mag_p - mag_n;
 		output = diff;
 
-		shift_by_decimation_factor();
 		return true;
 	} else {
 		return false;
 	}
 }
 
-void MatchedFilter::shift_by_decimation_factor() {
-	const sample_t* s = &samples_[decimation_factor_];
-	sample_t* t = &samples_[0];
-	
-	const size_t unroll_factor = 4;
-	size_t shift_count = (taps_count_ - decimation_factor_) / unroll_factor;	
-	while(shift_count > 0) {
-		*t++ = *s++;
-		*t++ = *s++;
-		*t++ = *s++;
-		*t++ = *s++;
-		shift_count--;
+void MatchedFilterQ15::configure(
+	const std::complex<float>* const taps,
+	const size_t taps_count,
+	const size_t decimation_factor
+) {
+	samples_.configure(taps_count);
+	taps_reversed_.configure(taps_count);
+	taps_count_ = taps_count;
+	decimation_factor_ = decimation_factor;
+	output = 0;
+
+	const auto to_q15 = [](const float v) {
+		return static_cast<int16_t>(std::max(std::min(std::round(v * 32768.0f), 32767.0f), -32768.0f));
+	};
+	for(size_t n=0; n<taps_count; n++) {
+		const auto tap = taps[taps_count - 1 - n];
+		taps_reversed_[n] = { to_q15(tap.real()), to_q15(tap.imag()) };
 	}
+}
+
+bool MatchedFilterQ15::execute_once(
+	const sample_t input
+) {
+	samples_.push(input);
 
-	shift_count = (taps_count_ - decimation_factor_) % unroll_factor;
-	while(shift_count > 0) {
-		*t++ = *s++;
-		shift_count--;
+	advance_decimation_phase();
+	if( is_new_decimation_cycle() ) {
+		auto z_p = samples_.window();
+		auto t_p = &taps_reversed_[0];
+
+		// P: complex multiply of samples and taps.
+		// N: complex multiple of samples and taps (conjugate, tap.i negated).
+		int64_t r_p = 0;
+		int64_t i_p = 0;
+		int64_t r_n = 0;
+		int64_t i_n = 0;
+		for(size_t n=0; n<taps_count_; n++) {
+			const auto sample = *__SIMD32(z_p)++;
+			const auto tap = *__SIMD32(t_p)++;
+			r_p = __SMLSLD(sample, tap, r_p);	// sr * tr - si * ti
+			i_p = __SMLALDX(sample, tap, i_p);	// sr * ti + si * tr
+			r_n = __SMLALD(sample, tap, r_n);	// sr * tr + si * ti
+			i_n = __SMLSLDX(sample, tap, i_n);	// sr * ti - si * tr (negated, squared below)
+		}
+
+		const int64_t r_p_q0 = r_p >> 15;
+		const int64_t i_p_q0 = i_p >> 15;
+		const int64_t r_n_q0 = r_n >> 15;
+		const int64_t i_n_q0 = i_n >> 15;
+		const auto mag2_p = r_p_q0 * r_p_q0 + i_p_q0 * i_p_q0;
+		const auto mag2_n = r_n_q0 * r_n_q0 + i_n_q0 * i_n_q0;
+		output = static_cast<float>(mag2_p - mag2_n);
+
+		return true;
+	} else {
+		return false;
 	}
 }
 
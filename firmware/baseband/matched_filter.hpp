@@ -24,7 +24,9 @@
 
 #include <cstddef>
 #include <complex>
-#include <memory>
+
+#include "complex.hpp"
+#include "dsp_fir.hpp"
 
 namespace dsp {
 namespace matched_filter {
@@ -39,8 +41,6 @@ public:
 	using sample_t = std::complex<float>;
 	using tap_t = std::complex<float>;
 
-	using taps_t = tap_t[];
-
 	template<class T>
 	MatchedFilter(
 		const T& taps,
@@ -64,17 +64,13 @@ public:
 	}
 
 private:
-	using samples_t = sample_t[];
-
-	std::unique_ptr<samples_t> samples_;
-	std::unique_ptr<taps_t> taps_reversed_;
+	dsp::fir::MirroredDelayLine<sample_t> samples_;
+	dsp::StateArray<tap_t> taps_reversed_;
 	size_t taps_count_ { 0 };
 	size_t decimation_factor_ { 1 };
 	size_t decimation_phase { 0 };
 	float output { 0 };
 
-	void shift_by_decimation_factor();
-
 	void advance_decimation_phase() {
 		decimation_phase = (decimation_phase + 1) % decimation_factor_;
 	}
@@ -90,6 +86,66 @@ private:
 	);
 };
 
+/* Fixed-point counterpart of MatchedFilter, for complex16_t samples straight
+ * out of the decimators. Taps are converted to Q15 at configure time. The
+ * conjugate and non-conjugate correlations share one pass of dual 16-bit
+ * MACs, and the output compares squared magnitudes, so there is no sqrt.
+ *
+ * get_output() has the same sign as MatchedFilter's, but a different scale
+ * (mag_p^2 - mag_n^2 instead of mag_p - mag_n). That's fine for consumers
+ * that slice on sign and use only the sign of the timing error, such as
+ * ClockRecovery<FixedErrorFilter>.
+ */
+class MatchedFilterQ15 {
+public:
+	using sample_t = complex16_t;
+	using tap_t = complex16_t;
+
+	template<class T>
+	MatchedFilterQ15(
+		const T& taps,
+		size_t decimation_factor = 1
+	) {
+		configure(taps, decimation_factor);
+	}
+
+	template<class T>
+	void configure(
+		const T& taps,
+		size_t decimation_factor
+	) {
+		configure(taps.data(), taps.size(), decimation_factor);
+	}
+
+	bool execute_once(const sample_t input);
+
+	float get_output() const {
+		return output;
+	}
+
+private:
+	dsp::fir::MirroredDelayLine<sample_t> samples_;
+	dsp::StateArray<tap_t> taps_reversed_;
+	size_t taps_count_ { 0 };
+	size_t decimation_factor_ { 1 };
+	size_t decimation_phase { 0 };
+	float output { 0 };
+
+	void advance_decimation_phase() {
+		decimation_phase = (decimation_phase + 1) % decimation_factor_;
+	}
+
+	bool is_new_decimation_cycle() const {
+		return (decimation_phase == 0);
+	}
+
+	void configure(
+		const std::complex<float>* const taps,
+		const size_t taps_count,
+		const size_t decimation_factor
+	);
+};
+
 } /* namespace matched_filter */
 } /* namespace dsp */
 
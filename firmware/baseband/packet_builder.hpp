@@ -71,6 +71,30 @@ public:
 		reset_state();
 	}
 
+	/* For one of several builders whose preambles a BitPatternSet tests
+	 * (use NeverMatch for the PreambleMatcher): "preamble_matched" is this
+	 * builder's bit of the set's result, "history" what the set tested.
+	 * Until its preamble turns up, the builder doesn't do anything else.
+	 *
+	 * Returns true while receiving a packet. Until then, the caller only
+	 * has to call again for a symbol the builder's preamble matched on.
+	 */
+	bool execute(
+		const uint_fast8_t symbol,
+		const bool preamble_matched,
+		const BitHistory& history
+	) {
+		if( state == State::Preamble ) {
+			if( preamble_matched ) {
+				bit_history = history;
+				state = State::Payload;
+			}
+		} else {
+			execute(symbol);
+		}
+		return state == State::Payload;
+	}
+
 	void execute(
 		const uint_fast8_t symbol
 	) {
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "polyphase_channelizer.hpp"
+
+#include "dsp_fft.hpp"
+
+#include "utility.hpp"
+
+#include <algorithm>
+
+namespace dsp {
+namespace channelizer {
+
+/* Branch sums are at most sum(abs(taps)) / channels * 128, with the taps
+ * scaled as documented in the header. Brings them back into int16_t range.
+ */
+constexpr size_t branch_shift = 7;
+
+void PolyphaseChannelizer::configure(
+	const tap_t* const taps,
+	const size_t taps_count,
+	const size_t channels,
+	const size_t decimation_factor
+) {
+	samples_.configure(taps_count * 2);
+	taps_.configure(taps_count);
+	fft_in_.configure(channels);
+	fft_out_.configure(channels);
+	taps_count_ = taps_count;
+	channels_ = channels;
+	channels_log2_ = log_2(channels);
+	decimation_factor_ = decimation_factor;
+	samples_index_ = 0;
+	rotation_ = 0;
+	std::copy(&taps[0], &taps[taps_count], &taps_[0]);
+}
+
+size_t PolyphaseChannelizer::execute(
+	const buffer_c8_t& src,
+	const buffer_c16_t& dst
+) {
+	const size_t count = std::min(src.count / decimation_factor_, dst.count / channels_);
+
+	const sample_t* s = src.p;
+	for(size_t n=0; n<count; n++) {
+		for(size_t i=0; i<decimation_factor_; i++) {
+			samples_index_ = ((samples_index_ == 0) ? taps_count_ : samples_index_) - 1;
+			const auto sample = *(s++);
+			samples_[samples_index_] = sample;
+			samples_[samples_index_ + taps_count_] = sample;
+		}
+
+		rotation_ = (rotation_ + decimation_factor_) & (channels_ - 1);
+		execute_frame(&dst.p[n], count);
+	}
+
+	output_ = dst.p;
+	output_count_ = count;
+	output_sampling_rate_ = src.sampling_rate / decimation_factor_;
+	output_timestamp_ = src.timestamp;
+
+	return count;
+}
+
+void PolyphaseChannelizer::execute_frame(
+	complex16_t* const dst,
+	const size_t stride
+) {
+	/* Polyphase branch m sums taps[m + p * channels] * x[n - m - p * channels].
+	 * The history is stored newest-first, so that is an element-wise product
+	 * of taps and history, strided by the channel count.
+	 */
+	const sample_t* const w = &samples_[samples_index_];
+	for(size_t m=0; m<channels_; m++) {
+		int32_t r = 0;
+		int32_t i = 0;
+		for(size_t j=m; j<taps_count_; j+=channels_) {
+			const int32_t tap = taps_[j];
+			r += tap * w[j].real();
+			i += tap * w[j].imag();
+		}
+
+		/* Commutator position: rotating the FFT input by the sample count
+		 * (mod channels) keeps each channel's phase continuous when
+		 * decimating by less than the channel count.
+		 */
+		const size_t index = (rotation_ - m) & (channels_ - 1);
+		fft_in_[index] = {
+			static_cast<int16_t>(r >> branch_shift),
+			static_cast<int16_t>(i >> branch_shift)
+		};
+	}
+
+	const size_t exponent = fft_q15(&fft_in_[0], &fft_out_[0], channels_);
+
+	/* Bring every frame to the same scale (1 / channels) regardless of how
+	 * far the FFT had to scale down this block. The FFT budgets for worst-case
+	 * growth, so it may have scaled down further than that.
+	 */
+	if( exponent <= channels_log2_ ) {
+		const size_t shift = channels_log2_ - exponent;
+		for(size_t k=0; k<channels_; k++) {
+			const auto bin = fft_out_[k];
+			dst[k * stride] = {
+				static_cast<int16_t>(bin.real() >> shift),
+				static_cast<int16_t>(bin.imag() >> shift)
+			};
+		}
+	} else {
+		const size_t shift = exponent - channels_log2_;
+		for(size_t k=0; k<channels_; k++) {
+			const auto bin = fft_out_[k];
+			dst[k * stride] = {
+				static_cast<int16_t>(__SSAT(bin.real() << shift, 16)),
+				static_cast<int16_t>(__SSAT(bin.imag() << shift, 16))
+			};
+		}
+	}
+}
+
+} /* namespace channelizer */
+} /* namespace dsp */
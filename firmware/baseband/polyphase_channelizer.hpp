@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __POLYPHASE_CHANNELIZER_H__
+#define __POLYPHASE_CHANNELIZER_H__
+
+#include "dsp_types.hpp"
+#include "dsp_state.hpp"
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace dsp {
+namespace channelizer {
+
+/* FFT-based polyphase analysis filter bank. Splits the complex<int8_t>
+ * baseband into "channels" sub-channels, equally spaced at
+ * fs / channels, in one pass. Channel k is centered at k * fs / channels;
+ * channels above channels / 2 are the negative frequencies.
+ *
+ * Each output sample costs one pass of the prototype filter (taps_count real
+ * MACs per complex sample) plus one channels-point FFT, shared by all
+ * channels. Running the same number of separate decimator chains costs a
+ * full chain per channel.
+ *
+ * The prototype filter is a low-pass at fs / (2 * channels), taps_count a
+ * multiple of channels, scaled so that sum(taps) == channels * 16384. A
+ * full-scale complex<int8_t> tone at a channel's center comes out of that
+ * channel at ~ +/-16384.
+ *
+ * decimation_factor == channels is critically sampled; channels / 2 gives
+ * 2x oversampled channels, which keeps the transition band of the prototype
+ * from aliasing into the adjacent channel's passband.
+ */
+
+class PolyphaseChannelizer {
+public:
+	using sample_t = complex8_t;
+	using tap_t = int16_t;
+
+	template<typename T>
+	void configure(
+		const T& taps,
+		const size_t channels,
+		const size_t decimation_factor
+	) {
+		configure(taps.data(), taps.size(), channels, decimation_factor);
+	}
+
+	size_t channels() const {
+		return channels_;
+	}
+
+	/* Filters and decimates src into every channel. Writes channel k to
+	 * dst.p[k * n] .. dst.p[k * n + n - 1], where
+	 * n = src.count / decimation_factor. Returns n.
+	 * dst.count must be at least channels * n.
+	 */
+	size_t execute(
+		const buffer_c8_t& src,
+		const buffer_c16_t& dst
+	);
+
+	/* Channel k of the most recent execute() */
+	buffer_c16_t channel(const size_t k) const {
+		return {
+			&output_[k * output_count_],
+			output_count_,
+			output_sampling_rate_,
+			output_timestamp_
+		};
+	}
+
+private:
+	/* Reversed history, written twice (at i and i + taps_count) so that the
+	 * most recent taps_count samples are always contiguous.
+	 */
+	StateArray<sample_t> samples_;
+	StateArray<tap_t> taps_;
+	StateArray<complex16_t> fft_in_;
+	StateArray<complex16_t> fft_out_;
+	size_t taps_count_ { 0 };
+	size_t channels_ { 0 };
+	size_t channels_log2_ { 0 };
+	size_t decimation_factor_ { 1 };
+	size_t samples_index_ { 0 };
+	size_t rotation_ { 0 };
+
+	complex16_t* output_ { nullptr };
+	size_t output_count_ { 0 };
+	uint32_t output_sampling_rate_ { 0 };
+	Timestamp output_timestamp_ { };
+
+	void configure(
+		const tap_t* const taps,
+		const size_t taps_count,
+		const size_t channels,
+		const size_t decimation_factor
+	);
+
+	void execute_frame(
+		complex16_t* const dst,
+		const size_t stride
+	);
+};
+
+} /* namespace channelizer */
+} /* namespace dsp */
+
+#endif/*__POLYPHASE_CHANNELIZER_H__*/
@@ -27,19 +27,40 @@
 
 AISProcessor::AISProcessor() {
 	decim_0.configure(taps_11k0_decim_0.taps, 33554432);
-	decim_1.configure(taps_11k0_decim_1.taps, 131072);
 }
 
 void AISProcessor::execute(const buffer_c8_t& buffer) {
 	/* 2.4576MHz, 2048 samples */
 
+	stage_profiler.start();
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	stage_profiler.lap("decim_0");
+
+	/* 307.2kHz, 256 samples, 87B at -25kHz, 88B at +25kHz */
+	feed_channel_stats(decim_0_out);
+
+	channel_87b.execute(decim_0_out);
+	stage_profiler.lap("87B");
+	channel_88b.execute(decim_0_out);
+	stage_profiler.lap("88B");
+
+	feed_stage_stats(buffer);
+}
+
+AISProcessor::Channel::Channel(
+	const float shift_frequency
+) {
+	translate.configure(307200, shift_frequency);
+	decim_1.configure(taps_11k0_decim_1.taps, 131072);
+}
+
+void AISProcessor::Channel::execute(const buffer_c16_t& decim_0_out) {
+	const auto translate_out = translate.execute(decim_0_out, dst_buffer);
+	const auto decim_1_out = decim_1.execute(translate_out, dst_buffer);
 	const auto decimator_out = decim_1_out;
 
 	/* 38.4kHz, 32 samples */
-	feed_channel_stats(decimator_out);
-
 	for(size_t i=0; i<decimator_out.count; i++) {
 		if( mf.execute_once(decimator_out.p[i]) ) {
 			clock_recovery(mf.get_output());
@@ -47,7 +68,7 @@ void AISProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
-void AISProcessor::consume_symbol(
+void AISProcessor::Channel::consume_symbol(
 	const float raw_symbol
 ) {
 	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
@@ -56,7 +77,7 @@ void AISProcessor::consume_symbol(
 	packet_builder.execute(decoded_symbol);
 }
 
-void AISProcessor::payload_handler(
+void AISProcessor::Channel::payload_handler(
 	const baseband::Packet& packet
 ) {
 	const AISPacketMessage message { packet };
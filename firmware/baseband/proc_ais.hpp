@@ -24,7 +24,8 @@
 
 #include "baseband_processor.hpp"
 
-#include "channel_decimator.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_translate.hpp"
 #include "matched_filter.hpp"
 
 #include "clock_recovery.hpp"
@@ -47,32 +48,61 @@ public:
 	void execute(const buffer_c8_t& buffer) override;
 
 private:
-	std::array<complex16_t, 512> dst;
+	/* The radio is tuned between 87B (161.975MHz) and 88B (162.025MHz). Each
+	 * channel is mixed down from the shared first decimation stage and runs
+	 * its own demodulator and packet framing.
+	 */
+	class Channel {
+	public:
+		Channel(const float shift_frequency);
+
+		void execute(const buffer_c16_t& decim_0_out);
+
+	private:
+		std::array<complex16_t, 256> dst;
+		const buffer_c16_t dst_buffer {
+			dst.data(),
+			dst.size()
+		};
+
+		dsp::translate::Translate translate;
+		dsp::decimate::FIRC16xR16x32Decim8 decim_1;
+		/* Matched filter backend: MatchedFilterQ15 (fixed-point, squared
+		 * magnitudes) or MatchedFilter (float reference).
+		 */
+		using MatchedFilter = dsp::matched_filter::MatchedFilterQ15;
+		MatchedFilter mf { baseband::ais::rrc_taps_38k4_4t_p, 2 };
+
+		clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
+			19200, 9600, { 0.0555f },
+			[this](const float symbol) { this->consume_symbol(symbol); }
+		};
+		symbol_coding::NRZIDecoder nrzi_decode;
+		PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder {
+			{ 0b0101010101111110, 16, 1 },
+			{ 0b111110, 6 },
+			{ 0b01111110, 8 },
+			[this](const baseband::Packet& packet) {
+				this->payload_handler(packet);
+			}
+		};
+
+		void consume_symbol(const float symbol);
+		void payload_handler(const baseband::Packet& packet);
+	};
+
+	static constexpr float channel_spacing = 50000.0f;
+
+	std::array<complex16_t, 256> dst;
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
 	};
 
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0;
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1;
-	dsp::matched_filter::MatchedFilter mf { baseband::ais::rrc_taps_38k4_4t_p, 2 };
-
-	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
-		19200, 9600, { 0.0555f },
-		[this](const float symbol) { this->consume_symbol(symbol); }
-	};
-	symbol_coding::NRZIDecoder nrzi_decode;
-	PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder {
-		{ 0b0101010101111110, 16, 1 },
-		{ 0b111110, 6 },
-		{ 0b01111110, 8 },
-		[this](const baseband::Packet& packet) {
-			this->payload_handler(packet);
-		}
-	};
 
-	void consume_symbol(const float symbol);
-	void payload_handler(const baseband::Packet& packet);
+	Channel channel_87b { channel_spacing / 2 };
+	Channel channel_88b { -channel_spacing / 2 };
 };
 
 #endif/*__PROC_AIS_H__*/
@@ -30,18 +30,29 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
 		return;
 	}
 
+	stage_profiler.start();
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	stage_profiler.lap("decim_0");
 	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	stage_profiler.lap("decim_1");
 	const auto decim_2_out = decim_2.execute(decim_1_out, dst_buffer);
+	stage_profiler.lap("decim_2");
 	const auto channel_out = channel_filter.execute(decim_2_out, dst_buffer);
+	stage_profiler.lap("channel");
 
 	// TODO: Feed channel_stats post-decimation data?
 	feed_channel_stats(channel_out);
 	channel_spectrum.feed(channel_out, channel_filter_pass_f, channel_filter_stop_f);
+	stage_profiler.lap("stats");
 
 	auto audio = demodulate(channel_out);
+	stage_profiler.lap("demod");
 	audio_compressor.execute_in_place(audio);
 	audio_output.write(audio);
+	stage_profiler.lap("audio");
+
+	feed_stage_stats(buffer);
 }
 
 buffer_f32_t NarrowbandAMAudio::demodulate(const buffer_c16_t& channel) {
@@ -69,6 +80,8 @@ void NarrowbandAMAudio::on_message(const Message* const message) {
 }
 
 void NarrowbandAMAudio::configure(const AMConfigureMessage& message) {
+	dsp::state_arena().rewind(state_mark);
+
 	constexpr size_t decim_0_input_fs = baseband_fs;
 	constexpr size_t decim_0_output_fs = decim_0_input_fs / decim_0.decimation_factor;
 
@@ -24,6 +24,7 @@
 
 #include "baseband_processor.hpp"
 
+#include "dsp_state.hpp"
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
 #include "audio_compressor.hpp"
@@ -55,6 +56,11 @@ private:
 		audio.size()
 	};
 
+	/* Every state array is set up in configure(), which takes them all
+	 * afresh from here: reconfiguring never leaves old storage behind.
+	 */
+	const size_t state_mark { dsp::state_arena().mark() };
+
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0;
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1;
 	dsp::decimate::FIRAndDecimateComplex decim_2;
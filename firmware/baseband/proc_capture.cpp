@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_capture.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+void CaptureProcessor::execute(const buffer_c8_t& buffer) {
+	if( decimate ) {
+		const auto channel = decimator.execute(buffer);
+		feed_channel_stats(channel);
+
+		if( streaming ) {
+			fifo.write(channel.p, channel.count * sizeof(*channel.p));
+		}
+	} else {
+		if( streaming ) {
+			fifo.write(buffer.p, buffer.count * sizeof(*buffer.p));
+		}
+	}
+}
+
+void CaptureProcessor::on_message(const Message* const message) {
+	switch(message->id) {
+	case Message::ID::CaptureStreamingConfig:
+		set_state(*reinterpret_cast<const CaptureStreamingConfigMessage*>(message));
+		break;
+
+	default:
+		break;
+	}
+}
+
+void CaptureProcessor::set_state(const CaptureStreamingConfigMessage& message) {
+	if( message.mode == CaptureStreamingConfigMessage::Mode::Running ) {
+		start(message.decimation_factor);
+	} else {
+		stop();
+	}
+}
+
+void CaptureProcessor::start(const size_t decimation_factor) {
+	decimate = true;
+	switch(decimation_factor) {
+	case 2:		decimator.set_decimation_factor(ChannelDecimator::DecimationFactor::By2);	break;
+	case 4:		decimator.set_decimation_factor(ChannelDecimator::DecimationFactor::By4);	break;
+	case 8:		decimator.set_decimation_factor(ChannelDecimator::DecimationFactor::By8);	break;
+	case 16:	decimator.set_decimation_factor(ChannelDecimator::DecimationFactor::By16);	break;
+	case 32:	decimator.set_decimation_factor(ChannelDecimator::DecimationFactor::By32);	break;
+	default:	decimate = false;	break;
+	}
+
+	fifo.reset();
+	streaming = true;
+
+	CaptureFIFOMessage message { &fifo };
+	shared_memory.application_queue.push(message);
+}
+
+void CaptureProcessor::stop() {
+	streaming = false;
+}
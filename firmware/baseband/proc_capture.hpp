@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROC_CAPTURE_H__
+#define __PROC_CAPTURE_H__
+
+#include "baseband_processor.hpp"
+#include "channel_decimator.hpp"
+
+#include "block_fifo.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+class CaptureProcessor : public BasebandProcessor {
+public:
+	void execute(const buffer_c8_t& buffer) override;
+
+	void on_message(const Message* const message) override;
+
+private:
+	/* 8KiB blocks (16 SD sectors), four of them: the M0 writes one to the
+	 * card while the others fill. 10.7ms of 768kHz complex<int16_t>.
+	 */
+	static constexpr size_t block_size = 8192;
+	static constexpr size_t block_count_k = 2;
+
+	ChannelDecimator decimator { ChannelDecimator::DecimationFactor::By4 };
+	bool decimate { true };
+	bool streaming { false };
+
+	alignas(4) std::array<uint8_t, block_size << block_count_k> fifo_data;
+	BlockFIFO fifo { fifo_data.data(), block_size, block_count_k };
+
+	void set_state(const CaptureStreamingConfigMessage& message);
+	void start(const size_t decimation_factor);
+	void stop();
+};
+
+#endif/*__PROC_CAPTURE_H__*/
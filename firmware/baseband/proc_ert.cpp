@@ -84,8 +84,10 @@ void ERTProcessor::consume_symbol(
 	const float raw_symbol
 ) {
 	const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
-	scm_builder.execute(sliced_symbol);
-	idm_builder.execute(sliced_symbol);
+	preamble_history.add(sliced_symbol);
+	const auto matches = preambles(preamble_history);
+	scm_builder.execute(sliced_symbol, matches & (1U << Preamble::SCM), preamble_history);
+	idm_builder.execute(sliced_symbol, matches & (1U << Preamble::IDM), preamble_history);
 }
 
 void ERTProcessor::scm_handler(
@@ -66,8 +66,22 @@ private:
 		[this](const float symbol) { this->consume_symbol(symbol); }
 	};
 
-	PacketBuilder<BitPattern, NeverMatch, FixedLength> scm_builder {
+	/* Both preambles, tested in one pass per symbol. Each builder gets its
+	 * own bit of the result.
+	 */
+	enum Preamble {
+		SCM = 0,
+		IDM = 1,
+	};
+
+	BitHistory preamble_history;
+	const BitPatternSet<2> preambles { { {
 		{ scm_preamble_and_sync_manchester, scm_preamble_and_sync_length, 1 },
+		{ idm_preamble_and_sync_manchester, idm_preamble_and_sync_length, 1 },
+	} } };
+
+	PacketBuilder<NeverMatch, NeverMatch, FixedLength> scm_builder {
+		{ },
 		{ },
 		{ scm_payload_length_max },
 		[this](const baseband::Packet& packet) {
@@ -75,8 +89,8 @@ private:
 		}
 	};
 
-	PacketBuilder<BitPattern, NeverMatch, FixedLength> idm_builder {
-		{ idm_preamble_and_sync_manchester, idm_preamble_and_sync_length, 1 },
+	PacketBuilder<NeverMatch, NeverMatch, FixedLength> idm_builder {
+		{ },
 		{ },
 		{ idm_payload_length_max },
 		[this](const baseband::Packet& packet) {
@@ -31,15 +31,25 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 		return;
 	}
 
+	stage_profiler.start();
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	stage_profiler.lap("decim_0");
 	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	stage_profiler.lap("decim_1");
 	const auto channel_out = channel_filter.execute(decim_1_out, dst_buffer);
+	stage_profiler.lap("channel");
 
 	feed_channel_stats(channel_out);
 	channel_spectrum.feed(channel_out, channel_filter_pass_f, channel_filter_stop_f);
+	stage_profiler.lap("stats");
 
 	auto audio = demod.execute(channel_out, audio_buffer);
+	stage_profiler.lap("demod");
 	audio_output.write(audio);
+	stage_profiler.lap("audio");
+
+	feed_stage_stats(buffer);
 }
 
 void NarrowbandFMAudio::on_message(const Message* const message) {
@@ -59,6 +69,8 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 }
 
 void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
+	dsp::state_arena().rewind(state_mark);
+
 	constexpr size_t decim_0_input_fs = baseband_fs;
 	constexpr size_t decim_0_output_fs = decim_0_input_fs / decim_0.decimation_factor;
 
@@ -73,7 +85,8 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
 	decim_0.configure(message.decim_0_filter.taps, 33554432);
 	decim_1.configure(message.decim_1_filter.taps, 131072);
 	channel_filter.configure(message.channel_filter.taps, message.channel_decimation);
-	demod.configure(demod_input_fs, message.deviation);
+	/* Same SINAD as atan2f() for a fraction of the cycles. */
+	demod.configure(demod_input_fs, message.deviation, dsp::demodulate::Discriminator::Table);
 	channel_filter_pass_f = message.channel_filter.pass_frequency_normalized * channel_filter_input_fs;
 	channel_filter_stop_f = message.channel_filter.stop_frequency_normalized * channel_filter_input_fs;
 	channel_spectrum.set_decimation_factor(std::floor(channel_filter_output_fs / (channel_filter_pass_f + channel_filter_stop_f)));
@@ -54,8 +54,12 @@ TPMSProcessor::TPMSProcessor() {
 void TPMSProcessor::execute(const buffer_c8_t& buffer) {
 	/* 2.4576MHz, 2048 samples */
 
+	stage_profiler.start();
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	stage_profiler.lap("decim_0");
 	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+	stage_profiler.lap("decim_1");
 	const auto decimator_out = decim_1_out;
 
 	/* 307.2kHz, 256 samples */
@@ -66,6 +70,9 @@ void TPMSProcessor::execute(const buffer_c8_t& buffer) {
 			clock_recovery(mf.get_output());
 		}
 	}
+	stage_profiler.lap("demod");
+
+	feed_stage_stats(buffer);
 }
 
 void TPMSProcessor::consume_symbol(
@@ -68,7 +68,11 @@ private:
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0;
 	dsp::decimate::FIRC16xR16x16Decim2 decim_1;
 
-	dsp::matched_filter::MatchedFilter mf { rect_taps_307k2_1t_p, 8 };
+	/* Matched filter backend: MatchedFilterQ15 (fixed-point, squared
+	 * magnitudes) or MatchedFilter (float reference).
+	 */
+	using MatchedFilter = dsp::matched_filter::MatchedFilterQ15;
+	MatchedFilter mf { rect_taps_307k2_1t_p, 8 };
 
 	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
 		38400, 19200, { 0.0555f },
@@ -30,8 +30,12 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 		return;
 	}
 
+	stage_profiler.start();
+
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	stage_profiler.lap("decim_0");
 	const auto channel = decim_1.execute(decim_0_out, dst_buffer);
+	stage_profiler.lap("decim_1");
 
 	// TODO: Feed channel_stats post-decimation data?
 	feed_channel_stats(channel);
@@ -41,6 +45,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 		spectrum_samples -= spectrum_interval_samples;
 		channel_spectrum.feed(channel, channel_filter_pass_f, channel_filter_stop_f);
 	}
+	stage_profiler.lap("stats");
 
 	/* 384kHz complex<int16_t>[256]
 	 * -> FM demodulation
@@ -50,6 +55,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 */
 
 	auto audio_oversampled = demod.execute(channel, work_audio_buffer);
+	stage_profiler.lap("demod");
 
 	/* 384kHz int16_t[256]
 	 * -> 4th order CIC decimation by 2, gain of 1
@@ -65,9 +71,13 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 * -> FIR filter, <15kHz (0.156fs) pass, >19kHz (0.198fs) stop, gain of 1
 	 * -> 48kHz int16_t[32] */
 	auto audio = audio_filter.execute(audio_2fs, work_audio_buffer);
+	stage_profiler.lap("audio_dec");
 
 	/* -> 48kHz int16_t[32] */
 	audio_output.write(audio);
+	stage_profiler.lap("audio");
+
+	feed_stage_stats(buffer);
 }
 
 void WidebandFMAudio::on_message(const Message* const message) {
@@ -102,7 +112,11 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	decim_1.configure(message.decim_1_filter.taps, 131072);
 	channel_filter_pass_f = message.decim_1_filter.pass_frequency_normalized * decim_1_input_fs;
 	channel_filter_stop_f = message.decim_1_filter.stop_frequency_normalized * decim_1_input_fs;
-	demod.configure(demod_input_fs, message.deviation);
+	/* Broadcast deviation swings the per-sample phase step well past pi/4,
+	 * where the rational approximation folds over. The table is accurate over
+	 * the whole circle.
+	 */
+	demod.configure(demod_input_fs, message.deviation, dsp::demodulate::Discriminator::Table);
 	audio_filter.configure(message.audio_filter.taps);
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
 
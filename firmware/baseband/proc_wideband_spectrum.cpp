@@ -23,51 +23,128 @@
 
 #include "event_m4.hpp"
 
-#include "dsp_fft.hpp"
+#include "dsp_wola.hpp"
+
+#include "baseband_dma.hpp"
+#include "portapack_shared_memory.hpp"
 
 #include <cstdint>
 #include <cstddef>
 
 #include <array>
+#include <algorithm>
+
+WidebandSpectrum::WidebandSpectrum() {
+	window_presum.configure();
+
+	channel_spectrum.set_fft_size(spectrum.size());
+	/* Each presummed block stands alone: no overlap between them. And it
+	 * is windowed already.
+	 */
+	channel_spectrum.set_segment_overlap(false);
+	channel_spectrum.set_prewindowed(dsp::wola::WindowPresum::coherent_gain);
+}
 
 void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 	// 2048 complex8_t samples per buffer.
 	// 102.4us per buffer. 20480 instruction cycles per buffer.
 
-	if( phase == 0 ) {
-		std::fill(spectrum.begin(), spectrum.end(), 0);
+	if( channel_spectrum.is_sweeping() ) {
+		execute_sweep(buffer);
+	} else {
+		/* Every buffer the event loop can take goes through the presum and
+		 * on to the averager. Each FFT there costs far more than the presum
+		 * does here, so the event loop sets the pace; a buffer that would
+		 * only be dropped by the collector isn't worth presumming.
+		 */
+		if( channel_spectrum.has_room(spectrum.size()) ) {
+			presum_and_feed(buffer);
+		}
 	}
 
-	for(size_t i=0; i<spectrum.size(); i++) {
-		// TODO: Removed window-presum windowing, due to lack of available code RAM.
-		// TODO: Apply window to improve spectrum bin sidelobes.
-		spectrum[i] += buffer.p[i +    0];
-		spectrum[i] += buffer.p[i + 1024];
+	feed_stage_stats(buffer);
+}
+
+void WidebandSpectrum::presum_and_feed(const buffer_c8_t& buffer) {
+	stage_profiler.start();
+
+	const auto presummed = window_presum.execute(
+		buffer,
+		buffer_c16_t { spectrum.data(), spectrum.size() }
+	);
+	stage_profiler.lap("presum");
+
+	channel_spectrum.feed(
+		presummed,
+		0, 0
+	);
+	stage_profiler.lap("feed");
+}
+
+/* The step's samples only have to be in the ring before the M0 can retune:
+ * the FFTs run on the event loop while the synthesizers settle on the next
+ * step, so the sweep goes as fast as the radio can hop.
+ */
+void WidebandSpectrum::execute_sweep(const buffer_c8_t& buffer) {
+	if( sweep_step_posted ) {
+		sweep_step = sweep_step_next;
+		/* Everything the DMA ring held when the step was posted may have
+		 * been sampled mid-retune.
+		 */
+		sweep_discard_samples = sweep_settle_samples + baseband::dma::ring_samples_max;
+		sweep_captured = 0;
+		sweep_capturing = true;
+		sweep_step_posted = false;
 	}
 
-	if( phase == 127 ) {
-		const buffer_c16_t buffer_c16 {
-			spectrum.data(),
-			spectrum.size(),
-			buffer.sampling_rate
-		};
-		channel_spectrum.feed(
-			buffer_c16,
-			0, 0
-		);
-		phase = 0;
-	} else {
-		phase++;
+	if( !sweep_capturing ) {
+		return;
+	}
+
+	if( sweep_discard_samples > 0 ) {
+		sweep_discard_samples -= std::min(sweep_discard_samples, buffer.count);
+		return;
+	}
+
+	if( sweep_captured == 0 ) {
+		if( !channel_spectrum.sweep_ready() ) {
+			return;
+		}
+		channel_spectrum.sweep_begin(sweep_step, sweep_segments);
+	}
+
+	presum_and_feed(buffer);
+
+	sweep_captured++;
+	if( sweep_captured == sweep_segments ) {
+		sweep_capturing = false;
+		const SpectrumSweepCapturedMessage message { sweep_step };
+		shared_memory.application_queue.push(message);
 	}
 }
 
+void WidebandSpectrum::on_sweep_step(const SpectrumSweepStepMessage& message) {
+	sweep_step_next = message.step;
+	sweep_settle_samples = message.settle_samples;
+	sweep_step_posted = true;
+}
+
 void WidebandSpectrum::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
+		channel_spectrum.on_message(message);
+		break;
+
 	case Message::ID::SpectrumStreamingConfig:
+		sweep_step_posted = false;
+		sweep_capturing = false;
 		channel_spectrum.on_message(message);
 		break;
 
+	case Message::ID::SpectrumSweepStep:
+		on_sweep_step(*reinterpret_cast<const SpectrumSweepStepMessage*>(message));
+		break;
+
 	default:
 		break;
 	}
@@ -24,6 +24,7 @@
 
 #include "baseband_processor.hpp"
 #include "spectrum_collector.hpp"
+#include "dsp_wola.hpp"
 
 #include "message.hpp"
 
@@ -33,16 +34,44 @@
 
 class WidebandSpectrum : public BasebandProcessor {
 public:
+	WidebandSpectrum();
+
 	void execute(const buffer_c8_t& buffer) override;
 
 	void on_message(const Message* const message) override;
 
+	/* The window-presum takes whole 2048-sample buffers. */
+	size_t buffer_samples_min() const override { return buffer_samples_max; }
+
 private:
+	/* Sweeping: consecutive buffers presummed per step, all of them, as
+	 * many as the collector's ring holds at once.
+	 */
+	static constexpr size_t sweep_segments = 2;
+
 	SpectrumCollector channel_spectrum;
 
-	std::array<complex16_t, 256> spectrum;
+	dsp::wola::WindowPresum window_presum;
+	std::array<complex16_t, dsp::wola::WindowPresum::dst_count> spectrum;
+
+	/* Sweeping. The event loop posts each step as the M0 announces it, the
+	 * baseband thread takes it from there: throws away the samples from
+	 * before the radio settled, waits for the collector to be done with the
+	 * last step, then captures this one.
+	 */
+	volatile bool sweep_step_posted { false };
+	volatile uint32_t sweep_step_next { 0 };
+	volatile uint32_t sweep_settle_samples { 0 };
+
+	bool sweep_capturing { false };
+	uint32_t sweep_step { 0 };
+	size_t sweep_discard_samples { 0 };
+	size_t sweep_captured { 0 };
+
+	void presum_and_feed(const buffer_c8_t& buffer);
 
-	size_t phase = 0;
+	void execute_sweep(const buffer_c8_t& buffer);
+	void on_sweep_step(const SpectrumSweepStepMessage& message);
 };
 
 #endif/*__PROC_WIDEBAND_SPECTRUM_H__*/
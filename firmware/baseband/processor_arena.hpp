@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROCESSOR_ARENA_H__
+#define __PROCESSOR_ARENA_H__
+
+#include "baseband_processor.hpp"
+#include "dsp_state.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+namespace baseband {
+
+constexpr size_t max_of(const size_t a) {
+	return a;
+}
+
+template<typename... Rest>
+constexpr size_t max_of(const size_t a, const size_t b, const Rest... rest) {
+	return max_of((a > b) ? a : b, rest...);
+}
+
+/* Static home for the one running baseband processor: storage for the
+ * largest of Processors, reused by each in turn with placement new. The
+ * processor's DSP state comes from dsp::state_arena(), which is reset
+ * along with it. A mode switch therefore never touches the heap.
+ */
+template<typename... Processors>
+class ProcessorArena {
+public:
+	static constexpr size_t size = max_of(sizeof(Processors)...);
+	static constexpr size_t alignment = max_of(alignof(Processors)...);
+
+	template<typename T>
+	T* create() {
+		static_assert(sizeof(T) <= size, "processor too big for arena");
+		static_assert(alignof(T) <= alignment, "processor alignment too strict for arena");
+
+		destroy();
+		auto p = new (storage) T();
+		processor = p;
+		return p;
+	}
+
+	void destroy() {
+		if( processor ) {
+			processor->~BasebandProcessor();
+			processor = nullptr;
+		}
+		dsp::state_arena().reset();
+	}
+
+private:
+	alignas(alignment) uint8_t storage[size];
+	BasebandProcessor* processor { nullptr };
+};
+
+} /* namespace baseband */
+
+#endif/*__PROCESSOR_ARENA_H__*/
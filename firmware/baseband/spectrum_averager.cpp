@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "spectrum_averager.hpp"
+
+#include "dsp_fft.hpp"
+
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr size_t SpectrumAverager::fft_size_max;
+
+namespace {
+
+/* Cosine-sum windows, w[n] = sum of a[k] * cos(2 pi k n / N) with
+ * alternating signs. a[0] is the coherent gain, what a tone at a bin
+ * centre is scaled by.
+ */
+struct CosineSum {
+	std::array<float, 5> a;
+};
+
+constexpr CosineSum hann { { 0.5f, 0.5f, 0.0f, 0.0f, 0.0f } };
+constexpr CosineSum blackman_harris { { 0.35875f, 0.48829f, 0.14128f, 0.01168f, 0.0f } };
+constexpr CosineSum flat_top { { 0.21557895f, 0.41663158f, 0.277263158f, 0.083578947f, 0.006947368f } };
+
+const CosineSum& cosine_sum(const SpectrumAverager::Window window) {
+	switch(window) {
+	case SpectrumAverager::Window::BlackmanHarris:	return blackman_harris;
+	case SpectrumAverager::Window::FlatTop:			return flat_top;
+	default:										return hann;
+	}
+}
+
+/* Coherent gain of the display before windowing was moved to the time
+ * domain: the 0.54 centre tap of the three-point Hamming kernel. Keeping
+ * it leaves the calibration of the waterfall unchanged.
+ */
+constexpr float reference_gain = 0.54f;
+
+} /* namespace */
+
+void SpectrumAverager::configure(
+	const size_t fft_size,
+	const Window window,
+	const Trace trace
+) {
+	const auto& w = cosine_sum(window);
+	reset(fft_size, trace, w.a[0]);
+	windowed_ = true;
+
+	/* Periodic (DFT-even) form: the segments overlap, so the window repeats
+	 * with period fft_size rather than being symmetric over it.
+	 */
+	const float step = 2.0f * pi / fft_size_;
+	for(size_t n=0; n<fft_size_; n++) {
+		float v = 0.0f;
+		float sign = 1.0f;
+		for(size_t k=0; k<w.a.size(); k++) {
+			v += sign * w.a[k] * std::cos(step * k * n);
+			sign = -sign;
+		}
+		window_[n] = std::max(-32768, std::min(32767, static_cast<int>(std::round(v * 32768.0f))));
+	}
+}
+
+void SpectrumAverager::configure_prewindowed(
+	const size_t fft_size,
+	const float coherent_gain,
+	const Trace trace
+) {
+	reset(fft_size, trace, coherent_gain);
+	windowed_ = false;
+}
+
+void SpectrumAverager::reset(
+	const size_t fft_size,
+	const Trace trace,
+	const float coherent_gain
+) {
+	fft_size_ = std::min(fft_size, fft_size_max);
+	trace_ = trace;
+	segments_ = 0;
+	held_ = false;
+
+	/* Undo the FFT's Q15 normalization (the block exponent is added per
+	 * segment), bring the window's coherent gain back to the reference, and
+	 * scale so a tone reads the same regardless of FFT size (calibrated to
+	 * 256 points).
+	 */
+	const float gain = reference_gain / coherent_gain;
+	power_scale_ = std::ldexp(gain * gain, -30 + 2 * (8 - static_cast<int>(log_2(fft_size_))));
+}
+
+void SpectrumAverager::add(
+	const complex16_t* const ring,
+	const size_t ring_mask,
+	const size_t start
+) {
+	const size_t n = fft_size_;
+	if( windowed_ ) {
+		for(size_t i=0; i<n; i++) {
+			const auto s = ring[(start + i) & ring_mask];
+			const int32_t w = window_[i];
+			segment_[i] = {
+				static_cast<int16_t>((s.real() * w) >> 15),
+				static_cast<int16_t>((s.imag() * w) >> 15)
+			};
+		}
+	} else {
+		for(size_t i=0; i<n; i++) {
+			segment_[i] = ring[(start + i) & ring_mask];
+		}
+	}
+
+	const auto exponent = fft_q15(segment_.data(), bins_.data(), n);
+	const float scale = std::ldexp(power_scale_, 2 * static_cast<int>(exponent));
+
+	const bool first = (trace_ == Trace::Average) ? (segments_ == 0) : !held_;
+	for(size_t i=0; i<n; i++) {
+		const auto b = bins_[i];
+		const float p = (static_cast<uint32_t>(b.real() * b.real()) + static_cast<uint32_t>(b.imag() * b.imag())) * scale;
+		if( first ) {
+			power_[i] = p;
+		} else {
+			switch(trace_) {
+			case Trace::MaxHold:	power_[i] = std::max(power_[i], p);	break;
+			case Trace::MinHold:	power_[i] = std::min(power_[i], p);	break;
+			default:				power_[i] += p;						break;
+			}
+		}
+	}
+
+	segments_++;
+	held_ = true;
+}
+
+void SpectrumAverager::spectrum(ChannelSpectrum& spectrum) {
+	const size_t n = fft_size_;
+	spectrum.bin_count = std::min(n, spectrum.db.size());
+
+	const float average = ((trace_ == Trace::Average) && (segments_ > 0)) ? (1.0f / segments_) : 1.0f;
+	/* Keeps the log away from zero, far below the bottom of the display. */
+	const float floor = std::ldexp(1.0f, -30);
+
+	const size_t bins_per_db = n / spectrum.bin_count;
+	for(size_t i=0; i<n; i++) {
+		const float db = mag2_to_dbv_norm(std::max(power_[i] * average, floor));
+		constexpr float mag_scale = 5.0f;
+		const int v = (db * mag_scale) + 255.0f;
+		const uint8_t v_clipped = std::max(0, std::min(255, v));
+		auto& db_bin = spectrum.db[i / bins_per_db];
+		db_bin = std::max(db_bin, v_clipped);
+	}
+
+	segments_ = 0;
+}
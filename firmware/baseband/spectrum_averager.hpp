@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SPECTRUM_AVERAGER_H__
+#define __SPECTRUM_AVERAGER_H__
+
+#include "complex.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Welch power spectrum: each segment is windowed in the time domain,
+ * transformed, and its power per bin combined with the segments before it.
+ * Averaging K segments cuts the variance of the noise floor by about K, so
+ * weak carriers stand out of a smooth floor instead of a ragged one.
+ *
+ * Power is kept as float per bin, calibrated so a tone reads the same for
+ * any window and FFT size (and the same as the old three-point Hamming
+ * display, at 256 points).
+ */
+class SpectrumAverager {
+public:
+	using Window = SpectrumStreamingConfigMessage::Window;
+	using Trace = SpectrumStreamingConfigMessage::Trace;
+
+	static constexpr size_t fft_size_max = 1024;
+
+	/* fft_size: power of two, [4, fft_size_max]. Starts over. */
+	void configure(
+		const size_t fft_size,
+		const Window window,
+		const Trace trace
+	);
+
+	/* As above, for input that arrives already windowed: none is applied
+	 * here, and coherent_gain is the gain of the window it went through.
+	 */
+	void configure_prewindowed(
+		const size_t fft_size,
+		const float coherent_gain,
+		const Trace trace
+	);
+
+	size_t fft_size() const {
+		return fft_size_;
+	}
+
+	/* Adds one segment of fft_size samples, starting at "start" in a ring of
+	 * ring_mask + 1 samples (a power of two) and wrapping around its end.
+	 */
+	void add(
+		const complex16_t* const ring,
+		const size_t ring_mask,
+		const size_t start
+	);
+
+	/* Segments added since the last spectrum(). */
+	size_t segments() const {
+		return segments_;
+	}
+
+	/* Fills in bin_count and the db bins. Bins above ChannelSpectrum::bins_max
+	 * are peak-reduced, as the display can't show more. Starts the next
+	 * average; held traces carry on.
+	 */
+	void spectrum(ChannelSpectrum& spectrum);
+
+private:
+	void reset(const size_t fft_size, const Trace trace, const float coherent_gain);
+
+	std::array<int16_t, fft_size_max> window_;
+	std::array<complex16_t, fft_size_max> segment_;
+	std::array<complex16_t, fft_size_max> bins_;
+	std::array<float, fft_size_max> power_;
+	size_t fft_size_ { 0 };
+	Trace trace_ { Trace::Average };
+	bool windowed_ { true };
+	float power_scale_ { 1.0f };
+	size_t segments_ { 0 };
+	bool held_ { false };
+};
+
+#endif/*__SPECTRUM_AVERAGER_H__*/
@@ -21,16 +21,14 @@
 
 #include "spectrum_collector.hpp"
 
-#include "dsp_fft.hpp"
-
 #include "utility.hpp"
 #include "event_m4.hpp"
 #include "portapack_shared_memory.hpp"
 
-#include "event_m4.hpp"
-
 #include <algorithm>
 
+constexpr size_t SpectrumCollector::fft_size_max;
+
 void SpectrumCollector::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
@@ -47,14 +45,30 @@ void SpectrumCollector::on_message(const Message* const message) {
 }
 
 void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message) {
-	if( message.mode == SpectrumStreamingConfigMessage::Mode::Running ) {
+	switch(message.mode) {
+	case SpectrumStreamingConfigMessage::Mode::Running:
+		window = message.window;
+		trace = message.trace;
+		sweeping = false;
 		start();
-	} else {
+		break;
+
+	case SpectrumStreamingConfigMessage::Mode::Sweeping:
+		/* A hold would mix up the steps. */
+		window = message.window;
+		trace = SpectrumAverager::Trace::Average;
+		sweeping = true;
+		start();
+		break;
+
+	default:
 		stop();
+		break;
 	}
 }
 
 void SpectrumCollector::start() {
+	reset();
 	streaming = true;
 	ChannelSpectrumConfigMessage message { &fifo };
 	shared_memory.application_queue.push(message);
@@ -65,10 +79,45 @@ void SpectrumCollector::stop() {
 	fifo.reset_in();
 }
 
+/* Event loop side: drop whatever the ring holds, and start the averages
+ * and holds over.
+ */
+void SpectrumCollector::reset() {
+	if( prewindowed_gain > 0.0f ) {
+		averager.configure_prewindowed(channel_spectrum_size, prewindowed_gain, trace);
+	} else {
+		averager.configure(channel_spectrum_size, window, trace);
+	}
+	ring_out = ring_in;
+	ring_restart_pending = false;
+	sweep_pending = false;
+}
+
 void SpectrumCollector::set_decimation_factor(
-	const size_t decimation_factor
+	const size_t new_decimation_factor
+) {
+	decimation_factor = std::max(new_decimation_factor, size_t(1));
+	decimation_phase = 0;
+}
+
+void SpectrumCollector::set_fft_size(
+	const size_t fft_size
 ) {
-	channel_spectrum_decimator.set_factor(decimation_factor);
+	channel_spectrum_size = std::min(fft_size, fft_size_max);
+	reset();
+}
+
+void SpectrumCollector::set_segment_overlap(const bool overlap) {
+	segment_overlap = overlap;
+}
+
+void SpectrumCollector::set_prewindowed(const float coherent_gain) {
+	prewindowed_gain = coherent_gain;
+	reset();
+}
+
+size_t SpectrumCollector::segment_hop() const {
+	return segment_overlap ? (channel_spectrum_size / 2) : channel_spectrum_size;
 }
 
 /* TODO: Refactor to register task with idle thread?
@@ -84,47 +133,140 @@ void SpectrumCollector::feed(
 	// Called from baseband processing thread.
 	channel_filter_pass_frequency = filter_pass_frequency;
 	channel_filter_stop_frequency = filter_stop_frequency;
+	channel_spectrum_sampling_rate = channel.sampling_rate / decimation_factor;
 
-	channel_spectrum_decimator.feed(
-		channel,
-		[this](const buffer_c16_t& data) {
-			this->post_message(data);
+	if( !streaming ) {
+		return;
+	}
+
+	const size_t hop = segment_hop();
+	uint32_t in = ring_in;
+	const uint32_t in_start = in;
+
+	size_t i = decimation_phase;
+	for(; i<channel.count; i+=decimation_factor) {
+		/* Full: the event loop hasn't kept up. Drop samples until it has,
+		 * then have it resume from the first sample after the gap.
+		 */
+		if( (in - ring_out) >= ring_size ) {
+			ring_overrun = true;
+			continue;
+		}
+		if( ring_overrun ) {
+			ring_overrun = false;
+			ring_restart = in;
+			ring_restart_pending = true;
 		}
-	);
+		ring[in & ring_mask] = channel.p[i];
+		in++;
+	}
+	decimation_phase = i - channel.count;
+
+	ring_in = in;
+
+	/* Wake the event loop each time another hop's worth has arrived. */
+	if( (in / hop) != (in_start / hop) ) {
+		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+	}
+}
+
+bool SpectrumCollector::is_sweeping() const {
+	return streaming && sweeping;
 }
 
-void SpectrumCollector::post_message(const buffer_c16_t& data) {
+bool SpectrumCollector::has_room(const size_t count) const {
 	// Called from baseband processing thread.
-	if( streaming && !channel_spectrum_request_update ) {
-		fft_swap(data, channel_spectrum);
-		channel_spectrum_sampling_rate = data.sampling_rate;
-		channel_spectrum_request_update = true;
+	if( !streaming ) {
+		return false;
+	}
+	const size_t needed = (count + decimation_factor - 1) / decimation_factor;
+	return (ring_in - ring_out + needed) <= ring_size;
+}
+
+bool SpectrumCollector::sweep_ready() {
+	if( sweep_pending ) {
 		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+		return false;
 	}
+	return true;
+}
+
+void SpectrumCollector::sweep_begin(const uint32_t step, const size_t segments) {
+	/* The ring is empty: the event loop took all of the last step's
+	 * segments before it cleared sweep_pending.
+	 */
+	sweep_step = step;
+	sweep_segments = segments;
+	sweep_pending = true;
 }
 
 void SpectrumCollector::update() {
 	// Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
-	if( streaming && channel_spectrum_request_update ) {
-		/* Decimated buffer is full. Compute spectrum. */
-		fft_c_preswapped(channel_spectrum);
-
-		ChannelSpectrum spectrum;
-		spectrum.sampling_rate = channel_spectrum_sampling_rate;
-		spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
-		spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
-		for(size_t i=0; i<spectrum.db.size(); i++) {
-			// Three point Hamming window.
-			const auto corrected_sample = channel_spectrum[i] * 0.54f
-				+ (channel_spectrum[(i-1) & 0xff] + channel_spectrum[(i+1) & 0xff]) * -0.23f;
-			const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-			const float db = mag2_to_dbv_norm(mag2);
-			constexpr float mag_scale = 5.0f;
-			const unsigned int v = (db * mag_scale) + 255.0f;
-			spectrum.db[i] = std::max(0U, std::min(255U, v));
-		}
-		fifo.in(spectrum);
+	if( !streaming ) {
+		return;
+	}
+
+	if( sweeping ) {
+		update_sweep();
+		return;
 	}
 
-	channel_spectrum_request_update = false;
+	if( ring_restart_pending ) {
+		ring_out = ring_restart;
+		ring_restart_pending = false;
+	}
+
+	const size_t n = averager.fft_size();
+	const size_t hop = segment_hop();
+	uint32_t out = ring_out;
+	while( (ring_in - out) >= n ) {
+		averager.add(ring.data(), ring_mask, out & ring_mask);
+		out += hop;
+		ring_out = out;
+	}
+
+	/* One spectrum per display frame: the M0 empties the FIFO every frame,
+	 * so wait for that. Everything in between goes into the average.
+	 */
+	if( (averager.segments() > 0) && fifo.is_empty() ) {
+		publish(0);
+	}
+}
+
+/* Every step makes exactly one spectrum, and the M0 needs them all to fill
+ * in the panorama: a step waits for room in the FIFO rather than being
+ * dropped, and holds back the next step while it does.
+ */
+void SpectrumCollector::update_sweep() {
+	if( !sweep_pending ) {
+		return;
+	}
+
+	const size_t n = averager.fft_size();
+	const size_t hop = segment_hop();
+	uint32_t out = ring_out;
+	while( (averager.segments() < sweep_segments) && ((ring_in - out) >= n) ) {
+		averager.add(ring.data(), ring_mask, out & ring_mask);
+		out += hop;
+		ring_out = out;
+	}
+
+	if( (averager.segments() == sweep_segments) && !fifo.is_full() ) {
+		/* Whatever part of a segment is left over, the next step doesn't
+		 * want it.
+		 */
+		ring_out = ring_in;
+		publish(sweep_step);
+		sweep_pending = false;
+	}
+}
+
+void SpectrumCollector::publish(const uint32_t step) {
+	ChannelSpectrum spectrum;
+	spectrum.sampling_rate = channel_spectrum_sampling_rate;
+	spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
+	spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
+	spectrum.sweep_step = step;
+	averager.spectrum(spectrum);
+	fifo.in(spectrum);
 }
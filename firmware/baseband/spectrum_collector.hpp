@@ -25,50 +25,129 @@
 #include "dsp_types.hpp"
 #include "complex.hpp"
 
-#include "block_decimator.hpp"
+#include "spectrum_averager.hpp"
 
 #include <cstdint>
 #include <array>
 
 #include "message.hpp"
 
+/* Channel spectrum for the waterfall. The baseband thread feeds every
+ * channel sample into a ring; the event loop (on EVT_MASK_SPECTRUM) cuts
+ * the ring into segments overlapping by half and averages them Welch
+ * style, then hands the M0 one spectrum per display frame. Every sample
+ * counts towards a frame, rather than one block per frame.
+ */
 class SpectrumCollector {
 public:
-	constexpr SpectrumCollector(
-	) : channel_spectrum_decimator { 1 },
-		fifo { fifo_data, ChannelSpectrumConfigMessage::fifo_k }
+	static constexpr size_t fft_size_max = SpectrumAverager::fft_size_max;
+
+	SpectrumCollector(
+	) : fifo { fifo_data, ChannelSpectrumConfigMessage::fifo_k }
 	{
 	}
 
 	void on_message(const Message* const message);
 
+	/* Keep one channel sample in decimation_factor. */
 	void set_decimation_factor(const size_t decimation_factor);
 
+	/* fft_size: power of two, [4, fft_size_max]. Sizes above
+	 * ChannelSpectrum::bins_max are peak-reduced to that many bins.
+	 */
+	void set_fft_size(const size_t fft_size);
+
+	/* Segments overlap by half unless this is off. Feeds that aren't one
+	 * continuous stream (WidebandSpectrum's presummed blocks) turn it off.
+	 */
+	void set_segment_overlap(const bool overlap);
+
+	/* For feeds that window their own samples: no window is applied to the
+	 * segments, and coherent_gain is that of the feed's window, to keep the
+	 * calibration. Zero goes back to the streaming configuration's window.
+	 */
+	void set_prewindowed(const float coherent_gain);
+
 	void feed(
 		const buffer_c16_t& channel,
 		const uint32_t filter_pass_frequency,
 		const uint32_t filter_stop_frequency
 	);
 
+	/* Whether feed() would take count more (undecimated) samples without
+	 * dropping any: the event loop has caught up enough. False while not
+	 * streaming, so a feed that's expensive to produce can be skipped.
+	 */
+	bool has_room(const size_t count) const;
+
+	/* Sweeping, baseband thread side. The segments of one step are averaged
+	 * into one spectrum, tagged with the step, and nothing else is fed until
+	 * that spectrum is in the FIFO. A step's segments have to fit the ring
+	 * together (two at fft_size_max). sweep_ready() says whether the last
+	 * step's spectrum is out of the way; while it isn't, it keeps the event
+	 * loop coming back to finish it.
+	 */
+	bool is_sweeping() const;
+	bool sweep_ready();
+	void sweep_begin(const uint32_t step, const size_t segments);
+
 private:
-	BlockDecimator<complex16_t, 256> channel_spectrum_decimator;
+	/* Room for the segment being worked on, plus as much again of backlog
+	 * while the event loop is busy.
+	 */
+	static constexpr size_t ring_size = fft_size_max * 2;
+	static constexpr size_t ring_mask = ring_size - 1;
+
 	ChannelSpectrumFIFO fifo;
 	ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k];
 
-	volatile bool channel_spectrum_request_update { false };
+	SpectrumAverager averager;
+	SpectrumAverager::Window window { SpectrumAverager::Window::Hann };
+	SpectrumAverager::Trace trace { SpectrumAverager::Trace::Average };
+
 	bool streaming { false };
-	std::array<std::complex<float>, 256> channel_spectrum;
+	bool sweeping { false };
+	size_t channel_spectrum_size { 256 };
+	bool segment_overlap { true };
+	float prewindowed_gain { 0.0f };
 	uint32_t channel_spectrum_sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
 
-	void post_message(const buffer_c16_t& data);
+	/* Baseband thread side. */
+	size_t decimation_factor { 1 };
+	size_t decimation_phase { 0 };
+	bool ring_overrun { false };
+
+	/* Samples written to the ring, by the baseband thread, and the start of
+	 * the next segment, by the event loop. Free-running; the ring index is
+	 * the low bits. After an overrun the baseband thread posts where the
+	 * samples pick up again, and the event loop starts over from there.
+	 */
+	volatile uint32_t ring_in { 0 };
+	volatile uint32_t ring_out { 0 };
+	volatile uint32_t ring_restart { 0 };
+	volatile bool ring_restart_pending { false };
+
+	/* Set by the baseband thread as a step's segments start, cleared by the
+	 * event loop once their spectrum is in the FIFO.
+	 */
+	volatile bool sweep_pending { false };
+	volatile uint32_t sweep_step { 0 };
+	volatile size_t sweep_segments { 0 };
+
+	std::array<complex16_t, ring_size> ring;
 
 	void set_state(const SpectrumStreamingConfigMessage& message);
 	void start();
 	void stop();
+	void reset();
+
+	size_t segment_hop() const;
 
 	void update();
+	void update_sweep();
+	void publish(const uint32_t step);
 };
 
 #endif/*__SPECTRUM_COLLECTOR_H__*/
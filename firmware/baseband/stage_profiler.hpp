@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __STAGE_PROFILER_H__
+#define __STAGE_PROFILER_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include <hal.h>
+
+/* Lap timer for the stages of a processor's pipeline. start() at the top of
+ * execute(), lap("name") after each stage: each lap is charged the cycles
+ * since the previous one. Laps are identified by their order, so a
+ * processor must lap the same stages in the same order every buffer. The
+ * cost is one cycle counter read and a few adds per stage.
+ */
+class StageProfiler {
+public:
+	void start() {
+		stage = 0;
+		last = halGetCounterValue();
+	}
+
+	void lap(const char* const name) {
+		const halrtcnt_t now = halGetCounterValue();
+		if( stage < stages.size() ) {
+			stages[stage].add(name, now - last);
+			stage++;
+		}
+		last = now;
+	}
+
+	template<typename Callback>
+	void feed(const buffer_c8_t& buffer, Callback callback) {
+		stage_count = std::max(stage_count, stage);
+		buffers++;
+		samples += buffer.count;
+
+		const size_t samples_per_update = buffer.sampling_rate * update_interval;
+		if( samples >= samples_per_update ) {
+			callback(capture_statistics());
+			samples = 0;
+		}
+	}
+
+private:
+	struct Stage {
+		const char* name { nullptr };
+		uint32_t min { UINT32_MAX };
+		uint32_t max { 0 };
+		uint32_t sum { 0 };
+		uint32_t count { 0 };
+
+		void add(const char* const stage_name, const uint32_t cycles) {
+			name = stage_name;
+			min = std::min(min, cycles);
+			max = std::max(max, cycles);
+			sum += cycles;
+			count++;
+		}
+	};
+
+	static constexpr float update_interval { 1.0f };
+
+	std::array<Stage, StageStatistics::stages_max> stages { };
+	size_t stage { 0 };
+	size_t stage_count { 0 };
+	halrtcnt_t last { 0 };
+	uint32_t buffers { 0 };
+	size_t samples { 0 };
+
+	StageStatistics capture_statistics() {
+		StageStatistics statistics;
+		statistics.stage_count = stage_count;
+		statistics.buffers = buffers;
+		for(size_t i=0; i<stage_count; i++) {
+			auto& s = stages[i];
+			auto& out = statistics.stages[i];
+			if( s.name ) {
+				strncpy(out.name, s.name, StageStatistics::name_length_max);
+			}
+			out.min = s.count ? s.min : 0;
+			out.avg = s.count ? (s.sum / s.count) : 0;
+			out.max = s.max;
+			s = Stage { };
+		}
+		stage_count = 0;
+		buffers = 0;
+		return statistics;
+	}
+};
+
+#endif/*__STAGE_PROFILER_H__*/
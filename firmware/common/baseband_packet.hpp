@@ -24,11 +24,15 @@
 
 #include "baseband.hpp"
 
+#include <cstdint>
 #include <cstddef>
-#include <bitset>
+#include <array>
 
 namespace baseband {
 
+/* Symbols are packed MSB-first into 32-bit words, so a field of up to 32
+ * bits comes out of at most two words with a couple of shifts.
+ */
 class Packet {
 public:
 	void set_timestamp(const Timestamp& value) {
@@ -41,12 +45,39 @@ public:
 
 	void add(const bool symbol) {
 		if( count < capacity() ) {
-			data[count++] = symbol;
+			auto& word = data[count >> 5];
+			const uint32_t bit = 0x80000000U >> (count & 31);
+			// Starting a word: drop whatever an earlier packet left there.
+			word = ((count & 31) ? word : 0) | (symbol ? bit : 0);
+			count++;
 		}
 	}
 
 	uint_fast8_t operator[](const size_t index) const {
-		return (index < size()) ? data[index] : 0;
+		return (index < size()) ? ((data[index >> 5] >> (31 - (index & 31))) & 1) : 0;
+	}
+
+	/* "length" (up to 32) symbols from "index" on, the first in the MSB of
+	 * the field. Symbols past the end read as zero.
+	 */
+	uint32_t read(const size_t index, const size_t length) const {
+		if( (length == 0) || (index >= size()) ) {
+			return 0;
+		}
+
+		const size_t word = index >> 5;
+		const size_t offset = index & 31;
+		uint32_t value = data[word] << offset;
+		if( (offset != 0) && ((word + 1) < data.size()) ) {
+			value |= data[word + 1] >> (32 - offset);
+		}
+
+		const size_t valid = size() - index;
+		if( valid < 32 ) {
+			value &= ~(0xffffffffU >> valid);
+		}
+
+		return value >> (32 - length);
 	}
 
 	size_t size() const {
@@ -54,7 +85,7 @@ public:
 	}
 
 	size_t capacity() const {
-		return data.size();
+		return data.size() * 32;
 	}
 
 	void clear() {
@@ -62,7 +93,7 @@ public:
 	}
 
 private:
-	std::bitset<1408> data;
+	std::array<uint32_t, 1408 / 32> data { };
 	Timestamp timestamp_ { };
 	size_t count { 0 };
 };
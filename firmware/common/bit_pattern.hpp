@@ -24,6 +24,8 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
+#include <type_traits>
 
 class BitHistory {
 public:
@@ -39,6 +41,18 @@ private:
 	uint64_t history { 0 };
 };
 
+/* True if x has no more than "limit" bits set. Clearing the lowest set bit
+ * "limit" times must leave nothing. For the small limits preambles use,
+ * that's cheaper than counting all 64 bits, which is a library call on the
+ * Cortex-M.
+ */
+inline bool bit_count_at_most(uint64_t x, size_t limit) {
+	for(; (limit > 0) && (x != 0); limit--) {
+		x &= x - 1;
+	}
+	return x == 0;
+}
+
 class BitPattern {
 public:
 	constexpr BitPattern(
@@ -59,9 +73,17 @@ public:
 	}
 
 	bool operator()(const BitHistory& history, const size_t) const {
-		const auto delta_bits = (history.value() ^ code_) & mask_;
-		const size_t count = __builtin_popcountll(delta_bits);
-		return (count <= maximum_hanning_distance_);
+		return matches(history.value());
+	}
+
+	bool matches(const uint64_t history) const {
+		return matches(history, mask_);
+	}
+
+	/* As above, comparing only the bits in "window". */
+	bool matches(const uint64_t history, const uint64_t window) const {
+		const auto delta_bits = (history ^ code_) & mask_ & window;
+		return bit_count_at_most(delta_bits, maximum_hanning_distance_);
 	}
 
 private:
@@ -70,4 +92,55 @@ private:
 	size_t maximum_hanning_distance_;
 };
 
+/* Several patterns, each with its own length and tolerance, tested against
+ * one bit history. Bit n of the result is set if pattern n matched.
+ *
+ * A table indexed by the eight most recent bits says which patterns are
+ * still within tolerance there, and only those get the full test. On noise,
+ * a pattern allowed one error gets past the table about one time in 28, so
+ * the cost per bit hardly grows with the number of patterns.
+ */
+template<size_t N>
+class BitPatternSet {
+	static_assert(N <= 32, "BitPatternSet reports matches in a 32-bit mask");
+
+	using Mask = typename std::conditional<(N <= 8), uint8_t,
+		typename std::conditional<(N <= 16), uint16_t, uint32_t>::type
+	>::type;
+
+public:
+	BitPatternSet(
+		const std::array<BitPattern, N>& patterns
+	) : patterns_ { patterns }
+	{
+		for(size_t b=0; b<candidates_.size(); b++) {
+			Mask candidates = 0;
+			for(size_t i=0; i<N; i++) {
+				if( patterns_[i].matches(b, 0xff) ) {
+					candidates |= static_cast<Mask>(1U << i);
+				}
+			}
+			candidates_[b] = candidates;
+		}
+	}
+
+	uint32_t operator()(const BitHistory& history) const {
+		const auto value = history.value();
+		uint32_t candidates = candidates_[value & 0xff];
+		uint32_t result = 0;
+		while( candidates ) {
+			const size_t i = __builtin_ctz(candidates);
+			candidates &= candidates - 1;
+			if( patterns_[i].matches(value) ) {
+				result |= 1U << i;
+			}
+		}
+		return result;
+	}
+
+private:
+	const std::array<BitPattern, N> patterns_;
+	std::array<Mask, 256> candidates_;
+};
+
 #endif/*__BIT_PATTERN_H__*/
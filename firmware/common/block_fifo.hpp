@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BLOCK_FIFO_H__
+#define __BLOCK_FIFO_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include <hal.h>
+
+/* Ring of equal-sized blocks for bulk streams from one core to the other.
+ * One producer fills blocks a piece at a time, one consumer takes whole
+ * blocks, by pointer, straight out of the ring. With blocks a multiple of
+ * the SD card sector size, the consumer can hand each block to the card as
+ * a single multi-sector write, without copying it first.
+ *
+ * While the consumer holds the oldest block, the producer keeps filling
+ * the others. When there's no free block, the producer drops data and
+ * counts it.
+ */
+
+class BlockFIFO {
+public:
+	constexpr BlockFIFO(
+		uint8_t* const data,
+		const size_t block_size,
+		const size_t block_count_k
+	) : _data { data },
+		_block_size { block_size },
+		_block_count { 1U << block_count_k },
+		_in { 0 },
+		_out { 0 },
+		_fill { 0 },
+		_dropped { 0 }
+	{
+	}
+
+	void reset() {
+		_in = _out = 0;
+		_fill = 0;
+		_dropped = 0;
+	}
+
+	size_t block_size() const {
+		return _block_size;
+	}
+
+	/* Producer */
+
+	/* Returns the number of bytes accepted, the rest were dropped. */
+	size_t write(const void* const buf, const size_t len) {
+		auto src = static_cast<const uint8_t*>(buf);
+		size_t remaining = len;
+
+		while( remaining > 0 ) {
+			if( (_in - _out) == _block_count ) {
+				_dropped += remaining;
+				break;
+			}
+
+			const size_t n = std::min(remaining, _block_size - _fill);
+			memcpy(&block(_in)[_fill], src, n);
+			src += n;
+			remaining -= n;
+
+			_fill += n;
+			if( _fill == _block_size ) {
+				smp_wmb();
+				_in += 1;
+				_fill = 0;
+			}
+		}
+
+		return len - remaining;
+	}
+
+	/* Bytes the producer has had to throw away since reset(). */
+	uint32_t dropped() const {
+		return _dropped;
+	}
+
+	/* Consumer */
+
+	/* Oldest full block, or nullptr if there isn't one. The block stays put
+	 * until release_block().
+	 */
+	const uint8_t* peek_block() const {
+		if( _in == _out ) {
+			return nullptr;
+		}
+		return block(_out);
+	}
+
+	void release_block() {
+		smp_wmb();
+		_out += 1;
+	}
+
+private:
+	uint8_t* const _data;
+	const size_t _block_size;
+	const size_t _block_count;
+	size_t _in;
+	size_t _out;
+	size_t _fill;
+	uint32_t _dropped;
+
+	uint8_t* block(const size_t index) const {
+		return &_data[(index & (_block_count - 1)) * _block_size];
+	}
+
+	void smp_wmb() {
+		__DMB();
+	}
+};
+
+#endif/*__BLOCK_FIFO_H__*/
@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <limits>
 #include <array>
+#include <type_traits>
 
 /* Inspired by
  * http://www.barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
@@ -149,16 +150,279 @@ private:
 	}
 };
 
+namespace crc_detail {
+
+template<size_t... I> struct indices { };
+template<size_t N, size_t... I> struct make_indices : make_indices<N - 1, N - 1, I...> { };
+template<size_t... I> struct make_indices<0, I...> : indices<I...> { };
+
+constexpr uint32_t mask(const size_t width) {
+	return (width >= 32) ? 0xffffffffU : ((1U << width) - 1);
+}
+
+constexpr uint32_t reflect(const uint32_t x, const size_t bits) {
+	return (bits == 0) ? 0 : (((x & 1) << (bits - 1)) | reflect(x >> 1, bits - 1));
+}
+
+/* Shift "bits" zero bits through a register, MSB-first (normal) or
+ * LSB-first (reflected, with the polynomial reflected to match).
+ */
+constexpr uint32_t normal_shift(const uint32_t r, const uint32_t polynomial, const size_t width, const size_t bits) {
+	return (bits == 0) ? r : normal_shift(
+		((r >> (width - 1)) & 1) ? (((r << 1) ^ polynomial) & mask(width)) : ((r << 1) & mask(width)),
+		polynomial, width, bits - 1
+	);
+}
+
+constexpr uint32_t reflected_shift(const uint32_t r, const uint32_t polynomial, const size_t bits) {
+	return (bits == 0) ? r : reflected_shift((r & 1) ? ((r >> 1) ^ polynomial) : (r >> 1), polynomial, bits - 1);
+}
+
+/* Entry b of slice k: the register after byte b, then k zero bytes. */
+constexpr uint32_t normal_entry(const size_t k, const uint32_t b, const uint32_t polynomial, const size_t width) {
+	return (k == 0)
+		? normal_shift(b << (width - 8), polynomial, width, 8)
+		: normal_shift(normal_entry(k - 1, b, polynomial, width), polynomial, width, 8);
+}
+
+constexpr uint32_t reflected_entry(const size_t k, const uint32_t b, const uint32_t polynomial) {
+	return (k == 0)
+		? reflected_shift(b, polynomial, 8)
+		: reflected_shift(reflected_entry(k - 1, b, polynomial), polynomial, 8);
+}
+
+template<typename T, bool Reflected, size_t... I>
+constexpr std::array<T, sizeof...(I)> slice(const size_t k, const uint32_t polynomial, const size_t width, indices<I...>) {
+	return { { static_cast<T>(Reflected ? reflected_entry(k, I, polynomial) : normal_entry(k, I, polynomial, width))... } };
+}
+
+template<typename T, bool Reflected, size_t... K>
+constexpr std::array<std::array<T, 256>, sizeof...(K)> slices(const uint32_t polynomial, const size_t width, indices<K...>) {
+	return { { slice<T, Reflected>(K, polynomial, width, make_indices<256> { })... } };
+}
+
+/* Entry n: the register after shifting four zero bits through n, in the
+ * register's own bit order.
+ */
+template<typename T, bool Reflected, size_t... I>
+constexpr std::array<T, sizeof...(I)> nibbles(const uint32_t polynomial, const size_t width, indices<I...>) {
+	return { { static_cast<T>(Reflected ? reflected_shift(I, polynomial, 4) : normal_shift(I << (width - 4), polynomial, width, 4))... } };
+}
+
+template<size_t Width>
+using table_entry = typename std::conditional<(Width <= 8), uint8_t,
+	typename std::conditional<(Width <= 16), uint16_t, uint32_t>::type
+>::type;
+
+} /* namespace crc_detail */
+
+/* CRC<> with the polynomial fixed at compile time, so the lookup tables
+ * can be built by the compiler and live in flash: bytes go through a
+ * 256-entry table (Slices = 4 takes four bytes per step, through four
+ * tables), the bit APIs through a 16-entry table a nibble at a time.
+ * Gives the same checksums as the CRC<> of the same parameters.
+ *
+ * The register is kept in input bit order, so a reflected CRC never
+ * reflects bytes on the way in, only the initial remainder and (if RevIn
+ * and RevOut differ) the result.
+ */
+template<size_t Width, uint32_t TruncatedPolynomial, bool RevIn = false, bool RevOut = false, size_t Slices = 1>
+class TableCRC {
+	static_assert((Width >= 8) && (Width <= 32), "TableCRC handles widths of 8 to 32 bits");
+	static_assert((Slices == 1) || (Slices == 4), "TableCRC takes one or four bytes per step");
+
+public:
+	using value_type = uint32_t;
+
+	constexpr TableCRC(
+		const value_type initial_remainder = 0,
+		const value_type final_xor_value = 0
+	) : initial_remainder { initial_remainder },
+		final_xor_value { final_xor_value },
+		remainder { to_register(initial_remainder) }
+	{
+	}
+
+	value_type get_initial_remainder() const {
+		return initial_remainder;
+	}
+
+	void reset(value_type new_initial_remainder) {
+		remainder = to_register(new_initial_remainder);
+	}
+
+	void reset() {
+		remainder = to_register(initial_remainder);
+	}
+
+	void process_bit(bool bit) {
+		if( RevIn ) {
+			remainder ^= (bit ? 1U : 0U);
+			remainder = (remainder & 1) ? ((remainder >> 1) ^ polynomial()) : (remainder >> 1);
+		} else {
+			remainder ^= (bit ? top_bit() : 0U);
+			remainder = (remainder & top_bit()) ? (((remainder << 1) ^ polynomial()) & mask()) : ((remainder << 1) & mask());
+		}
+	}
+
+	void process_bits(value_type bits, size_t bit_count) {
+		for(; bit_count >= 4; bit_count -= 4) {
+			const auto nibble = (bits >> (bit_count - 4)) & 0xf;
+			process_nibble(RevIn ? reverse_nibble(nibble) : nibble);
+		}
+		for(; bit_count > 0; --bit_count) {
+			process_bit((bits >> (bit_count - 1)) & 1);
+		}
+	}
+
+	void process_bits_lsb_first(value_type bits, size_t bit_count) {
+		for(; bit_count >= 4; bit_count -= 4, bits >>= 4) {
+			const auto nibble = bits & 0xf;
+			process_nibble(RevIn ? nibble : reverse_nibble(nibble));
+		}
+		for(; bit_count > 0; --bit_count, bits >>= 1) {
+			process_bit(bits & 1);
+		}
+	}
+
+	void process_byte(const uint8_t byte) {
+		remainder = step(remainder, byte);
+	}
+
+	void process_bytes(const void* const data, const size_t length) {
+		const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
+		remainder = run(remainder, p, p + length, std::integral_constant<size_t, Slices> { });
+	}
+
+	template<size_t N>
+	void process_bytes(const std::array<uint8_t, N>& data) {
+		process_bytes(data.data(), data.size());
+	}
+
+	value_type checksum() const {
+		return ((RevIn != RevOut) ? crc_detail::reflect(remainder, Width) : remainder) ^ (final_xor_value & mask());
+	}
+
+private:
+	using entry_type = crc_detail::table_entry<Width>;
+
+	const value_type initial_remainder;
+	const value_type final_xor_value;
+	value_type remainder;
+
+	static constexpr value_type top_bit() {
+		return 1U << (Width - 1);
+	}
+
+	static constexpr value_type mask() {
+		return crc_detail::mask(Width);
+	}
+
+	static constexpr value_type polynomial() {
+		return RevIn ? crc_detail::reflect(TruncatedPolynomial & mask(), Width) : (TruncatedPolynomial & mask());
+	}
+
+	static constexpr value_type to_register(const value_type r) {
+		return RevIn ? crc_detail::reflect(r & mask(), Width) : (r & mask());
+	}
+
+	static value_type reverse_nibble(const value_type n) {
+		return ((n & 1) << 3) | ((n & 2) << 1) | ((n >> 1) & 2) | (n >> 3);
+	}
+
+	static const std::array<std::array<entry_type, 256>, Slices>& tables() {
+		static constexpr std::array<std::array<entry_type, 256>, Slices> t =
+			crc_detail::slices<entry_type, RevIn>(polynomial(), Width, crc_detail::make_indices<Slices> { });
+		return t;
+	}
+
+	static const std::array<entry_type, 16>& nibble_table() {
+		static constexpr std::array<entry_type, 16> t =
+			crc_detail::nibbles<entry_type, RevIn>(polynomial(), Width, crc_detail::make_indices<16> { });
+		return t;
+	}
+
+	void process_nibble(const value_type nibble) {
+		const auto& t = nibble_table();
+		if( RevIn ) {
+			remainder = (remainder >> 4) ^ t[(remainder ^ nibble) & 0xf];
+		} else {
+			remainder = ((remainder << 4) & mask()) ^ t[((remainder >> (Width - 4)) ^ nibble) & 0xf];
+		}
+	}
+
+	static value_type step(const value_type r, const uint8_t byte) {
+		const auto& t = tables()[0];
+		if( RevIn ) {
+			return (r >> 8) ^ t[(r ^ byte) & 0xff];
+		} else {
+			return ((r << 8) & mask()) ^ t[((r >> (Width - 8)) ^ byte) & 0xff];
+		}
+	}
+
+	static value_type run(value_type r, const uint8_t* p, const uint8_t* const end, std::integral_constant<size_t, 1>) {
+		for(; p<end; p++) {
+			r = step(r, *p);
+		}
+		return r;
+	}
+
+	/* The register only overlaps the first Width / 8 bytes of each four,
+	 * the rest go straight through their slice.
+	 */
+	static value_type run(value_type r, const uint8_t* p, const uint8_t* const end, std::integral_constant<size_t, 4>) {
+		const auto& t = tables();
+		for(; (end - p) >= 4; p += 4) {
+			if( RevIn ) {
+				const uint32_t x = r ^ (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24));
+				r = t[3][x & 0xff] ^ t[2][(x >> 8) & 0xff] ^ t[1][(x >> 16) & 0xff] ^ t[0][x >> 24];
+			} else {
+				const uint32_t x = (r << (32 - Width)) ^ ((static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+				r = t[3][x >> 24] ^ t[2][(x >> 16) & 0xff] ^ t[1][(x >> 8) & 0xff] ^ t[0][x & 0xff];
+			}
+		}
+		return run(r, p, end, std::integral_constant<size_t, 1> { });
+	}
+};
+
+/* CRC-32 of PNG, zlib's gzip and Ethernet: the same checksum as
+ * CRC<32, true, true> { 0x04c11db7, 0xffffffff, 0xffffffff }. Slicing by
+ * four, as it's run over whole image rows.
+ */
+class CRC32 : public TableCRC<32, 0x04c11db7, true, true, 4> {
+public:
+	constexpr CRC32(
+	) : TableCRC { 0xffffffff, 0xffffffff }
+	{
+	}
+};
+
 class Adler32 {
 public:
 	void feed(const uint8_t v) {
-		feed_one(v);
+		feed(&v, 1);
 	}
 
+	/* The sums are only reduced every nmax bytes, the most that can't
+	 * overflow 32 bits. The M0 has no divide instruction, so this saves a
+	 * library call per byte.
+	 */
 	void feed(const void* const data, const size_t n) {
-		const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
-		for(size_t i=0; i<n; i++) {
-			feed_one(p[i]);
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+		size_t remaining = n;
+		while( remaining > 0 ) {
+			size_t count = remaining;
+			if( count > nmax ) {
+				count = nmax;
+			}
+			remaining -= count;
+			for(size_t i=0; i<count; i++) {
+				a += p[i];
+				b += a;
+			}
+			p += count;
+			a %= mod;
+			b %= mod;
 		}
 	}
 
@@ -178,14 +442,10 @@ public:
 
 private:
 	static constexpr uint32_t mod = 65521;
+	static constexpr size_t nmax = 5552;
 
 	uint32_t a { 1 };
 	uint32_t b { 0 };
-
-	void feed_one(const uint8_t c) {
-		a = (a + c) % mod;
-		b = (b + a) % mod;
-	}
 };
 
 #endif/*__CRC_H__*/
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "deflate.hpp"
+
+#include <algorithm>
+
+namespace {
+
+/* RFC 1951 3.2.5: match lengths and distances, as a base plus extra bits. */
+constexpr std::array<uint16_t, 29> length_base { {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+} };
+
+constexpr std::array<uint8_t, 29> length_extra { {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+} };
+
+constexpr std::array<uint16_t, 30> distance_base { {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+} };
+
+constexpr std::array<uint8_t, 30> distance_extra { {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+} };
+
+/* Largest i with base[i] <= value. */
+template<size_t N>
+size_t code_index(const std::array<uint16_t, N>& base, const size_t value) {
+	size_t i = N - 1;
+	while( base[i] > value ) {
+		i--;
+	}
+	return i;
+}
+
+/* Huffman codes go out most significant bit first, everything else least
+ * significant bit first.
+ */
+uint32_t reverse_bits(uint32_t code, const size_t length) {
+	constexpr uint8_t nibble_reversed[16] = {
+		0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+		0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf,
+	};
+	uint32_t result = 0;
+	for(size_t i=0; i<length; i+=4) {
+		result = (result << 4) | nibble_reversed[code & 0xf];
+		code >>= 4;
+	}
+	return result >> ((4 - (length & 3)) & 3);
+}
+
+} /* namespace */
+
+constexpr size_t DeflateEncoder::output_size;
+constexpr size_t DeflateEncoder::window_size;
+constexpr size_t DeflateEncoder::match_min;
+constexpr size_t DeflateEncoder::match_max;
+constexpr size_t DeflateEncoder::hash_bits;
+
+DeflateEncoder::DeflateEncoder(
+	Sink sink
+) : sink { sink }
+{
+	put_byte(0x78);		// CMF: deflate, 32KiB window (or less).
+	put_byte(0x01);		// FLG: no dictionary, check bits.
+
+	put_bits(1, 1);		// BFINAL: the only block.
+	put_bits(1, 2);		// BTYPE: fixed Huffman codes.
+}
+
+void DeflateEncoder::write(const void* const data, const size_t length) {
+	const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
+	adler_32.feed(p, length);
+
+	for(size_t i=0; i<length; i++) {
+		window[in & (window_size - 1)] = p[i];
+		in++;
+
+		// Keep a full match's worth of look-ahead.
+		while( (in - pos) >= match_max ) {
+			encode_one();
+		}
+	}
+}
+
+void DeflateEncoder::finish() {
+	while( pos != in ) {
+		encode_one();
+	}
+	put_symbol(256);	// End of block.
+
+	put_bits(0, (8 - bit_count) & 7);
+	for(const auto b : adler_32.bytes()) {
+		put_byte(b);
+	}
+	flush_output();
+}
+
+void DeflateEncoder::encode_one() {
+	const size_t available = in - pos;
+
+	size_t length = 0;
+	size_t distance = 0;
+	if( available >= match_min ) {
+		const uint32_t key = (at(pos) << 16) | (at(pos + 1) << 8) | at(pos + 2);
+		const size_t h = (key * 2654435761U) >> (32 - hash_bits);
+		distance = (pos - head[h]) & 0xffff;
+		head[h] = pos & 0xffff;
+
+		/* The source of a match mustn't reach back past the oldest byte
+		 * still in the window. The hash may be stale or collide: only the
+		 * comparison decides whether there's a match.
+		 */
+		const size_t distance_max = window_size - available;
+		if( (distance > 0) && (distance <= distance_max) ) {
+			length = match_length(pos - distance, std::min(available, match_max));
+		}
+	}
+
+	if( length >= match_min ) {
+		put_match(length, distance);
+		pos += length;
+	} else {
+		put_literal(at(pos));
+		pos += 1;
+	}
+}
+
+size_t DeflateEncoder::match_length(const uint32_t candidate, const size_t length_max) const {
+	size_t length = 0;
+	while( (length < length_max) && (at(candidate + length) == at(pos + length)) ) {
+		length++;
+	}
+	return length;
+}
+
+void DeflateEncoder::put_literal(const uint8_t value) {
+	put_symbol(value);
+}
+
+void DeflateEncoder::put_match(const size_t length, const size_t distance) {
+	const auto l = code_index(length_base, length);
+	put_symbol(257 + l);
+	put_bits(length - length_base[l], length_extra[l]);
+
+	const auto d = code_index(distance_base, distance);
+	put_bits(reverse_bits(d, 5), 5);
+	put_bits(distance - distance_base[d], distance_extra[d]);
+}
+
+void DeflateEncoder::put_symbol(const size_t symbol) {
+	/* RFC 1951 3.2.6, the fixed literal/length code. */
+	if( symbol < 144 ) {
+		put_bits(reverse_bits(0x30 + symbol, 8), 8);
+	} else if( symbol < 256 ) {
+		put_bits(reverse_bits(0x190 + symbol - 144, 9), 9);
+	} else if( symbol < 280 ) {
+		put_bits(reverse_bits(symbol - 256, 7), 7);
+	} else {
+		put_bits(reverse_bits(0xc0 + symbol - 280, 8), 8);
+	}
+}
+
+void DeflateEncoder::put_bits(const uint32_t value, const size_t count) {
+	bit_buffer |= value << bit_count;
+	bit_count += count;
+	while( bit_count >= 8 ) {
+		put_byte(bit_buffer & 0xff);
+		bit_buffer >>= 8;
+		bit_count -= 8;
+	}
+}
+
+void DeflateEncoder::put_byte(const uint8_t value) {
+	output[output_count++] = value;
+	if( output_count == output.size() ) {
+		flush_output();
+	}
+}
+
+void DeflateEncoder::flush_output() {
+	if( output_count > 0 ) {
+		sink(output.data(), output_count);
+		output_count = 0;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DEFLATE_H__
+#define __DEFLATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <functional>
+
+#include "crc.hpp"
+
+/* Streaming zlib (RFC 1950) compressor, small enough for the M0: a single
+ * fixed-Huffman deflate (RFC 1951) block, with LZ77 matches found by one
+ * hash probe into a 2KiB window. That's plenty for screenshots, which are
+ * mostly flat colour and repeated rows once PNG-filtered.
+ *
+ * Input can be fed in pieces of any size. Compressed output goes to the
+ * sink in pieces of up to output_size bytes. RAM use is fixed, about 5KiB,
+ * however much data goes through.
+ */
+
+class DeflateEncoder {
+public:
+	static constexpr size_t output_size = 512;
+
+	using Sink = std::function<void(const uint8_t* const data, const size_t length)>;
+
+	explicit DeflateEncoder(Sink sink);
+
+	void write(const void* const data, const size_t length);
+
+	/* Ends the stream: everything written so far comes out of the sink. */
+	void finish();
+
+private:
+	static constexpr size_t window_size = 2048;
+	static constexpr size_t match_min = 3;
+	static constexpr size_t match_max = 258;
+	static constexpr size_t hash_bits = 10;
+
+	Sink sink;
+	Adler32 adler_32;
+
+	/* Ring of recent input. in and pos count bytes since the start: the ring
+	 * holds [in - window_size, in), and pos is the next byte to encode.
+	 */
+	std::array<uint8_t, window_size> window;
+	uint32_t in { 0 };
+	uint32_t pos { 0 };
+
+	/* Most recent position of each three-byte hash, low 16 bits. */
+	std::array<uint16_t, 1 << hash_bits> head { };
+
+	uint32_t bit_buffer { 0 };
+	size_t bit_count { 0 };
+	std::array<uint8_t, output_size> output;
+	size_t output_count { 0 };
+
+	uint8_t at(const uint32_t n) const {
+		return window[n & (window_size - 1)];
+	}
+
+	void encode_one();
+	size_t match_length(const uint32_t candidate, const size_t length_max) const;
+
+	void put_literal(const uint8_t value);
+	void put_match(const size_t length, const size_t distance);
+	void put_symbol(const size_t symbol);
+	void put_bits(const uint32_t value, const size_t count);
+	void put_byte(const uint8_t value);
+	void flush_output();
+};
+
+#endif/*__DEFLATE_H__*/
@@ -20,3 +20,190 @@
  */
 
 #include "dsp_fft.hpp"
+
+#include "utility.hpp"
+
+namespace {
+
+/* Quarter wave of sin() in Q15, at the resolution of the largest FFT:
+ * sine_q15[i] = sin(2 * pi * i / fft_q15_size_max), i = [0, N/4].
+ * Every twiddle of every supported FFT size is a lookup into this table.
+ */
+constexpr size_t sine_quarter = fft_q15_size_max / 4;
+
+constexpr double sine_series(const double x2, const double term, const double sum, const size_t n) {
+	return (n > 12) ? sum : sine_series(x2, -term * x2 / ((2 * n) * (2 * n + 1)), sum + term, n + 1);
+}
+
+constexpr double sine_of_index(const double x) {
+	return sine_series(x * x, x, 0.0, 1);
+}
+
+constexpr int16_t sine_q15_entry(const size_t i) {
+	return static_cast<int16_t>(sine_of_index(2.0 * 3.14159265358979323846 * i / fft_q15_size_max) * 32767.0 + 0.5);
+}
+
+template<size_t... I>
+constexpr std::array<int16_t, sizeof...(I)> make_sine_q15(index_sequence<I...>) {
+	return { { sine_q15_entry(I)... } };
+}
+
+constexpr std::array<int16_t, sine_quarter + 1> sine_q15 = make_sine_q15(make_index_sequence<sine_quarter + 1>::type { });
+
+static_assert(sine_q15_entry(sine_quarter) == 32767, "sine table generation broken");
+
+/* angle: [0, fft_q15_size_max) maps to [0, 2pi) */
+inline int32_t sin_q15(const size_t angle) {
+	const size_t quadrant = (angle / sine_quarter) & 3;
+	const size_t r = angle & (sine_quarter - 1);
+	const int32_t v = (quadrant & 1) ? sine_q15[sine_quarter - r] : sine_q15[r];
+	return (quadrant & 2) ? -v : v;
+}
+
+/* W^angle = exp(-j * 2pi * angle / fft_q15_size_max), packed imag:real */
+inline uint32_t twiddle_q15(const size_t angle) {
+	const int32_t c = sin_q15((angle + sine_quarter) & (fft_q15_size_max - 1));
+	const int32_t s = sin_q15(angle);
+	return __PKHBT(c, -s, 16);
+}
+
+inline complex32_t unpack(const uint32_t v) {
+	return { static_cast<int16_t>(v), static_cast<int16_t>(v >> 16) };
+}
+
+/* Complex multiply of a packed Q15 sample by a packed Q15 twiddle, rounded
+ * back to the sample's scale. Not saturated: |x * w| may exceed 16 bits.
+ */
+inline complex32_t mul_q15(const uint32_t x, const uint32_t w) {
+	return {
+		(__SMUSD(x, w) + (1 << 14)) >> 15,
+		(__SMUADX(x, w) + (1 << 14)) >> 15
+	};
+}
+
+/* One's-complement magnitude: its bit length is the number of bits a value
+ * needs as a signed quantity (less the sign bit). OR-ing these together gives
+ * the bit length of the largest value in the block.
+ */
+inline uint32_t peak_bits(const int32_t v) {
+	return v ^ (v >> 31);
+}
+
+inline uint32_t scale_sat_pack(const complex32_t v, const size_t shift, uint32_t& peak) {
+	const int32_t round = (1 << shift) >> 1;
+	const int32_t r = __SSAT((v.real() + round) >> shift, 16);
+	const int32_t i = __SSAT((v.imag() + round) >> shift, 16);
+	peak |= peak_bits(r) | peak_bits(i);
+	return __PKHBT(r, i, 16);
+}
+
+/* Scale-down needed before a stage that can grow values by up to
+ * 2^growth_bits, given the peak of the stage's input.
+ */
+inline size_t stage_shift(const uint32_t peak, const size_t growth_bits) {
+	const size_t bits = 32 - __CLZ(peak);
+	const size_t headroom = (bits < 15) ? (15 - bits) : 0;
+	return (growth_bits > headroom) ? (growth_bits - headroom) : 0;
+}
+
+/* Radix-4 DIT butterfly, as two merged radix-2 stages over bit-reversed input:
+ *	y0 = (x0 + t1) + (t2 + t3)	y2 = (x0 + t1) - (t2 + t3)
+ *	y1 = (x0 - t1) - j(t2 - t3)	y3 = (x0 - t1) + j(t2 - t3)
+ * where t1..t3 are the inputs already multiplied by their twiddles.
+ */
+inline void butterfly_radix4(
+	uint32_t* const d,
+	const size_t i0,
+	const size_t m,
+	const complex32_t x0,
+	const complex32_t t1,
+	const complex32_t t2,
+	const complex32_t t3,
+	const size_t shift,
+	uint32_t& peak
+) {
+	const complex32_t p { x0.real() + t1.real(), x0.imag() + t1.imag() };
+	const complex32_t q { x0.real() - t1.real(), x0.imag() - t1.imag() };
+	const complex32_t r { t2.real() + t3.real(), t2.imag() + t3.imag() };
+	const complex32_t s { t2.real() - t3.real(), t2.imag() - t3.imag() };
+
+	d[i0 + 0 * m] = scale_sat_pack({ p.real() + r.real(), p.imag() + r.imag() }, shift, peak);
+	d[i0 + 1 * m] = scale_sat_pack({ q.real() + s.imag(), q.imag() - s.real() }, shift, peak);
+	d[i0 + 2 * m] = scale_sat_pack({ p.real() - r.real(), p.imag() - r.imag() }, shift, peak);
+	d[i0 + 3 * m] = scale_sat_pack({ q.real() - s.imag(), q.imag() + s.real() }, shift, peak);
+}
+
+} /* namespace */
+
+size_t fft_q15(
+	const complex16_t* const src,
+	complex16_t* const dst,
+	const size_t n
+) {
+	const uint32_t* const s = reinterpret_cast<const uint32_t*>(src);
+	uint32_t* const d = reinterpret_cast<uint32_t*>(dst);
+
+	const size_t log2_n = 31 - __CLZ(n);
+	const size_t rev_shift = 32 - log2_n;
+
+	uint32_t peak = 0;
+	for(size_t i=0; i<n; i++) {
+		const auto x = unpack(s[i]);
+		peak |= peak_bits(x.real()) | peak_bits(x.imag());
+	}
+
+	/* First stage: twiddles are all 1, and the bit-reversal permutation happens
+	 * on the way in.
+	 */
+	size_t exponent = 0;
+	size_t m = 0;
+	if( log2_n & 1 ) {
+		const auto shift = stage_shift(peak, 1);
+		peak = 0;
+		for(size_t i=0; i<n; i+=2) {
+			const auto x0 = unpack(s[__RBIT(i + 0) >> rev_shift]);
+			const auto x1 = unpack(s[__RBIT(i + 1) >> rev_shift]);
+			d[i + 0] = scale_sat_pack({ x0.real() + x1.real(), x0.imag() + x1.imag() }, shift, peak);
+			d[i + 1] = scale_sat_pack({ x0.real() - x1.real(), x0.imag() - x1.imag() }, shift, peak);
+		}
+		exponent += shift;
+		m = 2;
+	} else {
+		const auto shift = stage_shift(peak, 2);
+		peak = 0;
+		for(size_t i=0; i<n; i+=4) {
+			const auto x0 = unpack(s[__RBIT(i + 0) >> rev_shift]);
+			const auto x1 = unpack(s[__RBIT(i + 1) >> rev_shift]);
+			const auto x2 = unpack(s[__RBIT(i + 2) >> rev_shift]);
+			const auto x3 = unpack(s[__RBIT(i + 3) >> rev_shift]);
+			butterfly_radix4(d, i, 1, x0, x1, x2, x3, shift, peak);
+		}
+		exponent += shift;
+		m = 4;
+	}
+
+	/* Remaining stages are radix-4, in place. For a butterfly at offset j in
+	 * a group of 4m, the twiddle is u = W(4m)^j, and the inputs at i0+m,
+	 * i0+2m, i0+3m are multiplied by u^2, u, u^3 respectively.
+	 */
+	for(; m<n; m*=4) {
+		const auto shift = stage_shift(peak, 3);
+		peak = 0;
+		const size_t stride = fft_q15_size_max / (4 * m);
+		for(size_t j=0; j<m; j++) {
+			const auto u1 = twiddle_q15(j * stride * 1);
+			const auto u2 = twiddle_q15(j * stride * 2);
+			const auto u3 = twiddle_q15(j * stride * 3);
+			for(size_t i0=j; i0<n; i0+=4*m) {
+				const auto x0 = unpack(d[i0]);
+				const auto t1 = mul_q15(d[i0 + 1 * m], u2);
+				const auto t2 = mul_q15(d[i0 + 2 * m], u1);
+				const auto t3 = mul_q15(d[i0 + 3 * m], u3);
+				butterfly_radix4(d, i0, m, x0, t1, t2, t3, shift, peak);
+			}
+		}
+		exponent += shift;
+	}
+
+	return exponent;
+}
@@ -134,4 +134,30 @@ void fft_c_preswapped(std::array<T, N>& data) {
 	}
 }
 
+/* Fixed-point (Q15) complex FFT, radix-4 with a radix-2 first stage for odd
+ * powers of two. Sizes from 4 to fft_q15_size_max points.
+ *
+ * Reads "src" in natural order (the bit-reversal permutation is folded into
+ * the first stage) and writes "dst" in natural order; src and dst must not
+ * overlap.
+ *
+ * Uses block floating point: each stage scales down only as far as needed
+ * to keep the next stage from overflowing. Returns the block exponent, so
+ * that the unscaled DFT is dst[k] * 2^exponent.
+ */
+constexpr size_t fft_q15_size_max = 2048;
+
+size_t fft_q15(
+	const complex16_t* const src,
+	complex16_t* const dst,
+	const size_t n
+);
+
+template<size_t N>
+size_t fft_q15(const buffer_c16_t src, std::array<complex16_t, N>& dst) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	static_assert((N >= 4) && (N <= fft_q15_size_max), "N out of supported range");
+	return fft_q15(src.p, dst.data(), N);
+}
+
 #endif/*__DSP_FFT_H__*/
@@ -50,16 +50,53 @@ public:
 	/* The BitRemap functor determines which bits are read from the source
 	 * packet. */
 	uint32_t read(const size_t start_bit, const size_t length) const {
+		return read(start_bit, length, bit_remap);
+	}
+
+private:
+	const T& data;
+	const BitRemap bit_remap { };
+
+	/* Without a remap, the source hands over the whole field (see
+	 * baseband::Packet::read()).
+	 */
+	uint32_t read(const size_t start_bit, const size_t length, const BitRemapNone&) const {
+		return data.read(start_bit, length);
+	}
+
+	/* Reverse the bits of each whole byte the field touches, and the field
+	 * comes out of those as if there were no remap. At most 39 bits: the
+	 * field, plus up to seven before it in its first byte.
+	 */
+	uint32_t read(const size_t start_bit, const size_t length, const BitRemapByteReverse&) const {
+		if( length == 0 ) {
+			return 0;
+		}
+
+		const size_t first_bit = start_bit & ~static_cast<size_t>(7);
+		const size_t skip = start_bit - first_bit;
+		uint32_t value = reverse_bits_in_bytes(data.read(first_bit, 32)) << skip;
+		if( (skip + length) > 32 ) {
+			value |= reverse_bits_in_bytes(data.read(first_bit + 32, 8)) >> (8 - skip);
+		}
+		return value >> (32 - length);
+	}
+
+	template<typename Remap>
+	uint32_t read(const size_t start_bit, const size_t length, const Remap& remap) const {
 		uint32_t value = 0;
 		for(size_t i=start_bit; i<(start_bit + length); i++) {
-			value = (value << 1) | data[bit_remap(i)];
+			value = (value << 1) | data[remap(i)];
 		}
 		return value;
 	}
 
-private:
-	const T& data;
-	const BitRemap bit_remap { };
+	static uint32_t reverse_bits_in_bytes(uint32_t x) {
+		x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+		x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+		x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+		return x;
+	}
 };
 
 #endif/*__FIELD_READER_H__*/
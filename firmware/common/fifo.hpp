@@ -68,6 +68,17 @@ public:
 		return _in == _out;
 	}
 
+	/* Free-running element counts, for telling whether the reader has got
+	 * past a given point yet.
+	 */
+	size_t in_index() const {
+		return _in;
+	}
+
+	size_t out_index() const {
+		return _out;
+	}
+
 	bool is_full() const {
 		return unused() == 0;
 	}
@@ -96,16 +107,35 @@ public:
 	}
 
 	size_t in_r(const void* const buf, const size_t len) {
-		if( (len + recsize()) > unused() ) {
+		const size_t n = in_r_deferred(buf, len, 0);
+		if( n == 0 ) {
 			return 0;
 		}
 
-		poke_n(len);
-		copy_in((const T*)buf, len, _in + recsize());
-		_in += len + recsize();
+		commit_in(n);
 		return len;
 	}
 
+	/* Writes a record "pending" elements beyond the input index, without
+	 * making it visible to the reader. Returns the elements it took up
+	 * (length prefix included), or 0 if it didn't fit. Records written this
+	 * way are published together by commit_in(), with a single index update.
+	 */
+	size_t in_r_deferred(const void* const buf, const size_t len, const size_t pending) {
+		if( (pending + len + recsize()) > unused() ) {
+			return 0;
+		}
+
+		poke_n(len, _in + pending);
+		copy_in((const T*)buf, len, _in + pending + recsize());
+		return len + recsize();
+	}
+
+	void commit_in(const size_t n) {
+		/* copy_in() has already ordered the record writes ahead of this. */
+		_in += n;
+	}
+
 	bool out(T& val) {
 		if( is_empty() ) {
 			return false;
@@ -184,10 +214,10 @@ private:
 		return l;
 	}
 
-	void poke_n(const size_t n) {
-		_data[_in & mask()] = n & 0xff;
+	void poke_n(const size_t n, const size_t off) {
+		_data[off & mask()] = n & 0xff;
 		if( recsize() > 1 ) {
-			_data[(_in + 1) & mask()] = (n >> 8) & 0xff;
+			_data[(off + 1) & mask()] = (n >> 8) & 0xff;
 		}
 	}
 
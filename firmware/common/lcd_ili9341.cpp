@@ -274,6 +274,7 @@ void ILI9341::fill_rectangle(ui::Rect r, const ui::Color c) {
 		lcd_start_ram_write(r_clipped);
 		size_t count = r_clipped.size.w * r_clipped.size.h;
 		io.lcd_write_pixels(c, count);
+		pixels_written_ += count;
 	}
 }
 
@@ -306,6 +307,7 @@ void ILI9341::draw_pixel(
 	if( screen_rect().contains(p) ) {
 		lcd_start_ram_write(p, { 1, 1 });
 		io.lcd_write_pixel(color);
+		pixels_written_ += 1;
 	}
 }
 
@@ -317,6 +319,7 @@ void ILI9341::draw_pixels(
 	/* TODO: Assert that rectangle width x height < count */
 	lcd_start_ram_write(r.pos, r.size);
 	io.lcd_write_pixels(colors, count);
+	pixels_written_ += count;
 }
 
 void ILI9341::read_pixels(
@@ -342,10 +345,8 @@ void ILI9341::draw_bitmap(
 	lcd_start_ram_write(p, size);
 
 	const size_t count = size.w * size.h;
-	for(size_t i=0; i<count; i++) {
-		const auto pixel = pixels[i >> 3] & (1U << (i & 0x7));
-		io.lcd_write_pixel(pixel ? foreground : background);
-	}
+	io.lcd_write_bitmap(pixels, count, foreground, background);
+	pixels_written_ += count;
 }
 
 void ILI9341::draw_glyph(
@@ -357,6 +358,36 @@ void ILI9341::draw_glyph(
 	draw_bitmap(p, glyph.size(), glyph.pixels(), foreground, background);
 }
 
+/* Shared by every string: the glyph cache is only worth having if it
+ * outlives a single draw.
+ */
+static ui::TextRun text_run;
+
+void ILI9341::draw_string(
+	ui::Point p,
+	const ui::Font& font,
+	const char* text,
+	size_t length,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	while( length > 0 ) {
+		const auto n = text_run.fit(font, length);
+		const ui::Size size { static_cast<int>(n * font.char_width()), font.line_height() };
+		lcd_start_ram_write(p, size);
+		text_run.render(font, text, n, foreground, background,
+			[this](const ui::Color* const pixels, const size_t count) {
+				io.lcd_write_pixels(pixels, count);
+				pixels_written_ += count;
+			}
+		);
+
+		p.x += size.w;
+		text += n;
+		length -= n;
+	}
+}
+
 void ILI9341::scroll_set_area(
 	const ui::Coord top_y,
 	const ui::Coord bottom_y
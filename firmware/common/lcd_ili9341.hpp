@@ -33,7 +33,8 @@ namespace lcd {
 class ILI9341 {
 public:
 	constexpr ILI9341(
-	) : scroll_state { 0, 0, 320, 0 }
+	) : scroll_state { 0, 0, 320, 0 },
+		pixels_written_ { 0 }
 	{
 	}
 
@@ -88,6 +89,18 @@ public:
 		const ui::Color background
 	);
 
+	/* A whole string in one window write per TextRun::fit() characters.
+	 * Same pixels as draw_glyph() for each character in turn.
+	 */
+	void draw_string(
+		ui::Point p,
+		const ui::Font& font,
+		const char* text,
+		size_t length,
+		const ui::Color foreground,
+		const ui::Color background
+	);
+
 	void scroll_set_area(const ui::Coord top_y, const ui::Coord bottom_y);
 	ui::Coord scroll_set_position(const ui::Coord position);
 	ui::Coord scroll(const int32_t delta);
@@ -98,6 +111,9 @@ public:
 	constexpr ui::Dim height() const { return 320; }
 	constexpr ui::Rect screen_rect() const { return { 0, 0, width(), height() }; }
 
+	/* Running count of pixels sent to the panel, for measuring paint cost. */
+	uint32_t pixels_written() const { return pixels_written_; }
+
 private:
 	struct scroll_t {
 		uint16_t top_area;
@@ -107,6 +123,7 @@ private:
 	};
 
 	scroll_t scroll_state;
+	uint32_t pixels_written_;
 
 	void draw_pixels(const ui::Rect r, const ui::Color* const colors, const size_t count);
 	void read_pixels(const ui::Rect r, ui::ColorRGB888* const colors, const size_t count);
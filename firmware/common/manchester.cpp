@@ -21,7 +21,7 @@
 
 #include "manchester.hpp"
 
-#include "string_format.hpp"
+#include <algorithm>
 
 ManchesterDecoder::DecodedSymbol ManchesterDecoder::operator[](const size_t index) const {
 	const size_t encoded_index = index * 2;
@@ -34,6 +34,51 @@ ManchesterDecoder::DecodedSymbol ManchesterDecoder::operator[](const size_t inde
 	}
 }
 
+/* Gathers the bits in the even positions of x into the low half, in
+ * order.
+ */
+static uint32_t unzip_even(uint32_t x) {
+	x &= 0x55555555;
+	x = (x | (x >> 1)) & 0x33333333;
+	x = (x | (x >> 2)) & 0x0f0f0f0f;
+	x = (x | (x >> 4)) & 0x00ff00ff;
+	x = (x | (x >> 8)) & 0x0000ffff;
+	return x;
+}
+
+ManchesterDecoder::DecodedSymbols ManchesterDecoder::symbols(const size_t index, const size_t count) const {
+	if( count == 0 ) {
+		return { 0, 0 };
+	}
+
+	/* Sixteen symbols per 32 encoded bits. The first bit of each pair is in
+	 * the odd position, the second in the even position below it.
+	 */
+	const size_t encoded_index = index * 2;
+	const uint32_t encoded[2] = {
+		packet.read(encoded_index +  0, 32),
+		packet.read(encoded_index + 32, 32),
+	};
+
+	uint32_t values = 0;
+	uint32_t errors = 0;
+	for(const auto e : encoded) {
+		values = (values << 16) | unzip_even(sense ? e : (e >> 1));
+		errors = (errors << 16) | unzip_even(~(e ^ (e >> 1)));
+	}
+
+	// Only pairs wholly inside the packet decode.
+	const size_t available = symbols_count();
+	const size_t valid = (index < available) ? (available - index) : 0;
+	if( valid < 32 ) {
+		const uint32_t valid_mask = ~(0xffffffffU >> valid);
+		values &= valid_mask;
+		errors |= ~valid_mask;
+	}
+
+	return { values >> (32 - count), errors >> (32 - count) };
+}
+
 size_t ManchesterDecoder::symbols_count() const {
 	return packet.size() / 2;
 }
@@ -45,25 +90,20 @@ ManchesterFormatted format_manchester(
 	const size_t payload_length_hex_characters = (payload_length_decoded + 3) / 4;
 	const size_t payload_length_symbols_rounded = payload_length_hex_characters * 4;
 
+	static constexpr char hex_digits[] = "0123456789abcdef";
+
 	std::string hex_data;
 	std::string hex_error;
 	hex_data.reserve(payload_length_hex_characters);
 	hex_error.reserve(payload_length_hex_characters);
 
-	uint_fast8_t data = 0;
-	uint_fast8_t error = 0;
-	for(size_t i=0; i<payload_length_symbols_rounded; i++) {
-		const auto symbol = decoder[i];
-
-		data <<= 1;
-		data |= symbol.value;
-
-		error <<= 1;
-		error |= symbol.error;
+	for(size_t i=0; i<payload_length_symbols_rounded; i+=32) {
+		const size_t count = std::min<size_t>(32, payload_length_symbols_rounded - i);
+		const auto decoded = decoder.symbols(i, count);
 
-		if( (i & 3) == 3 ) {
-			hex_data += to_string_hex(data & 0xf, 1);
-			hex_error += to_string_hex(error & 0xf, 1);
+		for(size_t n=count; n>0; n-=4) {
+			hex_data += hex_digits[(decoded.values >> (n - 4)) & 0xf];
+			hex_error += hex_digits[(decoded.errors >> (n - 4)) & 0xf];
 		}
 	}
 
@@ -24,7 +24,6 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <bitset>
 #include <string>
 
 #include "baseband_packet.hpp"
@@ -36,6 +35,11 @@ public:
 		uint_fast8_t error;
 	};
 
+	struct DecodedSymbols {
+		uint32_t values;
+		uint32_t errors;
+	};
+
 	constexpr ManchesterDecoder(
 		const baseband::Packet& packet,
 		const size_t sense = 0
@@ -46,6 +50,16 @@ public:
 
 	DecodedSymbol operator[](const size_t index) const;
 
+	/* Up to 32 symbols at a time, the first in the MSB of each field.
+	 * Symbols past the end decode as value 0, in error.
+	 */
+	DecodedSymbols symbols(const size_t index, const size_t count) const;
+
+	/* For FieldReader: symbol values only. */
+	uint32_t read(const size_t index, const size_t length) const {
+		return symbols(index, length).values;
+	}
+
 	size_t symbols_count() const;
 
 private:
@@ -32,6 +32,7 @@
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
 #include "fifo.hpp"
+#include "block_fifo.hpp"
 
 #include "utility.hpp"
 
@@ -60,6 +61,12 @@ public:
 		ChannelSpectrumConfig = 14,
 		SpectrumStreamingConfig = 15,
 		DisplaySleep = 16,
+		CaptureStreamingConfig = 17,
+		CaptureFIFO = 18,
+		StageStatistics = 19,
+		SpectrumSweepStep = 20,
+		SpectrumSweepCaptured = 21,
+		PaintStatistics = 22,
 		MAX
 	};
 
@@ -97,6 +104,14 @@ struct BasebandStatistics {
 	uint32_t rssi_ticks { 0 };
 	uint32_t baseband_ticks { 0 };
 	bool saturation { false };
+	uint32_t mode_switch_cycles { 0 };
+	uint32_t application_queue_depth_max { 0 };
+	uint32_t application_queue_dropped { 0 };
+	/* Receive deadline: see baseband::dma::Statistics. */
+	uint32_t dma_skipped { 0 };
+	uint32_t dma_overwritten { 0 };
+	int32_t dma_slack_min_cycles { 0 };
+	int32_t dma_slack_avg_cycles { 0 };
 };
 
 class BasebandStatisticsMessage : public Message {
@@ -136,6 +151,56 @@ public:
 	ChannelStatistics statistics;
 };
 
+/* Cost of each stage of the running processor's pipeline, per buffer, over
+ * the last report interval. Cycles on the device (nanoseconds on the host).
+ */
+struct StageStatistics {
+	static constexpr size_t stages_max = 8;
+	static constexpr size_t name_length_max = 11;
+
+	struct Stage {
+		char name[name_length_max + 1];
+		uint32_t min;
+		uint32_t avg;
+		uint32_t max;
+	};
+
+	size_t stage_count { 0 };
+	uint32_t buffers { 0 };
+	std::array<Stage, stages_max> stages { };
+};
+
+class StageStatisticsMessage : public Message {
+public:
+	constexpr StageStatisticsMessage(
+		const StageStatistics& statistics
+	) : Message { ID::StageStatistics },
+		statistics { statistics }
+	{
+	}
+
+	StageStatistics statistics;
+};
+
+/* Pixels sent to the LCD per display frame, over the last second. */
+struct PaintStatistics {
+	uint32_t frames { 0 };
+	uint32_t pixels { 0 };
+	uint32_t pixels_max { 0 };
+};
+
+class PaintStatisticsMessage : public Message {
+public:
+	constexpr PaintStatisticsMessage(
+		const PaintStatistics& statistics
+	) : Message { ID::PaintStatistics },
+		statistics { statistics }
+	{
+	}
+
+	PaintStatistics statistics;
+};
+
 class DisplayFrameSyncMessage : public Message {
 public:
 	constexpr DisplayFrameSyncMessage(
@@ -191,14 +256,25 @@ struct BasebandConfiguration {
 	int32_t mode;
 	uint32_t sampling_rate;
 	size_t decimation_factor;
+	/* Receive DMA ring geometry: samples per transfer (one buffer handed to
+	 * the processor) and transfers in the ring. Powers of two; the baseband
+	 * clamps them to what the ring storage and the processor allow. Small
+	 * transfers for latency, large ones to spread the per-buffer overhead.
+	 */
+	size_t transfer_samples;
+	size_t transfers;
 
 	constexpr BasebandConfiguration(
 		int32_t mode,
 		uint32_t sampling_rate,
-		size_t decimation_factor = 1
+		size_t decimation_factor = 1,
+		size_t transfer_samples = 2048,
+		size_t transfers = 4
 	) : mode { mode },
 		sampling_rate { sampling_rate },
-		decimation_factor { decimation_factor }
+		decimation_factor { decimation_factor },
+		transfer_samples { transfer_samples },
+		transfers { transfers }
 	{
 	}
 
@@ -225,23 +301,61 @@ public:
 	enum class Mode : uint32_t {
 		Stopped = 0,
 		Running = 1,
+		/* One spectrum per sweep step, as the M0 retunes from step to step
+		 * (see SpectrumSweepStepMessage).
+		 */
+		Sweeping = 2,
+	};
+
+	/* Time-domain window applied to each FFT segment. Hann is the general
+	 * purpose choice, Blackman-Harris keeps strong signals from masking
+	 * weak neighbours, flat-top reads tone amplitudes accurately.
+	 */
+	enum class Window : uint32_t {
+		Hann = 0,
+		BlackmanHarris = 1,
+		FlatTop = 2,
+	};
+
+	/* How the per-segment power spectra combine into each displayed frame:
+	 * the mean of the segments since the last frame, or per-bin maximum or
+	 * minimum held since streaming started.
+	 */
+	enum class Trace : uint32_t {
+		Average = 0,
+		MaxHold = 1,
+		MinHold = 2,
 	};
 
 	constexpr SpectrumStreamingConfigMessage(
-		Mode mode
+		Mode mode,
+		Window window = Window::Hann,
+		Trace trace = Trace::Average
 	) : Message { ID::SpectrumStreamingConfig },
-		mode { mode }
+		mode { mode },
+		window { window },
+		trace { trace }
 	{
 	}
 
 	Mode mode { Mode::Stopped };
+	Window window { Window::Hann };
+	Trace trace { Trace::Average };
 };
 
 struct ChannelSpectrum {
-	std::array<uint8_t, 256> db { { 0 } };
+	static constexpr size_t bins_max = 512;
+
+	/* First bin_count entries of db are valid. bin_count is a power of two,
+	 * bin 0 is DC, upper half of the bins are negative frequencies.
+	 */
+	std::array<uint8_t, bins_max> db { { 0 } };
+	uint32_t bin_count { 256 };
 	uint32_t sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
+	/* Sweeping: the step the spectrum was captured at. */
+	uint32_t sweep_step { 0 };
 };
 
 using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
@@ -260,6 +374,75 @@ public:
 	ChannelSpectrumFIFO* fifo { nullptr };
 };
 
+/* M0 to M4: the radio has been retuned for sweep step "step". Samples until
+ * settle_samples past this message come from the synthesizers settling, and
+ * are thrown away.
+ */
+class SpectrumSweepStepMessage : public Message {
+public:
+	constexpr SpectrumSweepStepMessage(
+		const uint32_t step,
+		const uint32_t settle_samples
+	) : Message { ID::SpectrumSweepStep },
+		step { step },
+		settle_samples { settle_samples }
+	{
+	}
+
+	uint32_t step;
+	uint32_t settle_samples;
+};
+
+/* M4 to M0: the samples for sweep step "step" are in. The radio can move on
+ * to the next step while the M4 works out this one's spectrum.
+ */
+class SpectrumSweepCapturedMessage : public Message {
+public:
+	constexpr SpectrumSweepCapturedMessage(
+		const uint32_t step
+	) : Message { ID::SpectrumSweepCaptured },
+		step { step }
+	{
+	}
+
+	uint32_t step;
+};
+
+class CaptureStreamingConfigMessage : public Message {
+public:
+	enum class Mode : uint32_t {
+		Stopped = 0,
+		Running = 1,
+	};
+
+	/* decimation_factor 1 streams the raw complex<int8_t> baseband,
+	 * 2 through 32 the complex<int16_t> ChannelDecimator output.
+	 */
+	constexpr CaptureStreamingConfigMessage(
+		Mode mode,
+		size_t decimation_factor = 1
+	) : Message { ID::CaptureStreamingConfig },
+		mode { mode },
+		decimation_factor { decimation_factor }
+	{
+	}
+
+	Mode mode { Mode::Stopped };
+	size_t decimation_factor { 1 };
+};
+
+class CaptureFIFOMessage : public Message {
+public:
+	constexpr CaptureFIFOMessage(
+		BlockFIFO* fifo
+	) : Message { ID::CaptureFIFO },
+		fifo { fifo }
+	{
+	}
+
+	BlockFIFO* fifo { nullptr };
+};
+
 class AISPacketMessage : public Message {
 public:
 	constexpr AISPacketMessage(
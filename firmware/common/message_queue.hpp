@@ -23,6 +23,8 @@
 #define __MESSAGE_QUEUE_H__
 
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 #include "message.hpp"
 #include "fifo.hpp"
@@ -32,12 +34,53 @@ using namespace lpc43xx;
 
 #include <ch.h>
 
+/* Records are published with a single index update once they're complete,
+ * so the consumer core never needs a lock. On the producing core:
+ *
+ * - Producers::Multiple: any thread may push. A mutex serializes the writers.
+ * - Producers::Single: exactly one thread ever pushes. No mutex at all; the
+ *   FIFO's memory barriers are the only synchronization.
+ *
+ * A batch (batch_begin() ... batch_end()) holds back the calling thread's
+ * pushes and publishes them together, with one index update and one
+ * inter-core event instead of one per message. Until then they're gathered
+ * in the batching thread's own Batch, without the lock, so other threads'
+ * pushes only ever wait for the copy into the queue.
+ */
 class MessageQueue {
 public:
+	enum class Producers {
+		Single,
+		Multiple,
+	};
+
+	/* Staging for one thread's batches. A push that doesn't fit publishes
+	 * what's gathered so far, early, and starts over.
+	 */
+	class Batch {
+	public:
+		Batch(
+			uint8_t* const data,
+			const size_t size
+		) : data { data },
+			size { size }
+		{
+		}
+
+	private:
+		friend class MessageQueue;
+
+		uint8_t* const data;
+		const size_t size;
+		size_t used { 0 };
+	};
+
 	MessageQueue(
 		uint8_t* const data,
-		size_t k
-	) : fifo { data, k }
+		size_t k,
+		const Producers producers = Producers::Multiple
+	) : fifo { data, k },
+		producers { producers }
 	{
 		chMtxInit(&mutex_write);
 	}
@@ -50,16 +93,37 @@ public:
 		return push(&message, sizeof(message));
 	}
 
+	/* Returns once the consumer has taken this message (not necessarily
+	 * finished handling it). Others pushed after it don't hold it up.
+	 */
 	template<typename T>
 	bool push_and_wait(const T& message) {
+		chDbgAssert(batch_thread != chThdSelf(), "MessageQueue::push_and_wait(), #1", "inside a batch");
 		const bool result = push(message);
 		if( result ) {
-			// TODO: More graceful method of waiting for empty? Maybe sleep for a bit?
-			while( !is_empty() );
+			const size_t end = fifo.in_index();
+			while( static_cast<int32_t>(end - fifo.out_index()) > 0 ) {
+				chThdSleepMilliseconds(1);
+			}
 		}
 		return result;
 	}
 
+	/* In a batch, push() only says whether the message was gathered. One
+	 * that doesn't fit in the queue when it's published counts as dropped().
+	 */
+	void batch_begin(Batch& batch) {
+		batch.used = 0;
+		batch_ = &batch;
+		batch_thread = chThdSelf();
+	}
+
+	void batch_end() {
+		batch_publish();
+		batch_thread = nullptr;
+		batch_ = nullptr;
+	}
+
 	Message* peek(std::array<uint8_t, Message::MAX_SIZE>& buf) {
 		Message* const p = reinterpret_cast<Message*>(buf.data());
 		return fifo.peek_r(buf.data(), buf.size()) ? p : nullptr;
@@ -82,22 +146,116 @@ public:
 		return fifo.is_empty();
 	}
 
+	/* Most bytes ever waiting in the queue (length prefixes included). */
+	size_t depth_max() const {
+		return depth_max_;
+	}
+
+	/* Messages that didn't fit, and were thrown away. */
+	uint32_t dropped() const {
+		return dropped_;
+	}
+
 private:
 	FIFO<uint8_t> fifo;
+	const Producers producers;
 	Mutex mutex_write;
+	Thread* batch_thread { nullptr };
+	Batch* batch_ { nullptr };
+	size_t depth_max_ { 0 };
+	uint32_t dropped_ { 0 };
 
 	bool push(const void* const buf, const size_t len) {
-		chMtxLock(&mutex_write);
-		const auto result = fifo.in_r(buf, len);
-		chMtxUnlock();
+		if( batch_thread == chThdSelf() ) {
+			return push_batched(buf, len);
+		}
+		return push_now(buf, len);
+	}
 
-		const bool success = (result == len);
-		if( success ) {
+	bool push_now(const void* const buf, const size_t len) {
+		lock();
+		const auto n = fifo.in_r_deferred(buf, len, 0);
+		if( n ) {
+			fifo.commit_in(n);
+			update_depth_max();
+		} else {
+			dropped_++;
+		}
+		unlock();
+
+		if( n ) {
 			signal();
 		}
-		return success;
+		return (n != 0);
 	}
 
+	bool push_batched(const void* const buf, const size_t len) {
+		auto& batch = *batch_;
+		const uint16_t length = len;
+		if( (batch.used + sizeof(length) + len) > batch.size ) {
+			batch_publish();
+			if( (sizeof(length) + len) > batch.size ) {
+				return push_now(buf, len);
+			}
+		}
+
+		memcpy(&batch.data[batch.used], &length, sizeof(length));
+		memcpy(&batch.data[batch.used + sizeof(length)], buf, len);
+		batch.used += sizeof(length) + len;
+		return true;
+	}
+
+	/* Everything gathered goes into the queue under one lock, and becomes
+	 * visible to the consumer all at once.
+	 */
+	void batch_publish() {
+		auto& batch = *batch_;
+		if( batch.used == 0 ) {
+			return;
+		}
+
+		lock();
+		size_t pending = 0;
+		for(size_t offset=0; offset<batch.used;) {
+			uint16_t length;
+			memcpy(&length, &batch.data[offset], sizeof(length));
+			offset += sizeof(length);
+
+			const auto n = fifo.in_r_deferred(&batch.data[offset], length, pending);
+			if( n ) {
+				pending += n;
+			} else {
+				dropped_++;
+			}
+			offset += length;
+		}
+		if( pending ) {
+			fifo.commit_in(pending);
+			update_depth_max();
+		}
+		unlock();
+
+		batch.used = 0;
+		if( pending ) {
+			signal();
+		}
+	}
+
+	void update_depth_max() {
+		depth_max_ = std::max(depth_max_, fifo.len());
+	}
+
+	void lock() {
+		if( producers == Producers::Multiple ) {
+			chMtxLock(&mutex_write);
+		}
+	}
+
+	void unlock() {
+		if( producers == Producers::Multiple ) {
+			chMtxUnlock();
+		}
+	}
 
 #if defined(LPC43XX_M0)
 	void signal() {
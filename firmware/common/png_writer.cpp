@@ -21,6 +21,14 @@
 
 #include "png_writer.hpp"
 
+#include <cstdlib>
+#include <algorithm>
+
+/* A third of a scanline, the most that was ever written at once before the
+ * output was compressed.
+ */
+static constexpr size_t max_write_bytes = 240;
+
 static constexpr std::array<uint8_t, 8> png_file_header { {
 	0x89, 0x50, 0x4e, 0x47,
 	0x0d, 0x0a, 0x1a, 0x0a,
@@ -51,52 +59,63 @@ static constexpr std::array<uint8_t, 12> png_iend { {
 
 PNGWriter::PNGWriter(
 	const std::string& filename
-)
+) : deflate {
+		[this](const uint8_t* const data, const size_t length) {
+			this->write_idat(data, length);
+		}
+	}
 {
 	file.open(filename);
 	file.write(png_file_header);
 	file.write(png_ihdr_screen_capture);
-	
-	write_chunk_header(
-		2 + height * (5 + 1 + width * 3) + 4,
-		png_idat_chunk_type
-	);
-
-	constexpr std::array<uint8_t, 2> zlib_header { 0x78, 0x01 };	// Zlib CM, CINFO, FLG.
-	write_chunk_content(zlib_header);
 }
 
 PNGWriter::~PNGWriter() {
-	write_chunk_content(adler_32.bytes());
-	write_chunk_crc();
+	deflate.finish();
 
 	file.write(png_iend);
 }
 
 void PNGWriter::write_scanline(const std::array<ui::ColorRGB888, 240>& scanline) {
-	constexpr uint8_t scanline_filter_type = 0;
-	constexpr uint32_t deflate_block_length = 1 + sizeof(scanline);
-
-	const std::array<uint8_t, 6> deflate_and_scanline_header {
-		static_cast<uint8_t>((scanline_count == (height - 1)) ? 0x01 : 0x00),	// DEFLATE header bits, bfinal=0, btype=00
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff),			// Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff),			// Length MSB
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff) ^ 0xff,	// ~Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff) ^ 0xff,	// ~Length MSB
-		scanline_filter_type,
-	};
-	write_chunk_content(deflate_and_scanline_header);
-
-	adler_32.feed(scanline_filter_type);
-	adler_32.feed(scanline);
-
-	// Small writes to avoid some sort of large-transfer plus block
-	// boundary FatFs or SDC driver bug?
-	write_chunk_content(&scanline[  0], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[ 80], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[160], 80 * sizeof(ui::ColorRGB888));
+	const uint8_t* const row = reinterpret_cast<const uint8_t*>(scanline.data());
+
+	/* Pick a filter the usual way: whichever makes the bytes, as signed
+	 * differences, smallest overall. Flat colour comes out as runs of zero
+	 * with Sub, rows like the one above with Up; both compress to almost
+	 * nothing.
+	 */
+	uint32_t cost_none = 0;
+	uint32_t cost_sub = 0;
+	uint32_t cost_up = 0;
+	for(size_t i=0; i<scanline_bytes; i++) {
+		const uint8_t left = (i >= bytes_per_pixel) ? row[i - bytes_per_pixel] : 0;
+		cost_none += std::abs(static_cast<int8_t>(row[i]));
+		cost_sub += std::abs(static_cast<int8_t>(row[i] - left));
+		cost_up += std::abs(static_cast<int8_t>(row[i] - previous[i]));
+	}
+
+	uint8_t filter_type = 0;		// None
+	if( (cost_sub < cost_none) && (cost_sub <= cost_up) ) {
+		filter_type = 1;			// Sub
+	} else if( cost_up < cost_none ) {
+		filter_type = 2;			// Up
+	}
+
+	filtered[0] = filter_type;
+	for(size_t i=0; i<scanline_bytes; i++) {
+		const uint8_t left = (i >= bytes_per_pixel) ? row[i - bytes_per_pixel] : 0;
+		const uint8_t predictor = (filter_type == 1) ? left : (filter_type == 2) ? previous[i] : 0;
+		filtered[1 + i] = row[i] - predictor;
+	}
+	deflate.write(filtered.data(), filtered.size());
+
+	std::copy(row, row + scanline_bytes, previous.begin());
+}
 
-	scanline_count++;
+void PNGWriter::write_idat(const uint8_t* const data, const size_t length) {
+	write_chunk_header(length, png_idat_chunk_type);
+	write_chunk_content(data, length);
+	write_chunk_crc();
 }
 
 void PNGWriter::write_chunk_header(
@@ -109,7 +128,12 @@ void PNGWriter::write_chunk_header(
 }
 
 void PNGWriter::write_chunk_content(const void* const p, const size_t count) {
-	file.write(p, count);
+	// Small writes to avoid some sort of large-transfer plus block
+	// boundary FatFs or SDC driver bug?
+	const uint8_t* const bytes = static_cast<const uint8_t*>(p);
+	for(size_t offset=0; offset<count; offset+=max_write_bytes) {
+		file.write(&bytes[offset], std::min(count - offset, max_write_bytes));
+	}
 	crc.process_bytes(p, count);
 }
 
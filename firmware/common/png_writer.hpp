@@ -30,6 +30,7 @@
 #include "ui.hpp"
 #include "file.hpp"
 #include "crc.hpp"
+#include "deflate.hpp"
 
 class PNGWriter {
 public:
@@ -43,10 +44,20 @@ private:
 	static constexpr int width { 240 };
 	static constexpr int height { 320 };
 
+	static constexpr size_t bytes_per_pixel = 3;
+	static constexpr size_t scanline_bytes = width * bytes_per_pixel;
+
 	File file;
-	int scanline_count { 0 };
-	CRC<32, true, true> crc { 0x04c11db7, 0xffffffff, 0xffffffff };
-	Adler32 adler_32;
+	CRC32 crc;
+	/* Each piece of compressed output becomes an IDAT chunk of its own. */
+	DeflateEncoder deflate;
+
+	/* Previous scanline for the Up filter, zero above the first. */
+	std::array<uint8_t, scanline_bytes> previous { };
+	/* Filter type byte, then the filtered scanline. */
+	std::array<uint8_t, 1 + scanline_bytes> filtered;
+
+	void write_idat(const uint8_t* const data, const size_t length);
 
 	void write_chunk_header(const size_t length, const std::array<uint8_t, 4>& type);
 	void write_chunk_content(const void* const p, const size_t count);
@@ -140,15 +140,70 @@ public:
 		return lcd_read_data_frame_memory();
 	}
 
+	/* A pixel goes across the eight-bit bus as two bytes, latched by one
+	 * write strobe. When both bytes are the same (black, white) and already
+	 * on the bus, the strobe is all it takes: half the GPIO writes.
+	 */
 	void lcd_write_pixels(const ui::Color pixel, size_t n) {
-		while(n--) {
-			lcd_write_data_fast(pixel.v);
+		if( is_uniform(pixel) ) {
+			lcd_write_bus_byte(pixel.v);
+			while(n--) {
+				lcd_write_strobe();
+			}
+		} else {
+			while(n--) {
+				lcd_write_data_fast(pixel.v);
+			}
 		}
 	}
 
+	/* Same trick for a run of pixels: a uniform pixel needs its byte put on
+	 * the bus only if it isn't there already. Rendered text is mostly runs
+	 * of two such colours.
+	 */
 	void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
+		uint32_t bus = 0x100;	// Not a byte: nothing known to be on the bus.
 		for(size_t i=0; i<n; i++) {
-			lcd_write_pixel(pixels[i]);
+			const uint32_t v = pixels[i].v;
+			if( is_uniform(pixels[i]) ) {
+				if( (v & 0xff) != bus ) {
+					bus = v & 0xff;
+					lcd_write_bus_byte(bus);
+				}
+				lcd_write_strobe();
+			} else {
+				lcd_write_data_fast(v);
+				bus = v & 0xff;
+			}
+		}
+	}
+
+	/* One bit per pixel, least significant bit first. Text is almost always
+	 * drawn in two uniform colours, so put each byte on the bus only when
+	 * the colour changes.
+	 */
+	void lcd_write_bitmap(
+		const uint8_t* const bits,
+		const size_t count,
+		const ui::Color foreground,
+		const ui::Color background
+	) {
+		if( is_uniform(foreground) && is_uniform(background) ) {
+			uint32_t bus = background.v & 0xff;
+			lcd_write_bus_byte(bus);
+			for(size_t i=0; i<count; i++) {
+				const uint32_t byte = ((bits[i >> 3] >> (i & 7)) & 1) ? foreground.v : background.v;
+				if( (byte & 0xff) != bus ) {
+					bus = byte & 0xff;
+					lcd_write_bus_byte(bus);
+				}
+				lcd_write_strobe();
+			}
+		} else {
+			for(size_t i=0; i<count; i++) {
+				const bool set = (bits[i >> 3] >> (i & 7)) & 1;
+				lcd_write_data_fast(set ? foreground.v : background.v);
+			}
 		}
 	}
 
@@ -286,6 +341,27 @@ private:
 		addr(1);				/* Set up for data phase (most likely after a command) */
 	}
 
+	static constexpr bool is_uniform(const ui::Color pixel) {
+		return (pixel.v >> 8) == (pixel.v & 0xff);
+	}
+
+	void lcd_write_bus_byte(const uint32_t value) __attribute__((always_inline)) {
+		// NOTE: Assumes DIR=0 and ADDR=1 from command phase.
+		data_write_low(value & 0xff);
+		__asm__("nop");
+	}
+
+	void lcd_write_strobe() __attribute__((always_inline)) {
+		// NOTE: Assumes the byte for both halves of the pixel is on the bus.
+		lcd_wr_assert();		/* Latch high byte */
+		__asm__("nop");
+		__asm__("nop");
+		__asm__("nop");
+		__asm__("nop");
+		lcd_wr_deassert();		/* Complete write operation */
+		__asm__("nop");
+	}
+
 	void lcd_write_data_fast(const uint32_t value) __attribute__((always_inline)) {
 		// NOTE: Assumes and DIR=0 and ADDR=1 from command phase.
 		data_write_high(value);	/* Drive high byte */
@@ -49,9 +49,9 @@ Rect& Rect::operator+=(const Rect& p) {
 	if( !p.is_empty() ) {
 		const auto x1 = std::min(left(), p.left());
 		const auto y1 = std::min(top(), p.top());
-		pos = { x1, y1 };
 		const auto x2 = std::max(right(), p.right());
 		const auto y2 = std::max(bottom(), p.bottom());
+		pos = { x1, y1 };
 		size = { x2 - x1, y2 - y1 };
 	}
 	return *this;
@@ -26,8 +26,75 @@
 #include "portapack.hpp"
 using namespace portapack;
 
+#include <algorithm>
+
 namespace ui {
 
+/* DamageRegion **********************************************************/
+
+static bool touching(const Rect& a, const Rect& b) {
+	/* Overlapping, or sharing a whole edge: the bounding box wastes nothing. */
+	if( !a.intersect(b).is_empty() ) {
+		return true;
+	}
+	const auto a_b = Rect { a } += b;
+	return (a_b.width() * a_b.height()) == (a.width() * a.height() + b.width() * b.height());
+}
+
+static int growth(const Rect& into, const Rect& r) {
+	const auto merged = Rect { into } += r;
+	return merged.width() * merged.height() - into.width() * into.height();
+}
+
+void DamageRegion::add(Rect r) {
+	r = r.intersect(portapack::display.screen_rect());
+	if( r.is_empty() ) {
+		return;
+	}
+
+	/* Coalesce until nothing else touches the (growing) new rectangle. */
+	for(size_t i=0; i<count; ) {
+		if( touching(rects[i], r) ) {
+			r += rects[i];
+			remove(i);
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	if( count < rects_max ) {
+		rects[count++] = r;
+		return;
+	}
+
+	size_t best = 0;
+	for(size_t i=1; i<count; i++) {
+		if( growth(rects[i], r) < growth(rects[best], r) ) {
+			best = i;
+		}
+	}
+	r += rects[best];
+	remove(best);
+	add(r);
+}
+
+void DamageRegion::clear() {
+	count = 0;
+}
+
+bool DamageRegion::intersects(const Rect r) const {
+	return std::any_of(begin(), end(),
+		[&r](const Rect& d) { return !d.intersect(r).is_empty(); }
+	);
+}
+
+void DamageRegion::remove(const size_t index) {
+	rects[index] = rects[--count];
+}
+
+/* Painter ***************************************************************/
+
 Style Style::invert() const {
 	return {
 		.font = font,
@@ -36,34 +103,53 @@ Style Style::invert() const {
 	};
 }
 
+bool Painter::is_clipped(const Rect r) const {
+	return clip && !clip->intersects(r);
+}
+
 int Painter::draw_char(const Point p, const Style& style, const char c) {
 	const auto glyph = style.font.glyph(c);
-	display.draw_glyph(p, glyph, style.foreground, style.background);
+	if( !is_clipped({ p, glyph.size() }) ) {
+		display.draw_glyph(p, glyph, style.foreground, style.background);
+	}
 	return glyph.advance().x;
 }
 
 int Painter::draw_string(Point p, const Style& style, const std::string text) {
-	size_t width = 0;
-	for(const auto c : text) {
-		const auto glyph = style.font.glyph(c);
-		display.draw_glyph(p, glyph, style.foreground, style.background);
-		const auto advance = glyph.advance();
-		p += advance;
-		width += advance.x;
+	const auto& font = style.font;
+	const int w = font.char_width();
+	const auto char_rect = [p, w, &font](const size_t i) {
+		return Rect { p.x + static_cast<int>(i) * w, p.y, w, font.line_height() };
+	};
+
+	// Trim characters outside the damage off both ends, draw the rest as one run.
+	size_t first = 0;
+	size_t last = text.size();
+	while( (first < last) && is_clipped(char_rect(first)) ) {
+		first++;
+	}
+	while( (last > first) && is_clipped(char_rect(last - 1)) ) {
+		last--;
+	}
+
+	if( first < last ) {
+		display.draw_string(char_rect(first).pos, font, &text[first], last - first, style.foreground, style.background);
 	}
-	return width;
+	return text.size() * w;
 }
 
 void Painter::draw_bitmap(const Point p, const Bitmap& bitmap, const Color foreground, const Color background) {
-	display.draw_bitmap(p, bitmap.size, bitmap.data, foreground, background);
+	if( !is_clipped({ p, bitmap.size }) ) {
+		display.draw_bitmap(p, bitmap.size, bitmap.data, foreground, background);
+	}
 }
 
 void Painter::draw_hline(Point p, int width, const Color c) {
-	display.fill_rectangle({ p, { width, 1 } }, c);
+	fill_rectangle({ p, { width, 1 } }, c);
 }
 
 void Painter::draw_vline(Point p, int height, const Color c) {
-	display.fill_rectangle({ p, { 1, height } }, c);
+	fill_rectangle({ p, { 1, height } }, c);
 }
 
 void Painter::draw_rectangle(const Rect r, const Color c) {
@@ -74,16 +160,45 @@ void Painter::draw_rectangle(const Rect r, const Color c) {
 }
 
 void Painter::fill_rectangle(const Rect r, const Color c) {
-	display.fill_rectangle(r, c);
+	if( clip ) {
+		/* Damage rectangles never overlap, so no pixel is written twice. */
+		for(const auto& d : *clip) {
+			display.fill_rectangle(r.intersect(d), c);
+		}
+	} else {
+		display.fill_rectangle(r, c);
+	}
 }
 
 void Painter::paint_widget_tree(Widget* const w) {
 	if( ui::is_dirty() ) {
+		auto& damage = ui::damage_region();
+		collect_damage(w);
+
+		clip = &damage;
 		paint_widget(w);
+		clip = nullptr;
+
+		damage.clear();
 		ui::dirty_clear();
 	}
 }
 
+void Painter::collect_damage(Widget* const w) {
+	/* Whole-widget damage is taken here rather than in set_dirty(), so it
+	 * uses where the widget is now, not where it was when it changed.
+	 * Partial damage was recorded as it happened.
+	 */
+	if( !w->hidden() ) {
+		if( w->dirty() && !w->dirty_partial() ) {
+			ui::damage_region().add(w->screen_rect());
+		}
+		for(const auto child : w->children()) {
+			collect_damage(child);
+		}
+	}
+}
+
 void Painter::paint_widget(Widget* const w) {
 	if( w->hidden() ) {
 		// Mark widget (and all children) as invisible.
@@ -94,9 +209,11 @@ void Painter::paint_widget(Widget* const w) {
 
 		if( w->dirty() ) {
 			w->paint(*this);
-			// Force-paint all children.
+			// Force-paint children the repaint may have drawn over.
 			for(const auto child : w->children()) {
-				child->set_dirty();
+				if( clip->intersects(child->screen_rect()) ) {
+					child->set_dirty();
+				}
 				paint_widget(child);
 			}
 			w->set_clean();
@@ -26,6 +26,8 @@
 #include "ui_text.hpp"
 
 #include <string>
+#include <array>
+#include <cstddef>
 
 namespace ui {
 
@@ -39,6 +41,30 @@ struct Style {
 
 class Widget;
 
+/* Screen area that has to be repainted this frame, as a handful of
+ * rectangles. Overlapping (or edge-sharing) rectangles are coalesced. When
+ * there's no room left, the new rectangle is merged with whichever one
+ * grows the least, so the region only ever over-covers the damage.
+ */
+class DamageRegion {
+public:
+	static constexpr size_t rects_max = 8;
+
+	void add(Rect r);
+	void clear();
+
+	bool intersects(const Rect r) const;
+
+	const Rect* begin() const { return &rects[0]; }
+	const Rect* end() const { return &rects[count]; }
+
+private:
+	std::array<Rect, rects_max> rects;
+	size_t count { 0 };
+
+	void remove(const size_t index);
+};
+
 class Painter {
 public:
 	Painter() { };
@@ -58,9 +84,15 @@ public:
 	void paint_widget_tree(Widget* const w);
 	
 private:
+	/* While painting the widget tree, drawing is clipped to the damage. */
+	const DamageRegion* clip { nullptr };
+
 	void draw_hline(Point p, int width, const Color c);
 	void draw_vline(Point p, int height, const Color c);
 
+	bool is_clipped(const Rect r) const;
+
+	void collect_damage(Widget* const w);
 	void paint_widget(Widget* const w);
 };
 
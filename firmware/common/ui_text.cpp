@@ -35,6 +35,10 @@ Glyph Font::glyph(const char c) const {
 	}
 }
 
+Dim Font::char_width() const {
+	return w;
+}
+
 Dim Font::line_height() const {
 	return h;
 }
@@ -51,4 +55,34 @@ Size Font::size_of(const std::string s) const {
 	return size;
 }
 
+/* TextRun ***************************************************************/
+
+constexpr size_t TextRun::line_pixels_max;
+constexpr size_t TextRun::glyphs_max;
+
+/* GlyphCache ************************************************************/
+
+const GlyphCache::Patterns& GlyphCache::patterns(
+	const Color foreground,
+	const Color background
+) {
+	for(const auto& entry : entries) {
+		if( entry.valid && (entry.foreground.v == foreground.v) && (entry.background.v == background.v) ) {
+			return entry.patterns;
+		}
+	}
+
+	auto& entry = entries[next];
+	next = (next + 1) % entries.size();
+
+	for(size_t n=0; n<entry.patterns.size(); n++) {
+		const uint8_t bits = n;
+		expand_bitmap(&bits, 0, 4, foreground, background, entry.patterns[n].data());
+	}
+	entry.foreground = foreground;
+	entry.background = background;
+	entry.valid = true;
+	return entry.patterns;
+}
+
 } /* namespace ui */
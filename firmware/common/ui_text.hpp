@@ -25,6 +25,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <string>
+#include <array>
+#include <algorithm>
 
 #include "ui.hpp"
 
@@ -87,6 +89,7 @@ public:
 
 	Glyph glyph(const char c) const;
 
+	Dim char_width() const;
 	Dim line_height() const;
 	Size size_of(const std::string s) const;
 
@@ -99,6 +102,115 @@ private:
 	const size_t data_stride;
 };
 
+/* Expand "count" pixels of a 1-bpp bitmap, least significant bit first,
+ * starting at bit "first".
+ */
+inline void expand_bitmap(
+	const uint8_t* const bits,
+	const size_t first,
+	const size_t count,
+	const Color foreground,
+	const Color background,
+	Color* const out
+) {
+	for(size_t i=0; i<count; i++) {
+		const size_t n = first + i;
+		out[i] = ((bits[n >> 3] >> (n & 7)) & 1) ? foreground : background;
+	}
+}
+
+/* Glyph bitmaps pre-expanded for a colour pair: all sixteen 4-pixel
+ * patterns, in foreground and background. A glyph row then expands four
+ * pixels per table lookup, without testing bits. A screen uses only a few
+ * text styles, so a handful of pairs are kept, replaced round-robin.
+ */
+class GlyphCache {
+public:
+	static constexpr size_t styles_max = 4;
+
+	using Pattern = std::array<Color, 4>;
+	using Patterns = std::array<Pattern, 16>;
+
+	/* Valid until the next call. */
+	const Patterns& patterns(const Color foreground, const Color background);
+
+private:
+	struct Entry {
+		Color foreground;
+		Color background;
+		bool valid;
+		Patterns patterns;
+	};
+
+	std::array<Entry, styles_max> entries { };
+	size_t next { 0 };
+};
+
+/* Renders a string as one window, font height tall: each scanline of the
+ * whole string is assembled in a line buffer, then handed on in one piece.
+ * Saves setting a window per character, and the bit-by-bit expansion of
+ * every glyph.
+ */
+class TextRun {
+public:
+	static constexpr size_t line_pixels_max = 240;
+	static constexpr size_t glyphs_max = 32;
+
+	/* How many of "length" characters fit in one run. */
+	size_t fit(const Font& font, const size_t length) const {
+		return std::min({ length, line_pixels_max / font.char_width(), glyphs_max });
+	}
+
+	/* length must be no more than fit(). Calls write_line(pixels, count)
+	 * for each scanline, top to bottom.
+	 */
+	template<typename WriteLine>
+	void render(
+		const Font& font,
+		const char* const text,
+		const size_t length,
+		const Color foreground,
+		const Color background,
+		WriteLine write_line
+	) {
+		std::array<const uint8_t*, glyphs_max> bits;
+		for(size_t i=0; i<length; i++) {
+			bits[i] = font.glyph(text[i]).pixels();
+		}
+
+		const auto& patterns = cache.patterns(foreground, background);
+
+		const size_t w = font.char_width();
+		const size_t h = font.line_height();
+		/* Glyph rows start on a byte boundary when the width is a whole
+		 * number of bytes: look up a nibble at a time.
+		 */
+		const bool byte_rows = (w & 7) == 0;
+		for(size_t y=0; y<h; y++) {
+			Color* out = line.data();
+			for(size_t i=0; i<length; i++) {
+				if( byte_rows ) {
+					const uint8_t* const row = &bits[i][(y * w) >> 3];
+					for(size_t k=0; k<(w >> 3); k++) {
+						const auto& lo = patterns[row[k] & 0xf];
+						const auto& hi = patterns[row[k] >> 4];
+						out = std::copy(lo.begin(), lo.end(), out);
+						out = std::copy(hi.begin(), hi.end(), out);
+					}
+				} else {
+					expand_bitmap(bits[i], y * w, w, foreground, background, out);
+					out += w;
+				}
+			}
+			write_line(line.data(), length * w);
+		}
+	}
+
+private:
+	GlyphCache cache;
+	std::array<Color, line_pixels_max> line;
+};
+
 } /* namespace ui */
 
 #endif/*__UI_TEXT_H__*/
@@ -44,6 +44,12 @@ bool is_dirty() {
 	return ui_dirty;
 }
 
+static DamageRegion damage;
+
+DamageRegion& damage_region() {
+	return damage;
+}
+
 /* Widget ****************************************************************/
 
 const std::vector<Widget*> Widget::no_children { };
@@ -80,6 +86,20 @@ void Widget::set_parent(Widget* const widget) {
 
 void Widget::set_dirty() {
 	flags.dirty = true;
+	flags.dirty_partial = false;
+	dirty_set();
+}
+
+void Widget::set_dirty(const Rect damaged) {
+	if( !flags.dirty ) {
+		flags.dirty = true;
+		flags.dirty_partial = true;
+	}
+	/* Already wholly dirty: the whole widget is damaged at paint time. */
+	if( flags.dirty_partial ) {
+		const auto r = screen_rect();
+		damage.add((damaged + r.pos).intersect(r));
+	}
 	dirty_set();
 }
 
@@ -87,8 +107,13 @@ bool Widget::dirty() const {
 	return flags.dirty;
 }
 
+bool Widget::dirty_partial() const {
+	return flags.dirty_partial;
+}
+
 void Widget::set_clean() {
 	flags.dirty = false;
+	flags.dirty_partial = false;
 }
 
 void Widget::hidden(bool hide) {
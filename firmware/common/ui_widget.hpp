@@ -32,6 +32,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <functional>
 
 namespace ui {
 
@@ -39,6 +40,9 @@ void dirty_set();
 void dirty_clear();
 bool is_dirty();
 
+/* Screen areas to repaint at the next paint_widget_tree(). */
+DamageRegion& damage_region();
+
 class Context {
 public:
 	FocusManager& focus_manager() {
@@ -104,7 +108,12 @@ public:
 
 	// State management methods.
 	void set_dirty();
+	/* Repaint only part of the widget, in widget coordinates. Cheaper than
+	 * set_dirty() for a widget with one small piece of changed content.
+	 */
+	void set_dirty(const Rect damaged);
 	bool dirty() const;
+	bool dirty_partial() const;
 	void set_clean();
 
 	void visible(bool v);
@@ -123,6 +132,7 @@ private:
 
 	struct flags_t {
 		bool dirty : 1;			// Widget content has changed.
+		bool dirty_partial : 1;	// ...but only the areas in the damage region.
 		bool hidden : 1;		// Hide widget and children.
 		bool focusable : 1;		// Widget can receive focus.
 		bool highlighted : 1;	// Show in a highlighted style.
@@ -131,6 +141,7 @@ private:
 
 	flags_t flags {
 		.dirty = true,
+		.dirty_partial = false,
 		.hidden = false,
 		.focusable = false,
 		.highlighted = false,
@@ -69,6 +69,32 @@ constexpr size_t log_2(const size_t n, const size_t p = 0) {
 	return (n <= 1) ? p : log_2(n / 2, p + 1);
 }
 
+/* Compile-time integer sequence, for building constexpr lookup tables with
+ * pack expansion (C++11 lacks std::index_sequence). Built by halving, so
+ * template recursion depth is log2(N), not N.
+ */
+template<size_t... I>
+struct index_sequence { };
+
+template<typename A, typename B>
+struct index_sequence_concat;
+
+template<size_t... A, size_t... B>
+struct index_sequence_concat<index_sequence<A...>, index_sequence<B...>> {
+	using type = index_sequence<A..., (sizeof...(A) + B)...>;
+};
+
+template<size_t N>
+struct make_index_sequence {
+	using type = typename index_sequence_concat<
+		typename make_index_sequence<N / 2>::type,
+		typename make_index_sequence<N - N / 2>::type
+	>::type;
+};
+
+template<> struct make_index_sequence<0> { using type = index_sequence<>; };
+template<> struct make_index_sequence<1> { using type = index_sequence<0>; };
+
 float fast_log2(const float val);
 float fast_pow2(const float val);
 
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "host_bench.hpp"
+
+#include "dsp_types.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_translate.hpp"
+#include "dsp_demodulate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "dsp_fft.hpp"
+#include "dsp_wola.hpp"
+#include "matched_filter.hpp"
+#include "channel_decimator.hpp"
+#include "polyphase_channelizer.hpp"
+#include "ais_baseband.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+using namespace host_bench;
+
+namespace {
+
+/* Deterministic stand-in for a baseband capture: a few carriers plus noise,
+ * scaled to roughly fill the complex<int8_t> range the way the MAX5864 does.
+ */
+class TestSignal {
+public:
+	static constexpr size_t block_samples = 2048;
+	static constexpr size_t block_count = 8;
+
+	TestSignal() {
+		uint32_t seed = 0x1234567;
+		for(size_t b=0; b<block_count; b++) {
+			for(size_t i=0; i<block_samples; i++) {
+				const size_t n = b * block_samples + i;
+				const float t = static_cast<float>(n);
+				const float re = 40.0f * std::cos(t * 0.0123f) + 25.0f * std::cos(t * 0.7071f) + noise(seed);
+				const float im = 40.0f * std::sin(t * 0.0123f) + 25.0f * std::sin(t * 0.7071f) + noise(seed);
+				c8[n] = { clip8(re), clip8(im) };
+				c16[n] = { static_cast<int16_t>(c8[n].real() * 256), static_cast<int16_t>(c8[n].imag() * 256) };
+				s16[n] = c16[n].real();
+			}
+		}
+	}
+
+	buffer_c8_t block_c8(const size_t index, const uint32_t sampling_rate) {
+		return { &c8[(index % block_count) * block_samples], block_samples, sampling_rate };
+	}
+
+	buffer_c16_t block_c16(const size_t index, const uint32_t sampling_rate) {
+		return { &c16[(index % block_count) * block_samples], block_samples, sampling_rate };
+	}
+
+	buffer_s16_t block_s16(const size_t index, const uint32_t sampling_rate) {
+		return { &s16[(index % block_count) * block_samples], block_samples, sampling_rate };
+	}
+
+private:
+	std::array<complex8_t, block_samples * block_count> c8;
+	std::array<complex16_t, block_samples * block_count> c16;
+	std::array<int16_t, block_samples * block_count> s16;
+
+	static float noise(uint32_t& seed) {
+		seed = seed * 1664525 + 1013904223;
+		return (static_cast<int32_t>(seed >> 16) & 0xff) / 8.0f - 16.0f;
+	}
+
+	static int8_t clip8(const float v) {
+		return (v > 127.0f) ? 127 : ((v < -128.0f) ? -128 : static_cast<int8_t>(v));
+	}
+};
+
+TestSignal test_signal;
+
+std::array<complex16_t, 2048> dst_c16;
+std::array<int16_t, 2048> dst_s16;
+std::array<float, 2048> dst_f32;
+
+const buffer_c16_t dst_c16_buffer { dst_c16.data(), dst_c16.size() };
+const buffer_s16_t dst_s16_buffer { dst_s16.data(), dst_s16.size() };
+const buffer_f32_t dst_f32_buffer { dst_f32.data(), dst_f32.size() };
+
+constexpr uint32_t baseband_fs = 3072000;
+
+template<typename T>
+Output output_of(const buffer_t<T>& buffer) {
+	return { buffer.p, buffer.count * sizeof(T) };
+}
+
+void register_decimate() {
+	add("decimate::Complex8DecimateBy2CIC3", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::Complex8DecimateBy2CIC3>();
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c8(n, baseband_fs), dst_c16_buffer)); };
+	});
+
+	add("decimate::TranslateByFSOver4AndDecimateBy2CIC3", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3>();
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c8(n, baseband_fs), dst_c16_buffer)); };
+	});
+
+	add("decimate::DecimateBy2CIC3", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::DecimateBy2CIC3>();
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, baseband_fs), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIR64AndDecimateBy2Real", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIR64AndDecimateBy2Real>();
+		k->configure(taps_64_lp_156_198.taps);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_s16(n, 96000), dst_s16_buffer)); };
+	});
+
+	add("decimate::FIRC8xR16x24FS4Decim4", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRC8xR16x24FS4Decim4>();
+		k->configure(taps_200k_wfm_decim_0.taps, 33554432);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c8(n, baseband_fs), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIRC8xR16x24FS4Decim8", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRC8xR16x24FS4Decim8>();
+		k->configure(taps_16k0_decim_0.taps, 33554432);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c8(n, baseband_fs), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIRC16xR16x16Decim2", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRC16xR16x16Decim2>();
+		k->configure(taps_200k_wfm_decim_1.taps, 131072);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 768000), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIRC16xR16x32Decim8", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRC16xR16x32Decim8>();
+		k->configure(taps_16k0_decim_1.taps, 131072);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 384000), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIRAndDecimateComplex", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRAndDecimateComplex>();
+		k->configure(taps_2k8_usb_channel.taps, 2);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 24000), dst_c16_buffer)); };
+	});
+
+	add("decimate::FIRAndDecimateComplex/real", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::FIRAndDecimateComplex>();
+		k->configure(taps_16k0_channel.taps, 1);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 48000), dst_c16_buffer)); };
+	});
+
+	add("translate::Translate", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::translate::Translate>();
+		k->configure(307200, 25000);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 307200), dst_c16_buffer)); };
+	});
+
+	add("decimate::DecimateBy2CIC4Real", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::decimate::DecimateBy2CIC4Real>();
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_s16(n, 96000), dst_s16_buffer)); };
+	});
+
+	add("ChannelDecimator/32", TestSignal::block_samples, []() {
+		auto k = std::make_shared<ChannelDecimator>(ChannelDecimator::DecimationFactor::By32);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c8(n, baseband_fs))); };
+	});
+
+	/* All 32 channels at once; compare against 32x a single-channel chain. */
+	for(const size_t decimation_factor : { 32, 16 }) {
+		add("channelizer::PolyphaseChannelizer/32/" + std::to_string(decimation_factor), TestSignal::block_samples, [decimation_factor]() {
+			auto k = std::make_shared<dsp::channelizer::PolyphaseChannelizer>();
+			k->configure(taps_pfb_32_channel.taps, 32, decimation_factor);
+			auto dst = std::make_shared<std::vector<complex16_t>>(32 * TestSignal::block_samples / decimation_factor);
+			return [k, dst](const size_t n) {
+				const auto count = k->execute(test_signal.block_c8(n, baseband_fs), { dst->data(), dst->size() });
+				return Output { dst->data(), k->channels() * count * sizeof(complex16_t) };
+			};
+		});
+	}
+}
+
+void register_demodulate() {
+	add("demodulate::AM", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::demodulate::AM>();
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 12000), dst_f32_buffer)); };
+	});
+
+	const std::vector<std::pair<std::string, dsp::demodulate::Discriminator>> discriminators {
+		{ "", dsp::demodulate::Discriminator::Precise },
+		{ "/rational", dsp::demodulate::Discriminator::Rational },
+		{ "/polynomial", dsp::demodulate::Discriminator::Polynomial },
+		{ "/table", dsp::demodulate::Discriminator::Table },
+		{ "/cordic", dsp::demodulate::Discriminator::CORDIC },
+	};
+
+	for(const auto& d : discriminators) {
+		const auto discriminator = d.second;
+		add("demodulate::FM/f32" + d.first, TestSignal::block_samples, [discriminator]() {
+			auto k = std::make_shared<dsp::demodulate::FM>();
+			k->configure(48000, 7500, discriminator);
+			return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 48000), dst_f32_buffer)); };
+		});
+	}
+
+	add("demodulate::FM/s16", TestSignal::block_samples, []() {
+		auto k = std::make_shared<dsp::demodulate::FM>();
+		k->configure(384000, 75000, dsp::demodulate::Discriminator::Rational);
+		return [k](const size_t n) { return output_of(k->execute(test_signal.block_c16(n, 384000), dst_s16_buffer)); };
+	});
+}
+
+template<typename MatchedFilter>
+KernelFactory matched_filter_kernel() {
+	return []() {
+		auto k = std::make_shared<MatchedFilter>(baseband::ais::rrc_taps_38k4_4t_p, 2);
+		return [k](const size_t n) {
+			const auto src = test_signal.block_c16(n, 38400);
+			size_t count = 0;
+			for(size_t i=0; i<src.count; i++) {
+				if( k->execute_once(src.p[i]) ) {
+					dst_f32[count++] = k->get_output();
+				}
+			}
+			return Output { dst_f32.data(), count * sizeof(float) };
+		};
+	};
+}
+
+void register_packet() {
+	add("matched_filter::MatchedFilter", TestSignal::block_samples, matched_filter_kernel<dsp::matched_filter::MatchedFilter>());
+	add("matched_filter::MatchedFilterQ15", TestSignal::block_samples, matched_filter_kernel<dsp::matched_filter::MatchedFilterQ15>());
+}
+
+void register_fft() {
+	add("fft_c_preswapped/256", 256, []() {
+		auto data = std::make_shared<std::array<std::complex<float>, 256>>();
+		return [data](const size_t n) {
+			const auto src = test_signal.block_c16(n, 0);
+			fft_swap(buffer_c16_t { src.p, 256 }, *data);
+			fft_c_preswapped(*data);
+			return Output { data->data(), sizeof(*data) };
+		};
+	});
+
+	for(const size_t n : { 256, 512, 1024, 2048 }) {
+		add("fft_q15/" + std::to_string(n), n, [n]() {
+			auto data = std::make_shared<std::vector<complex16_t>>(n);
+			return [data, n](const size_t call) {
+				const auto src = test_signal.block_c16(call, 0);
+				fft_q15(src.p, data->data(), n);
+				return Output { data->data(), n * sizeof(complex16_t) };
+			};
+		});
+	}
+}
+
+/* WidebandSpectrum's front end, per 2048-sample buffer at 20MHz: the
+ * window-presum alone, and with the FFT of the segment it makes (which the
+ * event loop does for every buffer it keeps up with).
+ */
+void register_spectrum() {
+	add("wola::window_presum", TestSignal::block_samples, []() {
+		auto presum = std::make_shared<dsp::wola::WindowPresum>();
+		presum->configure();
+		return [presum](const size_t n) {
+			return output_of(presum->execute(test_signal.block_c8(n, 20000000), dst_c16_buffer));
+		};
+	});
+
+	add("wola::window_presum+fft_q15/1024", TestSignal::block_samples, []() {
+		auto presum = std::make_shared<dsp::wola::WindowPresum>();
+		presum->configure();
+		auto data = std::make_shared<std::array<complex16_t, 1024>>();
+		return [presum, data](const size_t n) {
+			const auto presummed = presum->execute(test_signal.block_c8(n, 20000000), dst_c16_buffer);
+			fft_q15(presummed.p, data->data(), presummed.count);
+			return Output { data->data(), sizeof(*data) };
+		};
+	});
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	register_decimate();
+	register_demodulate();
+	register_packet();
+	register_fft();
+	register_spectrum();
+
+	return run(argc, argv);
+}
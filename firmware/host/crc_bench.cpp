@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* TableCRC against the bit-at-a-time CRC<>, for every CRC the firmware
+ * checks:
+ *
+ * - first, the two must agree on random data, through every API: whole
+ *   buffers, single bytes, and bit fields of every length, in both bit
+ *   orders
+ * - then, bytes per second through each, over a long buffer and over
+ *   packet-sized buffers (the AIS, ERT and TPMS checks are all under
+ *   32 bytes, so setup cost matters as much as the inner loop)
+ */
+
+#include "crc.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <chrono>
+
+namespace {
+
+std::vector<uint8_t> random_bytes(const size_t length, uint32_t seed) {
+	std::vector<uint8_t> data(length);
+	for(auto& d : data) {
+		seed = seed * 1103515245 + 12345;
+		d = seed >> 24;
+	}
+	return data;
+}
+
+/* Every way in, on both engines, must give the same checksum. */
+template<typename Table, typename Bitwise>
+bool agree(Table table, Bitwise bitwise) {
+	const auto data = random_bytes(4099, 7);
+
+	for(const size_t length : { 0, 1, 3, 4, 5, 31, 4099 }) {
+		table.reset();
+		bitwise.reset();
+		table.process_bytes(data.data(), length);
+		bitwise.process_bytes(data.data(), length);
+		if( table.checksum() != bitwise.checksum() ) {
+			return false;
+		}
+	}
+
+	table.reset();
+	bitwise.reset();
+	uint32_t seed = 11;
+	for(size_t i=0; i<4096; i++) {
+		seed = seed * 1103515245 + 12345;
+		const uint32_t bits = seed;
+		const size_t bit_count = (seed >> 7) % 32 + 1;
+		switch(i % 3) {
+		case 0:
+			table.process_bits(bits, bit_count);
+			bitwise.process_bits(bits, bit_count);
+			break;
+		case 1:
+			table.process_bits_lsb_first(bits, bit_count);
+			bitwise.process_bits_lsb_first(bits, bit_count);
+			break;
+		default:
+			table.process_byte(bits);
+			bitwise.process_byte(bits);
+			break;
+		}
+		if( table.checksum() != bitwise.checksum() ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<typename CRCType>
+double bytes_per_second(const CRCType& prototype, const std::vector<uint8_t>& data, const size_t block, uint32_t& checksum) {
+	const size_t passes = (64 << 20) / data.size();
+	uint32_t sum = 0;
+	const auto start = Clock::now();
+	for(size_t pass=0; pass<passes; pass++) {
+		for(size_t offset=0; offset + block<=data.size(); offset+=block) {
+			auto crc = prototype;
+			crc.process_bytes(&data[offset], block);
+			sum += crc.checksum();
+		}
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	checksum = sum;
+	return passes * (data.size() / block) * block / elapsed.count();
+}
+
+template<typename Table, typename Bitwise>
+bool report(const char* const name, const Table& table, const Bitwise& bitwise) {
+	const bool matches = agree(table, bitwise);
+	const auto data = random_bytes(256 * 1024, 1);
+
+	for(const size_t block : { size_t(21), data.size() }) {
+		uint32_t checksum_bitwise = 0;
+		uint32_t checksum_table = 0;
+		const double bitwise_rate = bytes_per_second(bitwise, data, block, checksum_bitwise);
+		const double table_rate = bytes_per_second(table, data, block, checksum_table);
+		std::printf("%-14s %7zu %12.1f %12.1f %8.1fx  %s\n",
+			name, block,
+			bitwise_rate / 1e6, table_rate / 1e6, table_rate / bitwise_rate,
+			(matches && (checksum_bitwise == checksum_table)) ? "agree" : "DIFFER"
+		);
+	}
+	return matches;
+}
+
+} /* namespace */
+
+int main() {
+	std::printf("%-14s %7s %12s %12s %9s\n", "crc", "block", "bit (MB/s)", "table (MB/s)", "speedup");
+
+	bool matches = true;
+	matches &= report("AIS FCS",
+		TableCRC<16, 0x1021> { 0xffff, 0xffff },
+		CRC<16> { 0x1021, 0xffff, 0xffff }
+	);
+	matches &= report("ERT BCH",
+		TableCRC<16, 0x6f63> { },
+		CRC<16> { 0x6f63 }
+	);
+	matches &= report("ERT CCITT",
+		TableCRC<16, 0x1021> { 0xffff, 0x1d0f },
+		CRC<16> { 0x1021, 0xffff, 0x1d0f }
+	);
+	matches &= report("TPMS",
+		TableCRC<8, 0x01> { 0x00 },
+		CRC<8> { 0x01, 0x00 }
+	);
+	matches &= report("CRC-32 x1",
+		TableCRC<32, 0x04c11db7, true, true> { 0xffffffff, 0xffffffff },
+		CRC<32, true, true> { 0x04c11db7, 0xffffffff, 0xffffffff }
+	);
+	matches &= report("CRC-32 x4",
+		CRC32 { },
+		CRC<32, true, true> { 0x04c11db7, 0xffffffff, 0xffffffff }
+	);
+	matches &= report("16 in/out x4",
+		TableCRC<16, 0x8005, true, false, 4> { 0x1234, 0x0000 },
+		CRC<16, true, false> { 0x8005, 0x1234, 0x0000 }
+	);
+	matches &= report("24 out x4",
+		TableCRC<24, 0x864cfb, false, true, 4> { 0xb704ce, 0x00 },
+		CRC<24, false, true> { 0x864cfb, 0xb704ce, 0x00 }
+	);
+
+	return matches ? 0 : 1;
+}
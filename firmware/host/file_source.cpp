@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "file_source.hpp"
+
+#include <thread>
+
+FileSource::FileSource(
+	const std::string& path,
+	const uint32_t sampling_rate,
+	const Pacing pacing,
+	const size_t passes,
+	const size_t buffer_samples
+) : file { std::fopen(path.c_str(), "rb") },
+	sampling_rate { sampling_rate },
+	pacing { pacing },
+	passes { passes },
+	samples(buffer_samples)
+{
+}
+
+FileSource::~FileSource() {
+	if( file ) {
+		std::fclose(file);
+	}
+}
+
+baseband::buffer_t FileSource::read() {
+	if( file == nullptr ) {
+		return { };
+	}
+
+	static_assert(sizeof(baseband::sample_t) == 2, "complex8_t is not two bytes");
+	auto count = std::fread(samples.data(), sizeof(baseband::sample_t), samples.size(), file);
+	if( (count < samples.size()) && ((pass + 1) < passes) ) {
+		pass++;
+		std::rewind(file);
+		count = std::fread(samples.data(), sizeof(baseband::sample_t), samples.size(), file);
+	}
+	if( count < samples.size() ) {
+		return { };
+	}
+
+	if( buffers_read_ == 0 ) {
+		start_time = clock::now();
+	}
+	buffers_read_++;
+
+	if( pacing == Pacing::Realtime ) {
+		/* A buffer is complete once its last sample has arrived. */
+		const std::chrono::duration<double> due { signal_seconds() };
+		std::this_thread::sleep_until(start_time + std::chrono::duration_cast<clock::duration>(due));
+	}
+
+	return { samples.data(), samples.size() };
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __FILE_SOURCE_H__
+#define __FILE_SOURCE_H__
+
+#include "baseband_source.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* Replays a recording of raw complex8_t samples (the Capture app's .C8
+ * format) as if it were arriving from the DMA ring, one transfer at a time:
+ * 2048 samples unless told otherwise (see BasebandConfiguration).
+ *
+ * Pacing::Realtime holds each buffer back until its samples would have
+ * arrived at the declared sampling rate, so a processor that can't keep up
+ * shows up as a real time factor below one. Pacing::AsFastAsPossible hands
+ * out buffers back-to-back, for throughput measurement and regression runs.
+ *
+ * A partial buffer at the end of the file is dropped, as it would be on the
+ * device. With passes > 1 the recording plays again from the start, for
+ * benchmarks on short recordings.
+ */
+class FileSource : public baseband::SampleSource {
+public:
+	enum class Pacing {
+		AsFastAsPossible,
+		Realtime,
+	};
+
+	FileSource(
+		const std::string& path,
+		const uint32_t sampling_rate,
+		const Pacing pacing,
+		const size_t passes = 1,
+		const size_t buffer_samples = 2048
+	);
+	~FileSource();
+
+	bool is_open() const {
+		return file != nullptr;
+	}
+
+	baseband::buffer_t read() override;
+
+	size_t buffers_read() const {
+		return buffers_read_;
+	}
+
+	/* Seconds of signal handed out so far, at the declared rate. */
+	double signal_seconds() const {
+		return static_cast<double>(buffers_read_ * samples.size()) / sampling_rate;
+	}
+
+private:
+	using clock = std::chrono::steady_clock;
+
+	std::FILE* file { nullptr };
+	const uint32_t sampling_rate;
+	const Pacing pacing;
+	const size_t passes;
+	size_t pass { 0 };
+	std::vector<baseband::sample_t> samples;
+	size_t buffers_read_ { 0 };
+	clock::time_point start_time;
+};
+
+#endif/*__FILE_SOURCE_H__*/
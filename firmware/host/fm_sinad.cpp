@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Accuracy comparison of the FM discriminator backends
+ * (dsp::demodulate::Discriminator):
+ *
+ * - worst-case angle error against double-precision atan2, over vectors of
+ *   every direction and a wide range of magnitudes
+ * - SINAD of a 1kHz tone through the NFM (48kHz, 2.5kHz deviation) and WFM
+ *   (384kHz, 75kHz deviation) audio paths
+ */
+
+#include "dsp_demodulate.hpp"
+#include "complex.hpp"
+#include "utility_m4.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+namespace {
+
+struct Backend {
+	const char* const name;
+	const dsp::demodulate::Discriminator discriminator;
+};
+
+const std::array<Backend, 5> backends { {
+	{ "precise", dsp::demodulate::Discriminator::Precise },
+	{ "rational", dsp::demodulate::Discriminator::Rational },
+	{ "polynomial", dsp::demodulate::Discriminator::Polynomial },
+	{ "table", dsp::demodulate::Discriminator::Table },
+	{ "cordic", dsp::demodulate::Discriminator::CORDIC },
+} };
+
+constexpr size_t block_samples = 2048;
+
+/* Demodulate one sample pair at a time: the first output of each pair is
+ * the phase step from the reference vector to the test vector.
+ */
+double max_angle_error_degrees(const dsp::demodulate::Discriminator discriminator, const double angle_limit) {
+	dsp::demodulate::FM fm;
+	fm.configure(1.0f, 1.0f / (2.0f * static_cast<float>(M_PI)), discriminator);
+
+	double max_error = 0.0;
+	for(int32_t magnitude=200; magnitude<=32000; magnitude*=2) {
+		for(size_t i=0; i<3600; i++) {
+			const double angle = ((i / 3600.0) * 2.0 - 1.0) * angle_limit;
+			std::array<complex16_t, 2> src { {
+				{ static_cast<int16_t>(magnitude), 0 },
+				{ static_cast<int16_t>(std::lround(magnitude * std::cos(angle))), static_cast<int16_t>(std::lround(magnitude * std::sin(angle))) },
+			} };
+			std::array<float, 2> dst;
+			fm.execute(buffer_c16_t { src.data(), src.size() }, buffer_f32_t { dst.data(), dst.size() });
+
+			const double actual = std::atan2(src[1].imag(), src[1].real());
+			double error = std::abs(dst[1] - actual);
+			if( error > M_PI ) {
+				error = 2.0 * M_PI - error;
+			}
+			max_error = std::max(max_error, error);
+		}
+	}
+	return max_error * 180.0 / M_PI;
+}
+
+/* Least-squares fit of a*cos + b*sin + c at the tone frequency; everything
+ * left over is noise and distortion.
+ */
+double sinad_db(const std::vector<float>& audio, const double tone_w) {
+	double cc = 0, ss = 0, cs = 0, yc = 0, ys = 0;
+	double mean = 0;
+	for(const auto v : audio) {
+		mean += v;
+	}
+	mean /= audio.size();
+
+	for(size_t n=0; n<audio.size(); n++) {
+		const double c = std::cos(tone_w * n);
+		const double s = std::sin(tone_w * n);
+		const double y = audio[n] - mean;
+		cc += c * c; ss += s * s; cs += c * s;
+		yc += y * c; ys += y * s;
+	}
+	const double det = cc * ss - cs * cs;
+	const double a = (yc * ss - ys * cs) / det;
+	const double b = (ys * cc - yc * cs) / det;
+
+	double signal = 0, residual = 0;
+	for(size_t n=0; n<audio.size(); n++) {
+		const double fit = a * std::cos(tone_w * n) + b * std::sin(tone_w * n);
+		const double y = audio[n] - mean;
+		signal += y * y;
+		residual += (y - fit) * (y - fit);
+	}
+	return 10.0 * std::log10(signal / residual);
+}
+
+double tone_sinad_db(
+	const dsp::demodulate::Discriminator discriminator,
+	const float sampling_rate,
+	const float deviation,
+	const float amplitude
+) {
+	constexpr float tone_f = 1000.0f;
+	constexpr size_t blocks = 8;
+
+	dsp::demodulate::FM fm;
+	fm.configure(sampling_rate, deviation, discriminator);
+
+	std::vector<complex16_t> iq(block_samples);
+	std::vector<float> block(block_samples);
+	std::vector<float> audio;
+
+	double phase = 0.0;
+	size_t n = 0;
+	for(size_t b=0; b<blocks; b++) {
+		for(auto& s : iq) {
+			const double f = deviation * std::sin(2.0 * M_PI * tone_f * n++ / sampling_rate);
+			phase += 2.0 * M_PI * f / sampling_rate;
+			s = { static_cast<int16_t>(std::lround(amplitude * std::cos(phase))), static_cast<int16_t>(std::lround(amplitude * std::sin(phase))) };
+		}
+		fm.execute(buffer_c16_t { iq.data(), iq.size() }, buffer_f32_t { block.data(), block.size() });
+		if( b > 0 ) {
+			/* The first block starts against a zero reference sample. */
+			audio.insert(audio.end(), block.begin(), block.end());
+		}
+	}
+
+	return sinad_db(audio, 2.0 * M_PI * tone_f / sampling_rate);
+}
+
+} /* namespace */
+
+int main() {
+	std::printf("%-12s %14s %14s %14s %14s\n", "backend", "err pi/4 (deg)", "err pi (deg)", "NFM SINAD dB", "WFM SINAD dB");
+	for(const auto& backend : backends) {
+		std::printf("%-12s %14.4f %14.4f %14.1f %14.1f\n",
+			backend.name,
+			max_angle_error_degrees(backend.discriminator, M_PI / 4.0),
+			max_angle_error_degrees(backend.discriminator, M_PI * 0.999),
+			tone_sinad_db(backend.discriminator, 48000.0f, 2500.0f, 8000.0f),
+			tone_sinad_db(backend.discriminator, 384000.0f, 75000.0f, 8000.0f)
+		);
+	}
+	return 0;
+}
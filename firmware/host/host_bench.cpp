@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "host_bench.hpp"
+
+#include "dsp_state.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace host_bench {
+
+namespace {
+
+struct Entry {
+	std::string name;
+	size_t samples_per_call;
+	KernelFactory factory;
+};
+
+std::vector<Entry>& entries() {
+	static std::vector<Entry> list;
+	return list;
+}
+
+/* FNV-1a, 32 bits. Plenty for spotting a changed output bit. */
+uint32_t fnv1a(uint32_t hash, const Output& output) {
+	const auto p = static_cast<const uint8_t*>(output.p);
+	for(size_t i=0; i<output.bytes; i++) {
+		hash = (hash ^ p[i]) * 16777619U;
+	}
+	return hash;
+}
+
+/* Kernels run one at a time, so like a baseband processor each gets the
+ * whole DSP state arena to itself.
+ */
+Kernel make_kernel(const Entry& entry) {
+	dsp::state_arena().reset();
+	return entry.factory();
+}
+
+constexpr size_t checksum_calls = 64;
+constexpr double min_bench_seconds = 0.25;
+
+volatile uint8_t sink;
+
+uint32_t checksum(const Entry& entry) {
+	auto kernel = make_kernel(entry);
+	uint32_t hash = 2166136261U;
+	for(size_t n=0; n<checksum_calls; n++) {
+		hash = fnv1a(hash, kernel(n));
+	}
+	return hash;
+}
+
+struct Timing {
+	size_t calls;
+	double seconds;
+};
+
+Timing time_kernel(const Entry& entry, const size_t fixed_calls) {
+	using clock = std::chrono::steady_clock;
+
+	auto kernel = make_kernel(entry);
+	for(size_t n=0; n<16; n++) {
+		kernel(n);
+	}
+
+	size_t calls = 0;
+	const auto start = clock::now();
+	double elapsed = 0.0;
+	do {
+		for(size_t i=0; i<64; i++, calls++) {
+			const auto output = kernel(calls);
+			if( output.bytes ) {
+				sink = *static_cast<const uint8_t*>(output.p);
+			}
+		}
+		elapsed = std::chrono::duration<double>(clock::now() - start).count();
+	} while( fixed_calls ? (calls < fixed_calls) : (elapsed < min_bench_seconds) );
+
+	return { calls, elapsed };
+}
+
+bool selected(const std::string& name, const std::vector<std::string>& filters) {
+	if( filters.empty() ) {
+		return true;
+	}
+	for(const auto& filter : filters) {
+		if( name.find(filter) != std::string::npos ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} /* namespace */
+
+void add(
+	const std::string& name,
+	const size_t samples_per_call,
+	KernelFactory factory
+) {
+	entries().push_back({ name, samples_per_call, factory });
+}
+
+int run(int argc, char* argv[]) {
+	bool checksums_only = false;
+	size_t fixed_calls = 0;
+	std::vector<std::string> filters;
+
+	for(int i=1; i<argc; i++) {
+		if( std::strcmp(argv[i], "--checksums") == 0 ) {
+			checksums_only = true;
+		} else if( (std::strcmp(argv[i], "--calls") == 0) && (i + 1 < argc) ) {
+			fixed_calls = std::strtoul(argv[++i], nullptr, 0);
+		} else {
+			filters.push_back(argv[i]);
+		}
+	}
+
+	if( !checksums_only ) {
+		std::printf("%-48s %12s %10s %10s\n", "kernel", "Msamples/s", "ns/sample", "checksum");
+	}
+
+	for(const auto& entry : entries()) {
+		if( !selected(entry.name, filters) ) {
+			continue;
+		}
+
+		const auto hash = checksum(entry);
+		if( checksums_only ) {
+			std::printf("%s %08x\n", entry.name.c_str(), hash);
+			continue;
+		}
+
+		const auto timing = time_kernel(entry, fixed_calls);
+		const double samples = static_cast<double>(timing.calls) * entry.samples_per_call;
+		const double samples_per_second = samples / timing.seconds;
+		const double ns_per_sample = timing.seconds * 1e9 / samples;
+		std::printf("%-48s %12.2f %10.3f %08x\n",
+			entry.name.c_str(), samples_per_second / 1e6, ns_per_sample, hash
+		);
+	}
+
+	return 0;
+}
+
+} /* namespace host_bench */
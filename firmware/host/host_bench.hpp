@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_BENCH_H__
+#define __HOST_BENCH_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace host_bench {
+
+/* Bytes produced by one call of a kernel, folded into the kernel's checksum
+ * so that output can be compared bit-for-bit against a known-good build.
+ */
+struct Output {
+	const void* p;
+	size_t bytes;
+};
+
+/* A kernel runs one block of input per call; "n" is the call sequence number
+ * and selects which block of test input to process.
+ */
+using Kernel = std::function<Output(const size_t n)>;
+using KernelFactory = std::function<Kernel()>;
+
+void add(
+	const std::string& name,
+	const size_t samples_per_call,
+	KernelFactory factory
+);
+
+/* Command line:
+ *   [--checksums] [--calls N] [name-filter ...]
+ * --checksums prints only "name checksum" lines, for diffing against golden output.
+ */
+int run(int argc, char* argv[]);
+
+} /* namespace host_bench */
+
+#endif/*__HOST_BENCH_H__*/
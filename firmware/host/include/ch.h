@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_CH_H__
+#define __HOST_CH_H__
+
+/* Host stand-in for the parts of ChibiOS <ch.h> that the shared message
+ * definitions and the baseband processors use.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+using msg_t = int32_t;
+using tprio_t = uint32_t;
+using eventmask_t = uint32_t;
+
+#define EVENT_MASK(eid) ((eventmask_t)(1 << (eid)))
+
+/* There's no scheduler: signalled events collect in the thread until the
+ * host code standing in for its loop takes them.
+ */
+struct Thread {
+	eventmask_t pending_events;
+};
+
+inline void chEvtSignal(Thread* const tp, const eventmask_t mask) {
+	tp->pending_events |= mask;
+}
+
+inline void chEvtSignalI(Thread* const tp, const eventmask_t mask) {
+	tp->pending_events |= mask;
+}
+
+inline void chDbgPanic(const char* const msg) {
+	std::fprintf(stderr, "panic: %s\n", msg);
+	std::abort();
+}
+
+#endif/*__HOST_CH_H__*/
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CMSIS_SIMD_HOST_H__
+#define __CMSIS_SIMD_HOST_H__
+
+/* Portable C++ emulation of the Cortex-M4 intrinsics used by the baseband
+ * DSP code (CMSIS core_cm4_simd.h plus the overloads in lpc43xx_m4.h).
+ * Every function reproduces the instruction's result bit-for-bit, including
+ * wrap-around and saturation behavior, so kernels produce identical output on
+ * host and target. Flags (Q, GE) are not modeled.
+ */
+
+#include <cstdint>
+#include <atomic>
+
+#define __SIMD32_TYPE int32_t
+#define __SIMD32(addr)  (*(__SIMD32_TYPE **) & (addr))
+#define _SIMD32_OFFSET(addr)  (*(__SIMD32_TYPE *)  (addr))
+
+namespace cmsis_host {
+
+inline int32_t lo(const uint32_t v) { return static_cast<int16_t>(v & 0xffff); }
+inline int32_t hi(const uint32_t v) { return static_cast<int16_t>(v >> 16); }
+
+inline uint32_t ror(const uint32_t v, const uint32_t n) {
+	return (n & 31) ? ((v >> (n & 31)) | (v << (32 - (n & 31)))) : v;
+}
+
+inline int32_t sat(const int64_t v, const uint32_t bits) {
+	const int64_t max = (int64_t(1) << (bits - 1)) - 1;
+	const int64_t min = -(int64_t(1) << (bits - 1));
+	return (v > max) ? max : ((v < min) ? min : v);
+}
+
+inline uint32_t pack(const int32_t b, const int32_t t) {
+	return (static_cast<uint32_t>(b) & 0xffff) | (static_cast<uint32_t>(t) << 16);
+}
+
+} /* namespace cmsis_host */
+
+/* Packing, extension, bit manipulation */
+
+inline uint32_t __PKHBT(const uint32_t a, const uint32_t b, const uint32_t sh) {
+	return (a & 0x0000ffff) | ((b << sh) & 0xffff0000);
+}
+
+inline uint32_t __PKHTB(const uint32_t a, const uint32_t b, const uint32_t sh) {
+	return (a & 0xffff0000) | ((static_cast<uint32_t>(static_cast<int32_t>(b) >> sh)) & 0x0000ffff);
+}
+
+inline int32_t __SXTB16(const uint32_t rm, const uint32_t r = 0) {
+	const auto v = cmsis_host::ror(rm, r);
+	return cmsis_host::pack(static_cast<int8_t>(v & 0xff), static_cast<int8_t>((v >> 16) & 0xff));
+}
+
+inline int32_t __SXTH(const uint32_t rm, const uint32_t r) {
+	return static_cast<int16_t>(cmsis_host::ror(rm, r) & 0xffff);
+}
+
+inline int32_t __SXTAH(const uint32_t rn, const uint32_t rm, const uint32_t r) {
+	return static_cast<int32_t>(rn + static_cast<uint32_t>(__SXTH(rm, r)));
+}
+
+inline uint32_t __BFI(const uint32_t rd, const uint32_t rn, const uint32_t lsb, const uint32_t width) {
+	const uint32_t mask = ((width >= 32) ? 0xffffffffU : ((1U << width) - 1)) << lsb;
+	return (rd & ~mask) | ((rn << lsb) & mask);
+}
+
+inline uint32_t __REV(const uint32_t v) {
+	return __builtin_bswap32(v);
+}
+
+inline uint32_t __REV16(const uint32_t v) {
+	return ((v & 0x00ff00ff) << 8) | ((v >> 8) & 0x00ff00ff);
+}
+
+inline uint32_t __RBIT(uint32_t v) {
+	v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+	v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+	v = ((v >> 4) & 0x0f0f0f0f) | ((v & 0x0f0f0f0f) << 4);
+	return __builtin_bswap32(v);
+}
+
+inline uint8_t __CLZ(const uint32_t v) {
+	return v ? __builtin_clz(v) : 32;
+}
+
+/* Saturation */
+
+inline int32_t __SSAT(const int32_t v, const uint32_t bits) {
+	return cmsis_host::sat(v, bits);
+}
+
+inline uint32_t __USAT(const int32_t v, const uint32_t bits) {
+	const int32_t max = (bits >= 32) ? 0x7fffffff : ((1 << bits) - 1);
+	return (v < 0) ? 0 : ((v > max) ? max : v);
+}
+
+inline int32_t __QADD(const int32_t a, const int32_t b) {
+	return cmsis_host::sat(int64_t(a) + b, 32);
+}
+
+inline int32_t __QSUB(const int32_t a, const int32_t b) {
+	return cmsis_host::sat(int64_t(a) - b, 32);
+}
+
+inline uint32_t __QADD16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack(sat(lo(a) + lo(b), 16), sat(hi(a) + hi(b), 16));
+}
+
+inline uint32_t __QSUB16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack(sat(lo(a) - lo(b), 16), sat(hi(a) - hi(b), 16));
+}
+
+inline uint32_t __SADD16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack(lo(a) + lo(b), hi(a) + hi(b));
+}
+
+inline uint32_t __SSUB16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack(lo(a) - lo(b), hi(a) - hi(b));
+}
+
+inline uint32_t __SHADD16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack((lo(a) + lo(b)) >> 1, (hi(a) + hi(b)) >> 1);
+}
+
+inline uint32_t __SHSUB16(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return pack((lo(a) - lo(b)) >> 1, (hi(a) - hi(b)) >> 1);
+}
+
+/* 16x16 multiplies. Accumulation wraps at 32 bits, as on the target. */
+
+inline int32_t __SMULBB(const uint32_t a, const uint32_t b) { return cmsis_host::lo(a) * cmsis_host::lo(b); }
+inline int32_t __SMULBT(const uint32_t a, const uint32_t b) { return cmsis_host::lo(a) * cmsis_host::hi(b); }
+inline int32_t __SMULTB(const uint32_t a, const uint32_t b) { return cmsis_host::hi(a) * cmsis_host::lo(b); }
+inline int32_t __SMULTT(const uint32_t a, const uint32_t b) { return cmsis_host::hi(a) * cmsis_host::hi(b); }
+
+inline int32_t __SMLABB(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMULBB(a, b)));
+}
+
+inline int32_t __SMLATB(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMULTB(a, b)));
+}
+
+inline int32_t __SMUAD(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return static_cast<int32_t>(static_cast<uint32_t>(lo(a) * lo(b)) + static_cast<uint32_t>(hi(a) * hi(b)));
+}
+
+inline int32_t __SMUADX(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return static_cast<int32_t>(static_cast<uint32_t>(lo(a) * hi(b)) + static_cast<uint32_t>(hi(a) * lo(b)));
+}
+
+inline int32_t __SMUSD(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return static_cast<int32_t>(static_cast<uint32_t>(lo(a) * lo(b)) - static_cast<uint32_t>(hi(a) * hi(b)));
+}
+
+inline int32_t __SMUSDX(const uint32_t a, const uint32_t b) {
+	using namespace cmsis_host;
+	return static_cast<int32_t>(static_cast<uint32_t>(lo(a) * hi(b)) - static_cast<uint32_t>(hi(a) * lo(b)));
+}
+
+inline int32_t __SMLAD(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMUAD(a, b)));
+}
+
+inline int32_t __SMLADX(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMUADX(a, b)));
+}
+
+inline int32_t __SMLSD(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMUSD(a, b)));
+}
+
+inline int32_t __SMLSDX(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return static_cast<int32_t>(acc + static_cast<uint32_t>(__SMUSDX(a, b)));
+}
+
+inline int64_t __SMLALD(const uint32_t a, const uint32_t b, const int64_t acc) {
+	using namespace cmsis_host;
+	return acc + int64_t(lo(a) * lo(b)) + int64_t(hi(a) * hi(b));
+}
+
+inline int64_t __SMLALDX(const uint32_t a, const uint32_t b, const int64_t acc) {
+	using namespace cmsis_host;
+	return acc + int64_t(lo(a) * hi(b)) + int64_t(hi(a) * lo(b));
+}
+
+inline int64_t __SMLSLD(const uint32_t a, const uint32_t b, const int64_t acc) {
+	using namespace cmsis_host;
+	return acc + int64_t(lo(a) * lo(b)) - int64_t(hi(a) * hi(b));
+}
+
+inline int64_t __SMLSLDX(const uint32_t a, const uint32_t b, const int64_t acc) {
+	using namespace cmsis_host;
+	return acc + int64_t(lo(a) * hi(b)) - int64_t(hi(a) * lo(b));
+}
+
+/* 32x32 most-significant-word multiplies */
+
+inline int32_t __SMMUL(const int32_t a, const int32_t b) {
+	return static_cast<int32_t>((int64_t(a) * b) >> 32);
+}
+
+inline int32_t __SMMULR(const int32_t a, const int32_t b) {
+	return static_cast<int32_t>((int64_t(a) * b + 0x80000000LL) >> 32);
+}
+
+inline int32_t __SMMLA(const int32_t a, const int32_t b, const int32_t acc) {
+	return static_cast<int32_t>(((int64_t(acc) << 32) + int64_t(a) * b) >> 32);
+}
+
+/* Barriers and inter-core events. On the host, "cores" are threads. */
+
+inline void __DMB() { std::atomic_thread_fence(std::memory_order_seq_cst); }
+inline void __DSB() { std::atomic_thread_fence(std::memory_order_seq_cst); }
+inline void __ISB() { std::atomic_thread_fence(std::memory_order_seq_cst); }
+inline void __SEV() { }
+inline void __WFE() { }
+inline void __NOP() { }
+
+#endif/*__CMSIS_SIMD_HOST_H__*/
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_FILE_H__
+#define __HOST_FILE_H__
+
+/* Host stand-in for the FatFs-backed File (application/file.hpp): just the
+ * writing half, on top of stdio, for running file writers on the host.
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <array>
+
+class File {
+public:
+	~File() {
+		close();
+	}
+
+	bool open(const std::string& file_path) {
+		close();
+		f = std::fopen(file_path.c_str(), "wb");
+		return f != nullptr;
+	}
+
+	bool close() {
+		if( f ) {
+			std::fclose(f);
+			f = nullptr;
+		}
+		return true;
+	}
+
+	bool write(const void* const data, const size_t bytes_to_write) {
+		return f && (std::fwrite(data, 1, bytes_to_write, f) == bytes_to_write);
+	}
+
+	template<size_t N>
+	bool write(const std::array<uint8_t, N>& data) {
+		return write(data.data(), N);
+	}
+
+private:
+	std::FILE* f { nullptr };
+};
+
+#endif/*__HOST_FILE_H__*/
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_HAL_H__
+#define __HOST_HAL_H__
+
+/* Host stand-in for ChibiOS <hal.h>, as included by the baseband DSP code. */
+
+#include "lpc43xx_m4.h"
+
+#include <cstdint>
+#include <chrono>
+
+using halrtcnt_t = uint32_t;
+
+/* Stands in for the DWT cycle counter: nanoseconds, wrapping at 32 bits like
+ * the real counter, so differences come out right.
+ */
+inline halrtcnt_t halGetCounterValue() {
+	const auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<halrtcnt_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+#endif/*__HOST_HAL_H__*/
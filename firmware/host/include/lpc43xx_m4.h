@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_LPC43XX_M4_H__
+#define __HOST_LPC43XX_M4_H__
+
+/* Host stand-in for the LPC43xx M4 device header. Provides the CMSIS
+ * intrinsics and just enough peripheral definitions for baseband headers
+ * that touch them (e.g. Timestamp::now() in buffer.hpp).
+ */
+
+#include "cmsis_simd_host.h"
+
+#include <cstdint>
+
+typedef struct {
+	volatile uint32_t CTIME0;
+	volatile uint32_t CTIME1;
+} LPC_RTC_Type;
+
+static LPC_RTC_Type host_rtc __attribute__((unused));
+
+#define LPC_RTC (&host_rtc)
+
+#endif/*__HOST_LPC43XX_M4_H__*/
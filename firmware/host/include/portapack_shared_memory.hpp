@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PORTAPACK_SHARED_MEMORY_H__
+#define __PORTAPACK_SHARED_MEMORY_H__
+
+/* Host stand-in for the M4/M0 shared memory. Found ahead of
+ * common/portapack_shared_memory.hpp on the host include path.
+ *
+ * Messages a processor pushes to the application queue go straight to a
+ * handler, in the order they were pushed, instead of across to the M0.
+ */
+
+#include "message.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+class HostMessageQueue {
+public:
+	using Handler = std::function<void(const Message* const message, const size_t size)>;
+
+	template<typename T>
+	bool push(const T& message) {
+		static_assert(sizeof(T) <= Message::MAX_SIZE, "Message::MAX_SIZE too small for message type");
+		static_assert(std::is_base_of<Message, T>::value, "type is not based on Message");
+
+		if( handler ) {
+			handler(&message, sizeof(message));
+		}
+		return true;
+	}
+
+	Handler handler;
+};
+
+struct SharedMemory {
+	HostMessageQueue application_queue;
+};
+
+extern SharedMemory& shared_memory;
+
+#endif/*__PORTAPACK_SHARED_MEMORY_H__*/
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "iq_synth.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+namespace iq_synth {
+
+uint32_t Random::next() {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+uint_fast8_t Random::bit() {
+	return (next() >> 31) & 1;
+}
+
+double Random::uniform() {
+	/* (0, 1], never zero, so it's safe to take the log of. */
+	return (static_cast<double>(next()) + 1.0) / 4294967296.0;
+}
+
+double Random::gaussian() {
+	const double u1 = uniform();
+	const double u2 = uniform();
+	return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
+
+Recording::Recording(
+	const uint32_t sampling_rate,
+	const double seconds
+) : sampling_rate_ { sampling_rate },
+	samples(static_cast<size_t>(seconds * sampling_rate))
+{
+}
+
+size_t Recording::sample_at(const double seconds) const {
+	return static_cast<size_t>(seconds * sampling_rate_);
+}
+
+void Recording::add_fsk(
+	const size_t start,
+	const std::vector<uint8_t>& symbols,
+	const double symbol_rate,
+	const double center_frequency,
+	const double deviation,
+	const double amplitude,
+	const double bt
+) {
+	const double samples_per_symbol = sampling_rate_ / symbol_rate;
+	const size_t length = static_cast<size_t>(symbols.size() * samples_per_symbol);
+
+	/* Instantaneous frequency, in units of deviation. */
+	std::vector<double> frequency(length);
+	for(size_t n=0; n<length; n++) {
+		frequency[n] = symbols[static_cast<size_t>(n / samples_per_symbol)] ? 1.0 : -1.0;
+	}
+
+	if( bt > 0.0 ) {
+		const double sigma = samples_per_symbol * std::sqrt(std::log(2.0)) / (2.0 * M_PI * bt);
+		const int half = static_cast<int>(std::ceil(3.0 * sigma));
+		std::vector<double> pulse(2 * half + 1);
+		double pulse_sum = 0.0;
+		for(int k=-half; k<=half; k++) {
+			pulse[k + half] = std::exp(-0.5 * (k * k) / (sigma * sigma));
+			pulse_sum += pulse[k + half];
+		}
+
+		std::vector<double> shaped(length);
+		for(size_t n=0; n<length; n++) {
+			double acc = 0.0;
+			for(int k=-half; k<=half; k++) {
+				/* Hold the first and last symbols beyond the ends. */
+				const auto i = std::min(std::max(static_cast<long>(n) + k, 0L), static_cast<long>(length) - 1);
+				acc += pulse[k + half] * frequency[i];
+			}
+			shaped[n] = acc / pulse_sum;
+		}
+		frequency.swap(shaped);
+	}
+
+	double phase = 0.0;
+	for(size_t n=0; (n<length) && ((start + n) < samples.size()); n++) {
+		const double f = center_frequency + deviation * frequency[n];
+		samples[start + n] += std::polar(amplitude, phase);
+		phase = std::fmod(phase + 2.0 * M_PI * f / sampling_rate_, 2.0 * M_PI);
+	}
+}
+
+void Recording::add_ook(
+	const size_t start,
+	const std::vector<uint8_t>& chips,
+	const double chip_rate,
+	const double center_frequency,
+	const double amplitude
+) {
+	const double samples_per_chip = sampling_rate_ / chip_rate;
+	const size_t length = static_cast<size_t>(chips.size() * samples_per_chip);
+
+	const double w = 2.0 * M_PI * center_frequency / sampling_rate_;
+	for(size_t n=0; (n<length) && ((start + n) < samples.size()); n++) {
+		if( chips[static_cast<size_t>(n / samples_per_chip)] ) {
+			samples[start + n] += std::polar(amplitude, std::fmod(w * (start + n), 2.0 * M_PI));
+		}
+	}
+}
+
+void Recording::add_noise(const double sigma, Random& random) {
+	for(auto& s : samples) {
+		const double re = random.gaussian();
+		const double im = random.gaussian();
+		s += std::complex<double> { re * sigma, im * sigma };
+	}
+}
+
+std::vector<complex8_t> Recording::quantize() const {
+	std::vector<complex8_t> result(samples.size());
+	auto clip8 = [](const double v) {
+		return static_cast<int8_t>(std::max(-128.0, std::min(127.0, std::round(v))));
+	};
+	std::transform(samples.begin(), samples.end(), result.begin(),
+		[&clip8](const std::complex<double>& s) -> complex8_t {
+			return { clip8(s.real()), clip8(s.imag()) };
+		}
+	);
+	return result;
+}
+
+bool Recording::write(const std::string& path) const {
+	const auto data = quantize();
+	auto f = std::fopen(path.c_str(), "wb");
+	if( f == nullptr ) {
+		return false;
+	}
+	const auto written = std::fwrite(data.data(), sizeof(complex8_t), data.size(), f);
+	return (std::fclose(f) == 0) && (written == data.size());
+}
+
+namespace {
+
+void append_bits(std::vector<uint8_t>& bits, const uint64_t value, const size_t length) {
+	for(size_t i=0; i<length; i++) {
+		bits.push_back((value >> (length - 1 - i)) & 1);
+	}
+}
+
+void append_alternating(std::vector<uint8_t>& bits, const size_t length) {
+	for(size_t i=0; i<length; i++) {
+		bits.push_back(i & 1);
+	}
+}
+
+std::vector<uint8_t> manchester(const std::vector<uint8_t>& bits) {
+	std::vector<uint8_t> chips;
+	for(const auto b : bits) {
+		chips.push_back(b);
+		chips.push_back(b ^ 1);
+	}
+	return chips;
+}
+
+std::vector<uint8_t> random_bits(Random& random, const size_t length) {
+	std::vector<uint8_t> bits(length);
+	for(auto& b : bits) {
+		b = random.bit();
+	}
+	return bits;
+}
+
+/* HDLC frame check sequence: CRC-16/X.25, reflected. */
+uint16_t fcs16(const std::vector<uint8_t>& bytes) {
+	uint16_t crc = 0xffff;
+	for(const auto byte : bytes) {
+		crc ^= byte;
+		for(size_t i=0; i<8; i++) {
+			crc = (crc & 1) ? ((crc >> 1) ^ 0x8408) : (crc >> 1);
+		}
+	}
+	return crc ^ 0xffff;
+}
+
+} /* namespace */
+
+std::vector<uint8_t> ais_symbols(const std::vector<uint8_t>& payload) {
+	/* HDLC: bytes LSB first, FCS low byte first, a zero stuffed after every
+	 * five consecutive ones between the flags.
+	 */
+	auto bytes = payload;
+	const auto fcs = fcs16(payload);
+	bytes.push_back(fcs & 0xff);
+	bytes.push_back(fcs >> 8);
+
+	std::vector<uint8_t> bits;
+	append_alternating(bits, 24);
+	append_bits(bits, 0b01111110, 8);
+	size_t ones = 0;
+	for(const auto byte : bytes) {
+		for(size_t i=0; i<8; i++) {
+			const uint8_t bit = (byte >> i) & 1;
+			bits.push_back(bit);
+			ones = bit ? (ones + 1) : 0;
+			if( ones == 5 ) {
+				bits.push_back(0);
+				ones = 0;
+			}
+		}
+	}
+	append_bits(bits, 0b01111110, 8);
+	append_bits(bits, 0, 8);
+
+	/* NRZI: a zero is sent as a change of level. */
+	std::vector<uint8_t> symbols;
+	uint8_t level = 0;
+	for(const auto bit : bits) {
+		if( bit == 0 ) {
+			level ^= 1;
+		}
+		symbols.push_back(level);
+	}
+	return symbols;
+}
+
+std::vector<uint8_t> tpms_symbols(const std::vector<uint8_t>& payload_bits) {
+	std::vector<uint8_t> symbols;
+	append_alternating(symbols, 36);
+	append_bits(symbols, 0b10, 2);
+	const auto chips = manchester(payload_bits);
+	symbols.insert(symbols.end(), chips.begin(), chips.end());
+	append_alternating(symbols, 8);
+	return symbols;
+}
+
+std::vector<uint8_t> ert_scm_chips(const std::vector<uint8_t>& payload_bits) {
+	std::vector<uint8_t> bits;
+	append_bits(bits, 0x1f2a60, 21);
+	bits.insert(bits.end(), payload_bits.begin(), payload_bits.end());
+	return manchester(bits);
+}
+
+std::vector<uint8_t> ert_idm_chips(const std::vector<uint8_t>& payload_bits) {
+	std::vector<uint8_t> bits;
+	append_bits(bits, 0x555516a3, 32);
+	bits.insert(bits.end(), payload_bits.begin(), payload_bits.end());
+	return manchester(bits);
+}
+
+namespace {
+
+/* Each burst: start time (s), frequency offset from the channel (Hz),
+ * amplitude (complex8_t units).
+ */
+struct Burst {
+	double start;
+	double offset;
+	double amplitude;
+};
+
+constexpr double noise_sigma = 4.0;
+
+bool synthesize_ais(const std::string& path) {
+	/* Radio tuned fs/4 below 162MHz: 87B at fs/4 - 25kHz, 88B at fs/4 + 25kHz. */
+	constexpr uint32_t fs = 2457600;
+	constexpr double channel_87b = fs / 4.0 - 25000.0;
+	constexpr double channel_88b = fs / 4.0 + 25000.0;
+
+	const Burst bursts[] {
+		{ 0.010, channel_87b,          40.0 },
+		{ 0.045, channel_88b,          40.0 },
+		{ 0.080, channel_87b + 500.0, 10.0 },
+		{ 0.080, channel_88b - 500.0, 10.0 },
+		{ 0.115, channel_88b,           2.0 },
+	};
+
+	Random random { 0xa15 };
+	Recording recording { fs, 0.150 };
+	for(const auto& burst : bursts) {
+		/* Message type 1, the rest random: 168 bits. */
+		std::vector<uint8_t> payload(21);
+		for(auto& byte : payload) {
+			byte = random.next() & 0xff;
+		}
+		payload[0] = (payload[0] & 0x03) | (1 << 2);
+		recording.add_fsk(recording.sample_at(burst.start), ais_symbols(payload), 9600, burst.offset, 2400, burst.amplitude, 0.4);
+	}
+	recording.add_noise(noise_sigma, random);
+	return recording.write(path);
+}
+
+bool synthesize_tpms(const std::string& path) {
+	constexpr uint32_t fs = 2457600;
+	constexpr double channel = fs / 4.0;
+
+	const Burst bursts[] {
+		{ 0.005, channel,           40.0 },
+		{ 0.025, channel + 10000.0, 10.0 },
+		{ 0.045, channel - 10000.0,  3.0 },
+		{ 0.065, channel,            1.0 },
+	};
+
+	Random random { 0x7e55 };
+	Recording recording { fs, 0.085 };
+	for(const auto& burst : bursts) {
+		recording.add_fsk(recording.sample_at(burst.start), tpms_symbols(random_bits(random, 128)), 19200, burst.offset, 38400, burst.amplitude);
+	}
+	recording.add_noise(noise_sigma, random);
+	return recording.write(path);
+}
+
+bool synthesize_ert(const std::string& path) {
+	constexpr uint32_t fs = 4194304;
+	constexpr double channel = fs / 4.0;
+
+	Random random { 0xe27 };
+	Recording recording { fs, 0.140 };
+	recording.add_ook(recording.sample_at(0.005), ert_scm_chips(random_bits(random, 75)), 32768, channel, 40.0);
+	recording.add_ook(recording.sample_at(0.020), ert_idm_chips(random_bits(random, 704)), 32768, channel, 40.0);
+	recording.add_ook(recording.sample_at(0.075), ert_scm_chips(random_bits(random, 75)), 32768, channel, 8.0);
+	recording.add_ook(recording.sample_at(0.090), ert_idm_chips(random_bits(random, 704)), 32768, channel, 8.0);
+	recording.add_noise(noise_sigma, random);
+	return recording.write(path);
+}
+
+} /* namespace */
+
+bool synthesize(const std::string& scenario, const std::string& path) {
+	if( scenario == "ais" ) {
+		return synthesize_ais(path);
+	}
+	if( scenario == "tpms" ) {
+		return synthesize_tpms(path);
+	}
+	if( scenario == "ert" ) {
+		return synthesize_ert(path);
+	}
+	return false;
+}
+
+} /* namespace iq_synth */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IQ_SYNTH_H__
+#define __IQ_SYNTH_H__
+
+/* Deterministic test recordings for the replay tool: packets of the
+ * protocols the baseband decodes (AIS, TPMS, ERT) at known times, levels
+ * and frequency offsets, in Gaussian noise, quantized to complex8_t as the
+ * HackRF delivers them.
+ *
+ * Everything random comes from a private generator with a fixed seed, so a
+ * recording is byte-for-byte identical on every host.
+ */
+
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+#include <string>
+#include <vector>
+
+namespace iq_synth {
+
+/* xorshift32, plus Box-Muller for Gaussian samples. */
+class Random {
+public:
+	explicit Random(const uint32_t seed) : state { seed ? seed : 1 } { }
+
+	uint32_t next();
+	uint_fast8_t bit();
+	double uniform();
+	double gaussian();
+
+private:
+	uint32_t state;
+};
+
+class Recording {
+public:
+	Recording(
+		const uint32_t sampling_rate,
+		const double seconds
+	);
+
+	uint32_t sampling_rate() const {
+		return sampling_rate_;
+	}
+
+	size_t sample_at(const double seconds) const;
+
+	/* Continuous-phase FSK: symbol 1 at center + deviation, 0 at
+	 * center - deviation. bt > 0 applies Gaussian pulse shaping (GMSK).
+	 */
+	void add_fsk(
+		const size_t start,
+		const std::vector<uint8_t>& symbols,
+		const double symbol_rate,
+		const double center_frequency,
+		const double deviation,
+		const double amplitude,
+		const double bt = 0.0
+	);
+
+	/* On-off keying: carrier at center_frequency during each 1 chip. */
+	void add_ook(
+		const size_t start,
+		const std::vector<uint8_t>& chips,
+		const double chip_rate,
+		const double center_frequency,
+		const double amplitude
+	);
+
+	void add_noise(const double sigma, Random& random);
+
+	/* Rounds and saturates to complex8_t. */
+	std::vector<complex8_t> quantize() const;
+
+	bool write(const std::string& path) const;
+
+private:
+	const uint32_t sampling_rate_;
+	std::vector<std::complex<double>> samples;
+};
+
+/* Protocol framing: symbol sequences exactly as they go over the air. */
+std::vector<uint8_t> ais_symbols(const std::vector<uint8_t>& payload);
+std::vector<uint8_t> tpms_symbols(const std::vector<uint8_t>& payload_bits);
+std::vector<uint8_t> ert_scm_chips(const std::vector<uint8_t>& payload_bits);
+std::vector<uint8_t> ert_idm_chips(const std::vector<uint8_t>& payload_bits);
+
+/* Named test scenarios, with the sampling rate each processor expects. */
+bool synthesize(const std::string& scenario, const std::string& path);
+
+} /* namespace iq_synth */
+
+#endif/*__IQ_SYNTH_H__*/
@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Packets decoded per second, with baseband::Packet, FieldReader and
+ * ManchesterDecoder against the bit-at-a-time versions they replaced
+ * (std::bitset storage, a loop over bits for every field, one symbol at a
+ * time through the Manchester decoder):
+ *
+ * - AIS: the FCS and the fields of a position report, through the byte
+ *   reversing reader, as ais::Packet reads them
+ * - ERT: an SCM packet's BCH check, ID and consumption, plus the
+ *   formatted hex the logger writes, as ert::Packet reads them
+ * - TPMS: the ten bytes for the CRC checks, ID, pressure and temperature,
+ *   plus the formatted hex, as tpms::Packet reads them
+ *
+ * First, every field read of every length at every position, on packets
+ * of every size, must match between the two.
+ */
+
+#include "baseband_packet.hpp"
+#include "field_reader.hpp"
+#include "manchester.hpp"
+#include "crc.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <bitset>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+
+namespace {
+
+/* The previous implementations, as they were. */
+
+/* As in application/string_format.cpp, which needs the RTC. */
+void to_string_hex_internal(char* p, const uint32_t n, const int32_t l) {
+	const uint32_t d = n & 0xf;
+	p[l] = (d > 9) ? (d + 87) : (d + 48);
+	if( l > 0 ) {
+		to_string_hex_internal(p, n >> 4, l - 1);
+	}
+}
+
+std::string to_string_hex(const uint32_t n, const int32_t l) {
+	char p[16];
+	to_string_hex_internal(p, n, l - 1);
+	p[l] = 0;
+	return p;
+}
+
+class LegacyPacket {
+public:
+	void add(const bool symbol) {
+		if( count < data.size() ) {
+			data[count++] = symbol;
+		}
+	}
+
+	uint_fast8_t operator[](const size_t index) const {
+		return (index < size()) ? data[index] : 0;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+private:
+	std::bitset<1408> data;
+	size_t count { 0 };
+};
+
+template<typename T, typename BitRemap>
+class LegacyFieldReader {
+public:
+	constexpr LegacyFieldReader(
+		const T& data
+	) : data { data }
+	{
+	}
+
+	uint32_t read(const size_t start_bit, const size_t length) const {
+		uint32_t value = 0;
+		for(size_t i=start_bit; i<(start_bit + length); i++) {
+			value = (value << 1) | data[bit_remap(i)];
+		}
+		return value;
+	}
+
+private:
+	const T& data;
+	const BitRemap bit_remap { };
+};
+
+class LegacyManchesterDecoder {
+public:
+	constexpr LegacyManchesterDecoder(
+		const LegacyPacket& packet,
+		const size_t sense = 0
+	) : packet { packet },
+		sense { sense }
+	{
+	}
+
+	ManchesterDecoder::DecodedSymbol operator[](const size_t index) const {
+		const size_t encoded_index = index * 2;
+		if( (encoded_index + 1) < packet.size() ) {
+			const auto value = packet[encoded_index + sense];
+			const auto error = packet[encoded_index + 0] == packet[encoded_index + 1];
+			return { value, error };
+		} else {
+			return { 0, 1 };
+		}
+	}
+
+	size_t symbols_count() const {
+		return packet.size() / 2;
+	}
+
+private:
+	const LegacyPacket& packet;
+	const size_t sense;
+};
+
+ManchesterFormatted legacy_format_manchester(
+	const LegacyManchesterDecoder& decoder
+) {
+	const size_t payload_length_decoded = decoder.symbols_count();
+	const size_t payload_length_hex_characters = (payload_length_decoded + 3) / 4;
+	const size_t payload_length_symbols_rounded = payload_length_hex_characters * 4;
+
+	std::string hex_data;
+	std::string hex_error;
+	hex_data.reserve(payload_length_hex_characters);
+	hex_error.reserve(payload_length_hex_characters);
+
+	uint_fast8_t data = 0;
+	uint_fast8_t error = 0;
+	for(size_t i=0; i<payload_length_symbols_rounded; i++) {
+		const auto symbol = decoder[i];
+
+		data <<= 1;
+		data |= symbol.value;
+
+		error <<= 1;
+		error |= symbol.error;
+
+		if( (i & 3) == 3 ) {
+			hex_data += to_string_hex(data & 0xf, 1);
+			hex_error += to_string_hex(error & 0xf, 1);
+		}
+	}
+
+	return { hex_data, hex_error };
+}
+
+/* Bypasses FieldReader's fast paths, to check them against. */
+struct RemapNoneBitwise {
+	constexpr size_t operator()(const size_t bit_index) const {
+		return bit_index;
+	}
+};
+
+struct Word {
+	using Packet = baseband::Packet;
+	using Manchester = ManchesterDecoder;
+	template<typename T> using Reader = FieldReader<T, BitRemapNone>;
+	template<typename T> using ReverseReader = FieldReader<T, BitRemapByteReverse>;
+
+	static ManchesterFormatted format(const Manchester& decoder) {
+		return format_manchester(decoder);
+	}
+};
+
+struct Legacy {
+	using Packet = LegacyPacket;
+	using Manchester = LegacyManchesterDecoder;
+	template<typename T> using Reader = LegacyFieldReader<T, BitRemapNone>;
+	template<typename T> using ReverseReader = LegacyFieldReader<T, BitRemapByteReverse>;
+
+	static ManchesterFormatted format(const Manchester& decoder) {
+		return legacy_format_manchester(decoder);
+	}
+};
+
+class Random {
+public:
+	uint32_t operator()() {
+		state = state * 1103515245 + 12345;
+		return state >> 8;
+	}
+
+private:
+	uint32_t state { 1 };
+};
+
+template<typename Packet>
+Packet make_packet(const std::vector<bool>& bits) {
+	Packet packet;
+	for(const auto bit : bits) {
+		packet.add(bit);
+	}
+	return packet;
+}
+
+std::vector<bool> random_bits(Random& random, const size_t count) {
+	std::vector<bool> bits(count);
+	for(size_t i=0; i<count; i++) {
+		bits[i] = random() & 1;
+	}
+	return bits;
+}
+
+/* Valid Manchester, with the odd error thrown in. */
+std::vector<bool> random_manchester(Random& random, const size_t symbols) {
+	std::vector<bool> bits;
+	for(size_t i=0; i<symbols; i++) {
+		const bool value = random() & 1;
+		const bool error = (random() % 61) == 0;
+		bits.push_back(value);
+		bits.push_back(error ? value : !value);
+	}
+	return bits;
+}
+
+bool check_packet(const std::vector<bool>& bits) {
+	// Refill a packet that held something else, as PacketBuilder does.
+	baseband::Packet word;
+	for(size_t i=0; i<1408; i++) {
+		word.add(true);
+	}
+	word.clear();
+	for(const auto bit : bits) {
+		word.add(bit);
+	}
+	const auto legacy = make_packet<LegacyPacket>(bits);
+
+	const FieldReader<baseband::Packet, BitRemapNone> word_none { word };
+	const FieldReader<baseband::Packet, BitRemapByteReverse> word_reverse { word };
+	const FieldReader<baseband::Packet, RemapNoneBitwise> word_bitwise { word };
+	const LegacyFieldReader<LegacyPacket, BitRemapNone> legacy_none { legacy };
+	const LegacyFieldReader<LegacyPacket, BitRemapByteReverse> legacy_reverse { legacy };
+
+	const size_t end = bits.size() + 40;
+	for(size_t start=0; start<end; start++) {
+		if( word[start] != legacy[start] ) {
+			return false;
+		}
+		for(size_t length=0; length<=32; length++) {
+			const auto expected = legacy_none.read(start, length);
+			if( (word_none.read(start, length) != expected)
+			 || (word_bitwise.read(start, length) != expected)
+			 || (word_reverse.read(start, length) != legacy_reverse.read(start, length)) ) {
+				return false;
+			}
+		}
+	}
+
+	for(size_t sense=0; sense<2; sense++) {
+		const ManchesterDecoder word_decoder { word, sense };
+		const LegacyManchesterDecoder legacy_decoder { legacy, sense };
+		const FieldReader<ManchesterDecoder, BitRemapNone> word_reader { word_decoder };
+		const LegacyFieldReader<LegacyManchesterDecoder, BitRemapNone> legacy_reader { legacy_decoder };
+
+		const size_t symbols_end = bits.size() / 2 + 40;
+		for(size_t start=0; start<symbols_end; start++) {
+			for(size_t length=1; length<=32; length++) {
+				uint32_t values = 0;
+				uint32_t errors = 0;
+				for(size_t i=start; i<start+length; i++) {
+					values = (values << 1) | legacy_decoder[i].value;
+					errors = (errors << 1) | legacy_decoder[i].error;
+				}
+				const auto decoded = word_decoder.symbols(start, length);
+				if( (decoded.values != values) || (decoded.errors != errors)
+				 || (word_reader.read(start, length) != legacy_reader.read(start, length)) ) {
+					return false;
+				}
+			}
+		}
+
+		const auto word_formatted = format_manchester(word_decoder);
+		const auto legacy_formatted = legacy_format_manchester(legacy_decoder);
+		if( (word_formatted.data != legacy_formatted.data) || (word_formatted.errors != legacy_formatted.errors) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool check() {
+	Random random;
+	for(size_t size=0; size<=1408; size+=(size < 80) ? 1 : 37) {
+		if( !check_packet(random_bits(random, size)) ) {
+			std::printf("mismatch, %zu bits\n", size);
+			return false;
+		}
+	}
+	return check_packet(random_bits(random, 1408));
+}
+
+/* Position report: 168 data bits, FCS, and what's left of the end flag. */
+template<typename Kit>
+uint32_t decode_ais(const typename Kit::Packet& packet) {
+	const typename Kit::template ReverseReader<typename Kit::Packet> field { packet };
+	const typename Kit::template Reader<typename Kit::Packet> field_crc { packet };
+
+	const size_t data_length = packet.size() - 7 - 16;
+	TableCRC<16, 0x1021> ais_fcs { 0xffff, 0xffff };
+	for(size_t i=0; i<data_length; i+=8) {
+		ais_fcs.process_byte(field_crc.read(i, 8));
+	}
+
+	uint32_t result = (ais_fcs.checksum() == field_crc.read(data_length, 16)) ? 1 : 0;
+	result += field.read(0, 6);
+	result += field.read(8, 30);
+	result += field.read(38, 4);
+	result += field.read(50, 10);
+	result += field.read(61, 28);
+	result += field.read(89, 27);
+	result += field.read(116, 12);
+	result += field.read(128, 9);
+	return result;
+}
+
+template<typename Kit>
+uint32_t decode_ert(const typename Kit::Packet& packet) {
+	const typename Kit::Manchester decoder { packet };
+	const typename Kit::template Reader<typename Kit::Manchester> reader { decoder };
+
+	TableCRC<16, 0x6f63> ert_bch;
+	const size_t start_bit = 5;
+	ert_bch.process_byte(reader.read(0, start_bit));
+	for(size_t i=start_bit; i<decoder.symbols_count(); i+=8) {
+		ert_bch.process_byte(reader.read(i, 8));
+	}
+
+	uint32_t result = (ert_bch.checksum() == 0) ? 1 : 0;
+	result += (reader.read(0, 2) << 24) | reader.read(35, 24);
+	result += reader.read(11, 24);
+
+	const auto formatted = Kit::format(decoder);
+	return result + formatted.data[0] + formatted.errors.back();
+}
+
+template<typename Kit>
+uint32_t decode_tpms(const typename Kit::Packet& packet) {
+	const typename Kit::Manchester decoder { packet, 1 };
+	const typename Kit::template Reader<typename Kit::Manchester> reader { decoder };
+
+	std::array<uint8_t, 10> bytes;
+	for(size_t i=0; i<bytes.size(); i++) {
+		bytes[i] = reader.read(i * 8, 8);
+	}
+
+	TableCRC<8, 0x01> crc_72 { 0x00 };
+	TableCRC<8, 0x01> crc_80 { 0x00 };
+	crc_72.process_bytes(&bytes[0], 9);
+	crc_80.process_bytes(&bytes[1], 9);
+
+	uint32_t result = crc_72.checksum() + crc_80.checksum();
+	result += reader.read(8, 32);
+	result += reader.read(48, 8);
+	result += reader.read(56, 8);
+
+	const auto formatted = Kit::format(decoder);
+	return result + formatted.data[0] + formatted.errors.back();
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Packet>
+double packets_per_second(const std::vector<Packet>& packets, const std::function<uint32_t(const Packet&)>& decode, uint32_t& sum) {
+	constexpr size_t passes = 2000;
+	uint32_t s = 0;
+	const auto start = Clock::now();
+	for(size_t pass=0; pass<passes; pass++) {
+		for(const auto& packet : packets) {
+			s += decode(packet);
+		}
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	sum = s;
+	return passes * packets.size() / elapsed.count();
+}
+
+bool report(
+	const char* const name,
+	const std::vector<std::vector<bool>>& bits,
+	const std::function<uint32_t(const LegacyPacket&)>& legacy_decode,
+	const std::function<uint32_t(const baseband::Packet&)>& word_decode
+) {
+	std::vector<LegacyPacket> legacy_packets;
+	std::vector<baseband::Packet> word_packets;
+	for(const auto& b : bits) {
+		legacy_packets.push_back(make_packet<LegacyPacket>(b));
+		word_packets.push_back(make_packet<baseband::Packet>(b));
+	}
+
+	uint32_t legacy_sum = 0;
+	uint32_t word_sum = 0;
+	const double legacy_rate = packets_per_second(legacy_packets, legacy_decode, legacy_sum);
+	const double word_rate = packets_per_second(word_packets, word_decode, word_sum);
+
+	const bool matches = (legacy_sum == word_sum);
+	std::printf("%-6s %14.0f %14.0f %8.1fx  %s\n",
+		name, legacy_rate, word_rate, word_rate / legacy_rate,
+		matches ? "agree" : "DIFFER"
+	);
+	return matches;
+}
+
+} /* namespace */
+
+int main() {
+	const bool fields_match = check();
+	std::printf("field reads: %s\n\n", fields_match ? "match" : "DIFFER");
+
+	Random random;
+	std::vector<std::vector<bool>> ais, ert, tpms;
+	for(size_t i=0; i<64; i++) {
+		ais.push_back(random_bits(random, 168 + 16 + 7));
+		ert.push_back(random_manchester(random, 96));
+		tpms.push_back(random_manchester(random, 80));
+	}
+
+	std::printf("%-6s %14s %14s %9s\n", "packet", "bitwise (/s)", "word (/s)", "speedup");
+	bool matches = fields_match;
+	matches &= report("AIS", ais, decode_ais<Legacy>, decode_ais<Word>);
+	matches &= report("ERT", ert, decode_ert<Legacy>, decode_ert<Word>);
+	matches &= report("TPMS", tpms, decode_tpms<Legacy>, decode_tpms<Word>);
+
+	return matches ? 0 : 1;
+}
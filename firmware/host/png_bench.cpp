@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Screenshot compression: PNGWriter's output size and encode time on
+ * synthetic screens, against the size of the stored (uncompressed) zlib
+ * stream it used to write. Also the throughput of the checksums it uses,
+ * against bit-at-a-time CRC-32 and per-byte-modulo Adler-32.
+ *
+ * The PNGs are left in the output directory, for checking with any viewer.
+ */
+
+#include "png_writer.hpp"
+#include "crc.hpp"
+#include "ui_font_fixed_8x16.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+
+namespace {
+
+constexpr int width = 240;
+constexpr int height = 320;
+
+using Scanline = std::array<ui::ColorRGB888, width>;
+using Screen = std::vector<Scanline>;
+
+/* What the stored-block writer produced: a 5-byte block header and filter
+ * byte per scanline, plus the PNG and zlib framing.
+ */
+constexpr size_t stored_size = 8 + 25 + (12 + 2 + height * (5 + 1 + width * 3) + 4) + 12;
+
+void fill(Screen& screen, const int top, const int bottom, const ui::ColorRGB888 c) {
+	for(int y=top; y<bottom; y++) {
+		screen[y].fill(c);
+	}
+}
+
+void text(Screen& screen, const int x0, const int y0, const std::string& s, const ui::ColorRGB888 fg, const ui::ColorRGB888 bg) {
+	const auto& font = ui::font::fixed_8x16;
+	for(size_t n=0; n<s.size(); n++) {
+		const auto glyph = font.glyph(s[n]);
+		const auto bits = glyph.pixels();
+		for(int i=0; i<glyph.w() * glyph.h(); i++) {
+			const int x = x0 + static_cast<int>(n) * glyph.w() + i % glyph.w();
+			const int y = y0 + i / glyph.w();
+			if( (x < width) && (y < height) ) {
+				screen[y][x] = ((bits[i >> 3] >> (i & 7)) & 1) ? fg : bg;
+			}
+		}
+	}
+}
+
+/* Status bar, then a menu. */
+Screen menu_screen() {
+	const ui::ColorRGB888 black { 0, 0, 0 };
+	const ui::ColorRGB888 white { 255, 255, 255 };
+	const ui::ColorRGB888 grey { 64, 64, 64 };
+
+	Screen screen(height);
+	fill(screen, 0, height, black);
+	fill(screen, 0, 16, grey);
+	text(screen, 0, 0, " <  PortaPack              ", white, grey);
+	const char* const items[] = { "Receiver", "Capture", "Sweep", "Setup", "Debug", "HackRF" };
+	int y = 24;
+	for(const auto item : items) {
+		text(screen, 8, y, item, white, black);
+		y += 24;
+	}
+	return screen;
+}
+
+/* Status bar, receiver controls, and a waterfall: the worst case, since
+ * the waterfall is close to noise.
+ */
+Screen waterfall_screen() {
+	const ui::ColorRGB888 black { 0, 0, 0 };
+	const ui::ColorRGB888 white { 255, 255, 255 };
+	const ui::ColorRGB888 grey { 64, 64, 64 };
+
+	Screen screen(height);
+	fill(screen, 0, height, black);
+	fill(screen, 0, 16, grey);
+	text(screen, 0, 0, " <  Audio                  ", white, grey);
+	text(screen, 0, 24, "433.920.000  LNA 32 VGA 24 ", white, black);
+	text(screen, 0, 40, "NFM 16k  VOL 25  SQ -90     ", white, black);
+
+	uint32_t seed = 1;
+	for(int y=80; y<height; y++) {
+		for(int x=0; x<width; x++) {
+			seed = seed * 1103515245 + 12345;
+			const int peak = (std::abs(x - 120) < 6) ? 160 : 0;
+			const uint8_t v = std::min(255, peak + static_cast<int>((seed >> 16) & 0x3f));
+			screen[y][x] = { v, static_cast<uint8_t>(v / 2), static_cast<uint8_t>(255 - v) };
+		}
+	}
+	return screen;
+}
+
+double seconds_of(const std::function<void()>& f, const size_t passes) {
+	const auto start = std::chrono::steady_clock::now();
+	for(size_t i=0; i<passes; i++) {
+		f();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - start).count() / passes;
+}
+
+size_t file_size(const std::string& path) {
+	std::FILE* const f = std::fopen(path.c_str(), "rb");
+	if( !f ) {
+		return 0;
+	}
+	std::fseek(f, 0, SEEK_END);
+	const auto size = std::ftell(f);
+	std::fclose(f);
+	return size;
+}
+
+void report_screen(const std::string& name, const Screen& screen, const std::string& directory, const size_t passes) {
+	const auto path = directory + "/" + name + ".png";
+	const auto seconds = seconds_of([&screen, &path]() {
+		PNGWriter png { path };
+		for(const auto& scanline : screen) {
+			png.write_scanline(scanline);
+		}
+	}, passes);
+
+	const auto size = file_size(path);
+	std::printf("%-10s %8zu %8zu %8.1fx %10.2f\n",
+		name.c_str(), stored_size, size,
+		static_cast<double>(stored_size) / size,
+		seconds * 1e3
+	);
+}
+
+/* The Adler-32 update PNGWriter used to do, reducing every byte. */
+class Adler32PerByte {
+public:
+	void feed(const uint8_t* const p, const size_t n) {
+		for(size_t i=0; i<n; i++) {
+			a = (a + p[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+	}
+
+	uint32_t value() const {
+		return (b << 16) | a;
+	}
+
+private:
+	uint32_t a { 1 };
+	uint32_t b { 0 };
+};
+
+void report_checksum(const char* const name, const std::function<uint32_t()>& f, const size_t bytes, const size_t passes) {
+	uint32_t value = 0;
+	const auto seconds = seconds_of([&f, &value]() { value = f(); }, passes);
+	std::printf("%-22s %10.1f MB/s   (%08x)\n", name, bytes / seconds / 1e6, value);
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	const std::string directory = (argc > 1) ? argv[1] : ".";
+	constexpr size_t passes = 20;
+
+	std::printf("%-10s %8s %8s %9s %10s\n", "screen", "stored", "deflate", "ratio", "ms/image");
+	report_screen("menu", menu_screen(), directory, passes);
+	report_screen("waterfall", waterfall_screen(), directory, passes);
+	std::printf("\n");
+
+	std::vector<uint8_t> data(256 * 1024);
+	uint32_t seed = 1;
+	for(auto& d : data) {
+		seed = seed * 1103515245 + 12345;
+		d = seed >> 24;
+	}
+
+	report_checksum("CRC-32 bitwise", [&data]() {
+		CRC<32, true, true> crc { 0x04c11db7, 0xffffffff, 0xffffffff };
+		crc.process_bytes(data.data(), data.size());
+		return crc.checksum();
+	}, data.size(), passes);
+	report_checksum("CRC-32 table", [&data]() {
+		CRC32 crc;
+		crc.process_bytes(data.data(), data.size());
+		return crc.checksum();
+	}, data.size(), passes);
+	report_checksum("Adler-32 per byte", [&data]() {
+		Adler32PerByte adler_32;
+		adler_32.feed(data.data(), data.size());
+		return adler_32.value();
+	}, data.size(), passes);
+	report_checksum("Adler-32 deferred", [&data]() {
+		Adler32 adler_32;
+		adler_32.feed(data.data(), data.size());
+		const auto b = adler_32.bytes();
+		return static_cast<uint32_t>((b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3]);
+	}, data.size(), passes);
+
+	return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Symbols per second through a PacketBuilder per protocol, as the number of
+ * protocols on one symbol stream grows (2 is ERT's SCM and IDM):
+ *
+ * - popcount: each builder tests its own BitPattern with a 64-bit
+ *   popcount, as before
+ * - pattern: each builder tests its own BitPattern, with the
+ *   bit-clearing tolerance test
+ * - set: one BitPatternSet tests every preamble per symbol, and only
+ *   builders that matched or are mid-packet get the symbol
+ *
+ * All three must build the same packets from the same stream.
+ */
+
+#include "packet_builder.hpp"
+#include "bit_pattern.hpp"
+#include "baseband_packet.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <chrono>
+
+namespace {
+
+/* BitPattern as it was. */
+class PopcountBitPattern {
+public:
+	PopcountBitPattern(
+		const uint64_t code,
+		const size_t code_length,
+		const size_t maximum_hanning_distance
+	) : code_ { code },
+		mask_ { (1ULL << code_length) - 1ULL },
+		maximum_hanning_distance_ { maximum_hanning_distance }
+	{
+	}
+
+	bool operator()(const BitHistory& history, const size_t) const {
+		const auto delta_bits = (history.value() ^ code_) & mask_;
+		const size_t count = __builtin_popcountll(delta_bits);
+		return (count <= maximum_hanning_distance_);
+	}
+
+private:
+	uint64_t code_;
+	uint64_t mask_;
+	size_t maximum_hanning_distance_;
+};
+
+class Random {
+public:
+	uint32_t operator()() {
+		state = state * 1103515245 + 12345;
+		return state >> 8;
+	}
+
+private:
+	uint32_t state { 1 };
+};
+
+struct Preamble {
+	uint64_t code;
+	size_t length;
+	size_t tolerance;
+};
+
+constexpr size_t payload_length = 150;
+
+/* Everything the builders hand over, folded into one number. */
+class PacketTally {
+public:
+	void operator()(const size_t protocol, const baseband::Packet& packet) {
+		count++;
+		hash = hash * 31 + protocol;
+		for(size_t i=0; i<packet.size(); i+=32) {
+			hash = hash * 31 + packet.read(i, 32);
+		}
+	}
+
+	size_t count { 0 };
+	uint32_t hash { 0 };
+};
+
+std::vector<Preamble> make_preambles(Random& random, const size_t count) {
+	/* The first two are ERT's. */
+	std::vector<Preamble> preambles {
+		{ 0b101010101001011001100110010110100101010101, 32, 1 },
+		{ 0b0110011001100110011001100110011001010110011010011001100101011010, 48, 1 },
+	};
+	while( preambles.size() < count ) {
+		const size_t length = 32 + (random() % 17);
+		const uint64_t code = ((static_cast<uint64_t>(random()) << 40) ^ (static_cast<uint64_t>(random()) << 20) ^ random()) & ((1ULL << length) - 1);
+		preambles.push_back({ code, length, random() % 3 });
+	}
+	preambles.resize(count);
+	return preambles;
+}
+
+/* Noise, with a packet for one of the protocols every so often. */
+std::vector<uint8_t> make_symbols(Random& random, const std::vector<Preamble>& preambles) {
+	std::vector<uint8_t> symbols;
+	while( symbols.size() < (1 << 20) ) {
+		for(size_t i=0; i<1000; i++) {
+			symbols.push_back(random() & 1);
+		}
+		const auto& preamble = preambles[random() % preambles.size()];
+		for(size_t i=preamble.length; i>0; i--) {
+			symbols.push_back((preamble.code >> (i - 1)) & 1);
+		}
+		for(size_t i=0; i<payload_length; i++) {
+			symbols.push_back(random() & 1);
+		}
+	}
+	return symbols;
+}
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Matcher>
+using Builder = PacketBuilder<Matcher, NeverMatch, FixedLength>;
+
+/* One builder per protocol, each testing its own pattern. */
+template<typename Pattern>
+double separate(const std::vector<Preamble>& preambles, const std::vector<uint8_t>& symbols, PacketTally& tally) {
+	std::vector<Builder<Pattern>> builders;
+	builders.reserve(preambles.size());
+	for(size_t n=0; n<preambles.size(); n++) {
+		const auto& p = preambles[n];
+		builders.emplace_back(
+			Pattern { p.code, p.length, p.tolerance }, NeverMatch { }, FixedLength { payload_length },
+			[&tally, n](const baseband::Packet& packet) { tally(n, packet); }
+		);
+	}
+
+	const auto start = Clock::now();
+	for(const auto symbol : symbols) {
+		for(auto& builder : builders) {
+			builder.execute(symbol);
+		}
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	return symbols.size() / elapsed.count();
+}
+
+/* One pass over every preamble; builders only run once theirs matches. */
+template<size_t N>
+double combined(const std::vector<Preamble>& preambles, const std::vector<uint8_t>& symbols, PacketTally& tally) {
+	std::array<BitPattern, N> patterns;
+	for(size_t n=0; n<N; n++) {
+		patterns[n] = { preambles[n].code, preambles[n].length, preambles[n].tolerance };
+	}
+	const BitPatternSet<N> set { patterns };
+
+	BitHistory history;
+
+	std::vector<Builder<NeverMatch>> builders;
+	builders.reserve(N);
+	for(size_t n=0; n<N; n++) {
+		builders.emplace_back(
+			NeverMatch { }, NeverMatch { }, FixedLength { payload_length },
+			[&tally, n](const baseband::Packet& packet) { tally(n, packet); }
+		);
+	}
+
+	uint32_t receiving = 0;
+	const auto start = Clock::now();
+	for(const auto symbol : symbols) {
+		history.add(symbol);
+		const auto matches = set(history);
+		for(auto pending = matches | receiving; pending; pending &= pending - 1) {
+			const size_t n = __builtin_ctz(pending);
+			if( builders[n].execute(symbol, (matches >> n) & 1, history) ) {
+				receiving |= 1U << n;
+			} else {
+				receiving &= ~(1U << n);
+			}
+		}
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	return symbols.size() / elapsed.count();
+}
+
+template<size_t N>
+bool run() {
+	Random random;
+	const auto preambles = make_preambles(random, N);
+	const auto symbols = make_symbols(random, preambles);
+
+	PacketTally popcount_tally, pattern_tally, set_tally;
+	const double popcount_rate = separate<PopcountBitPattern>(preambles, symbols, popcount_tally);
+	const double pattern_rate = separate<BitPattern>(preambles, symbols, pattern_tally);
+	const double set_rate = combined<N>(preambles, symbols, set_tally);
+
+	const bool matches =
+		(popcount_tally.count == pattern_tally.count) && (popcount_tally.hash == pattern_tally.hash) &&
+		(popcount_tally.count == set_tally.count) && (popcount_tally.hash == set_tally.hash);
+	std::printf("%9zu %12.2f %12.2f %12.2f %8zu  %s\n",
+		N, popcount_rate / 1e6, pattern_rate / 1e6, set_rate / 1e6,
+		set_tally.count, matches ? "agree" : "DIFFER"
+	);
+	return matches;
+}
+
+} /* namespace */
+
+int main() {
+	std::printf("%9s %12s %12s %12s %8s\n", "protocols", "popcount", "pattern", "set", "packets");
+	std::printf("%9s %12s %12s %12s\n", "", "(Msym/s)", "(Msym/s)", "(Msym/s)");
+	bool matches = true;
+	matches &= run<2>();
+	matches &= run<4>();
+	matches &= run<8>();
+	matches &= run<16>();
+	return matches ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Insert and update rate of RecentEntries, against the std::list container
+ * it replaced, at 64, 1k and 8k entries:
+ *
+ * - insert: every packet from a new transmitter, so once full every
+ *   packet also evicts the oldest entry
+ * - update: every packet from one of the transmitters already held, so
+ *   every packet moves an entry to the front
+ *
+ * Before timing, both containers take the same mixed stream of packets and
+ * must end up holding the same entries, in the same order.
+ */
+
+#include "recent_entries.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+struct BenchPacket {
+	uint32_t id;
+	uint32_t value;
+};
+
+/* About the size of ERTRecentEntry. */
+struct BenchEntry {
+	using Key = uint32_t;
+
+	static constexpr Key invalid_key = 0;
+
+	Key id { invalid_key };
+	size_t received_count { 0 };
+	uint32_t last_value { 0 };
+
+	BenchEntry(
+		const Key& key
+	) : id { key }
+	{
+	}
+
+	Key key() const {
+		return id;
+	}
+
+	void update(const BenchPacket& packet) {
+		received_count++;
+		last_value = packet.value;
+	}
+};
+
+/* The container as it was: linear search, copy to the front, one heap node
+ * per entry.
+ */
+template<class Packet, class Entry, size_t Capacity>
+class ListRecentEntries {
+public:
+	using Key = typename Entry::Key;
+	using const_iterator = typename std::list<Entry>::const_iterator;
+
+	const Entry& on_packet(const Key key, const Packet& packet) {
+		auto matching_recent = find(key);
+		if( matching_recent != std::end(entries) ) {
+			entries.push_front(*matching_recent);
+			entries.erase(matching_recent);
+		} else {
+			entries.emplace_front(key);
+			while( entries.size() > Capacity ) {
+				entries.pop_back();
+			}
+		}
+
+		auto& entry = entries.front();
+		entry.update(packet);
+		return entry;
+	}
+
+	const_iterator find(const Key key) const {
+		return std::find_if(
+			std::begin(entries), std::end(entries),
+			[key](const Entry& e) { return e.key() == key; }
+		);
+	}
+
+	const_iterator begin() const {
+		return entries.begin();
+	}
+
+	const_iterator end() const {
+		return entries.end();
+	}
+
+private:
+	std::list<Entry> entries;
+};
+
+/* Distinct for 2^32 - 1 steps, and never zero (the invalid key). */
+class XorShift32 {
+public:
+	uint32_t operator()() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+private:
+	uint32_t state { 2463534242U };
+};
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Container, typename Reference>
+bool same_contents(const Container& recent, const Reference& reference) {
+	auto p = recent.begin();
+	for(const auto& expected : reference) {
+		if( (p == recent.end()) || (p->key() != expected.key()) || (p->received_count != expected.received_count) ) {
+			return false;
+		}
+		if( recent.find(expected.key()) != p ) {
+			return false;
+		}
+		++p;
+	}
+	if( p != recent.end() ) {
+		return false;
+	}
+
+	/* And backward, from end(), as RecentEntriesView walks it. */
+	auto q = reference.end();
+	auto r = recent.end();
+	while( q != reference.begin() ) {
+		--q;
+		--r;
+		if( r->key() != q->key() ) {
+			return false;
+		}
+	}
+	return r == recent.begin();
+}
+
+/* Packets from 1.5x as many transmitters as there's room for: a mix of
+ * updates, inserts and evictions.
+ */
+template<size_t Capacity>
+bool check() {
+	RecentEntries<BenchPacket, BenchEntry, Capacity> recent;
+	ListRecentEntries<BenchPacket, BenchEntry, Capacity> reference;
+
+	XorShift32 rng;
+	std::vector<uint32_t> ids(Capacity * 3 / 2);
+	for(auto& id : ids) {
+		id = rng();
+	}
+
+	const size_t packets = std::max<size_t>(Capacity * 32, 20000);
+	for(size_t i=0; i<packets; i++) {
+		const BenchPacket packet { ids[rng() % ids.size()], static_cast<uint32_t>(i) };
+		const auto& a = recent.on_packet(packet.id, packet);
+		const auto& b = reference.on_packet(packet.id, packet);
+		if( (a.key() != b.key()) || (a.received_count != b.received_count) ) {
+			return false;
+		}
+		if( ((i & 1023) == 0) && !same_contents(recent, reference) ) {
+			return false;
+		}
+	}
+	return same_contents(recent, reference);
+}
+
+template<typename Container>
+double insert_rate(Container& recent, const size_t packets) {
+	XorShift32 rng;
+	size_t sink = 0;
+	const auto start = Clock::now();
+	for(size_t i=0; i<packets; i++) {
+		const BenchPacket packet { rng(), static_cast<uint32_t>(i) };
+		sink += recent.on_packet(packet.id, packet).received_count;
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	if( sink != packets ) {
+		std::printf("insert: bad count\n");
+	}
+	return packets / elapsed.count();
+}
+
+template<typename Container>
+double update_rate(Container& recent, const size_t capacity, const size_t packets) {
+	XorShift32 rng;
+	std::vector<uint32_t> ids(capacity);
+	for(auto& id : ids) {
+		id = rng();
+		recent.on_packet(id, { id, 0 });
+	}
+
+	size_t sink = 0;
+	const auto start = Clock::now();
+	for(size_t i=0; i<packets; i++) {
+		const BenchPacket packet { ids[rng() % capacity], static_cast<uint32_t>(i) };
+		sink += recent.on_packet(packet.id, packet).received_count;
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+	if( sink < packets ) {
+		std::printf("update: bad count\n");
+	}
+	return packets / elapsed.count();
+}
+
+/* The list is quadratic in the entry count; cap its work so the 8k case
+ * doesn't take minutes.
+ */
+size_t list_packets(const size_t capacity) {
+	return std::min<size_t>(1 << 20, (size_t(1) << 28) / capacity);
+}
+
+template<size_t Capacity>
+bool run() {
+	constexpr size_t packets = 1 << 22;
+
+	const bool matches = check<Capacity>();
+
+	{
+		ListRecentEntries<BenchPacket, BenchEntry, Capacity> list_insert;
+		ListRecentEntries<BenchPacket, BenchEntry, Capacity> list_update;
+		std::unique_ptr<RecentEntries<BenchPacket, BenchEntry, Capacity>> lru_insert { new RecentEntries<BenchPacket, BenchEntry, Capacity> };
+		std::unique_ptr<RecentEntries<BenchPacket, BenchEntry, Capacity>> lru_update { new RecentEntries<BenchPacket, BenchEntry, Capacity> };
+
+		const double list_i = insert_rate(list_insert, list_packets(Capacity));
+		const double lru_i = insert_rate(*lru_insert, packets);
+		const double list_u = update_rate(list_update, Capacity, list_packets(Capacity));
+		const double lru_u = update_rate(*lru_update, Capacity, packets);
+
+		std::printf("%7zu %-7s %14.0f %14.0f %8.1fx\n", Capacity, "insert", list_i, lru_i, lru_i / list_i);
+		std::printf("%7zu %-7s %14.0f %14.0f %8.1fx\n", Capacity, "update", list_u, lru_u, lru_u / list_u);
+	}
+
+	std::printf("%7zu bytes: %zu in one block (list: %zu nodes of %zu plus heap overhead), order %s\n",
+		Capacity,
+		sizeof(RecentEntries<BenchPacket, BenchEntry, Capacity>),
+		Capacity,
+		sizeof(BenchEntry) + 2 * sizeof(void*),
+		matches ? "matches" : "DIFFERS"
+	);
+
+	return matches;
+}
+
+} /* namespace */
+
+int main() {
+	std::printf("%7s %-7s %14s %14s %9s\n", "entries", "op", "list (pkt/s)", "lru (pkt/s)", "speedup");
+	bool matches = true;
+	matches &= run<64>();
+	matches &= run<1024>();
+	matches &= run<8192>();
+	return matches ? 0 : 1;
+}
@@ -0,0 +1,456 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Deterministic replay of a recording through a baseband processor.
+ *
+ * The processor runs the same loop as BasebandThread::run, with a
+ * FileSource in place of the DMA ring, and everything it sends to the
+ * application queue arrives here instead of at the M0:
+ *
+ * - decoded packets (AIS, TPMS, ERT) are printed as bit strings, one per
+ *   line, with the signal time at the end of the buffer that completed
+ *   them. Diffing that against golden_packets.txt catches any DSP change
+ *   that gains or loses a packet or flips a bit.
+ * - the summary on stderr reports buffers/s and the real time factor:
+ *   throughput of the whole processor rather than of one kernel, followed
+ *   by the processor's last per-stage breakdown (host nanoseconds in place
+ *   of M4 cycles).
+ *
+ * - --transfer n replays n samples per buffer, as a BasebandConfiguration
+ *   ring geometry would, to compare the per-buffer overhead of each size.
+ *
+ *   replay_baseband [--realtime] [--quiet] [--passes n] [--transfer n] <processor> <file.c8> [rate]
+ *   replay_baseband --synthesize <ais|tpms|ert> <file.c8>
+ *   replay_baseband --list
+ */
+
+#include "file_source.hpp"
+#include "iq_synth.hpp"
+
+#include "baseband_processor.hpp"
+#include "proc_am_audio.hpp"
+#include "proc_nfm_audio.hpp"
+#include "proc_wfm_audio.hpp"
+#include "proc_ais.hpp"
+#include "proc_wideband_spectrum.hpp"
+#include "proc_tpms.hpp"
+#include "proc_ert.hpp"
+#include "proc_capture.hpp"
+
+#include "processor_arena.hpp"
+#include "dsp_state.hpp"
+
+#include "audio_dma.hpp"
+#include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "dsp_fir_taps.hpp"
+#include "dsp_iir_config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Host stand-ins for what the processors reach outside themselves for. */
+
+static SharedMemory host_shared_memory;
+SharedMemory& shared_memory = host_shared_memory;
+
+/* Stands in for the M4 event loop thread. */
+static Thread event_loop { 0 };
+Thread* EventDispatcher::thread_event_loop = &event_loop;
+
+namespace audio {
+namespace dma {
+
+static std::array<sample_t, 32> tx_buffer;
+
+audio::buffer_t tx_empty_buffer() {
+	return { tx_buffer.data(), tx_buffer.size() };
+}
+
+} /* namespace dma */
+} /* namespace audio */
+
+namespace {
+
+/* As SpectrumSweepView asks for at 20MHz: 250us for the synthesizers to
+ * settle, 10MHz of each step kept.
+ */
+constexpr uint32_t sweep_settle_samples = 5000;
+constexpr double sweep_step_mhz = 10.0;
+
+/* Same modes, rates and configuration messages as the application sends
+ * (baseband_api.cpp, receiver_model.cpp and the protocol apps).
+ */
+struct ProcessorEntry {
+	const char* const name;
+	const uint32_t sampling_rate;
+	const size_t object_size;
+	const std::function<BasebandProcessor*()> create;
+};
+
+/* As in BasebandThread. */
+baseband::ProcessorArena<
+	NarrowbandAMAudio,
+	NarrowbandFMAudio,
+	WidebandFMAudio,
+	AISProcessor,
+	WidebandSpectrum,
+	TPMSProcessor,
+	ERTProcessor,
+	CaptureProcessor
+> processor_arena;
+
+template<typename T, typename M>
+BasebandProcessor* create_configured(const M& message) {
+	auto processor = processor_arena.create<T>();
+	processor->on_message(&message);
+	return processor;
+}
+
+template<typename T>
+BasebandProcessor* create() {
+	return processor_arena.create<T>();
+}
+
+const std::array<ProcessorEntry, 9> processors { {
+	{ "am", 3072000, sizeof(NarrowbandAMAudio), []() {
+		return create_configured<NarrowbandAMAudio>(AMConfigureMessage {
+			taps_6k0_decim_0, taps_6k0_decim_1, taps_6k0_decim_2,
+			taps_6k0_dsb_channel, AMConfigureMessage::Modulation::DSB,
+			audio_12k_hpf_300hz_config
+		});
+	} },
+	{ "nfm", 3072000, sizeof(NarrowbandFMAudio), []() {
+		return create_configured<NarrowbandFMAudio>(NBFMConfigureMessage {
+			taps_11k0_decim_0, taps_11k0_decim_1, taps_11k0_channel,
+			2, 2500,
+			audio_24k_hpf_300hz_config, audio_24k_deemph_300_6_config
+		});
+	} },
+	{ "wfm", 3072000, sizeof(WidebandFMAudio), []() {
+		return create_configured<WidebandFMAudio>(WFMConfigureMessage {
+			taps_200k_wfm_decim_0, taps_200k_wfm_decim_1, taps_64_lp_156_198,
+			75000,
+			audio_48k_hpf_30hz_config, audio_48k_deemph_2122_6_config
+		});
+	} },
+	{ "ais", 2457600, sizeof(AISProcessor), create<AISProcessor> },
+	{ "spectrum", 20000000, sizeof(WidebandSpectrum), []() {
+		return create_configured<WidebandSpectrum>(SpectrumStreamingConfigMessage {
+			SpectrumStreamingConfigMessage::Mode::Running
+		});
+	} },
+	{ "sweep", 20000000, sizeof(WidebandSpectrum), []() {
+		auto processor = create_configured<WidebandSpectrum>(SpectrumStreamingConfigMessage {
+			SpectrumStreamingConfigMessage::Mode::Sweeping
+		});
+		const SpectrumSweepStepMessage message { 0, sweep_settle_samples };
+		processor->on_message(&message);
+		return processor;
+	} },
+	{ "tpms", 2457600, sizeof(TPMSProcessor), create<TPMSProcessor> },
+	{ "ert", 4194304, sizeof(ERTProcessor), create<ERTProcessor> },
+	{ "capture", 3072000, sizeof(CaptureProcessor), []() {
+		return create_configured<CaptureProcessor>(CaptureStreamingConfigMessage {
+			CaptureStreamingConfigMessage::Mode::Running, 8
+		});
+	} },
+} };
+
+const ProcessorEntry* find_processor(const std::string& name) {
+	for(const auto& entry : processors) {
+		if( name == entry.name ) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+std::string packet_hex(const baseband::Packet& packet) {
+	static const char digits[] = "0123456789abcdef";
+	std::string result;
+	for(size_t i=0; i<packet.size(); i+=4) {
+		uint_fast8_t nibble = 0;
+		for(size_t j=0; j<4; j++) {
+			nibble <<= 1;
+			if( ((i + j) < packet.size()) && packet[i + j] ) {
+				nibble |= 1;
+			}
+		}
+		result += digits[nibble];
+	}
+	return result;
+}
+
+/* Takes the place of the M0 end of the application queue. */
+class Sink {
+public:
+	Sink(
+		const FileSource& source,
+		const bool print_packets
+	) : source(source),
+		print_packets { print_packets }
+	{
+	}
+
+	void on_message(const Message* const message) {
+		switch(message->id) {
+		case Message::ID::AISPacket:
+			packet("AIS", reinterpret_cast<const AISPacketMessage*>(message)->packet);
+			break;
+
+		case Message::ID::TPMSPacket:
+			packet("TPMS", reinterpret_cast<const TPMSPacketMessage*>(message)->packet);
+			break;
+
+		case Message::ID::ERTPacket:
+			{
+				const auto ert_message = reinterpret_cast<const ERTPacketMessage*>(message);
+				packet((ert_message->type == ert::Packet::Type::SCM) ? "ERT-SCM" : "ERT-IDM", ert_message->packet);
+			}
+			break;
+
+		case Message::ID::ChannelSpectrumConfig:
+			spectrum_fifo = reinterpret_cast<const ChannelSpectrumConfigMessage*>(message)->fifo;
+			break;
+
+		case Message::ID::CaptureFIFO:
+			capture_fifo = reinterpret_cast<const CaptureFIFOMessage*>(message)->fifo;
+			break;
+
+		case Message::ID::StageStatistics:
+			stages = reinterpret_cast<const StageStatisticsMessage*>(message)->statistics;
+			break;
+
+		case Message::ID::SpectrumSweepCaptured:
+			/* The radio retunes in no time here: the next step is posted
+			 * before the next buffer.
+			 */
+			sweep_steps++;
+			sweep_step_next = reinterpret_cast<const SpectrumSweepCapturedMessage*>(message)->step + 1;
+			sweep_step_due = true;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/* What the M0 would do between buffers: consume streamed data. */
+	void drain() {
+		if( spectrum_fifo ) {
+			ChannelSpectrum spectrum;
+			while( spectrum_fifo->out(spectrum) ) {
+				spectra++;
+			}
+		}
+		if( capture_fifo ) {
+			while( capture_fifo->peek_block() ) {
+				capture_fifo->release_block();
+				capture_blocks++;
+			}
+		}
+	}
+
+	size_t packets { 0 };
+	size_t spectra { 0 };
+	size_t sweep_steps { 0 };
+	uint32_t sweep_step_next { 0 };
+	bool sweep_step_due { false };
+	size_t capture_blocks { 0 };
+	StageStatistics stages;
+
+private:
+	const FileSource& source;
+	const bool print_packets;
+	ChannelSpectrumFIFO* spectrum_fifo { nullptr };
+	BlockFIFO* capture_fifo { nullptr };
+
+	void packet(const char* const type, const baseband::Packet& packet) {
+		packets++;
+		if( print_packets ) {
+			std::printf("%9.6f %-7s %4zu %s\n", source.signal_seconds(), type, packet.size(), packet_hex(packet).c_str());
+		}
+	}
+};
+
+int replay(
+	const ProcessorEntry& entry,
+	const std::string& path,
+	const uint32_t sampling_rate,
+	const FileSource::Pacing pacing,
+	const size_t passes,
+	const size_t transfer_samples,
+	const bool print_packets
+) {
+	FileSource source { path, sampling_rate, pacing, passes, transfer_samples };
+	if( !source.is_open() ) {
+		std::fprintf(stderr, "%s: can't open\n", path.c_str());
+		return 1;
+	}
+
+	Sink sink { source, print_packets };
+	shared_memory.application_queue.handler = [&sink](const Message* const message, const size_t) {
+		sink.on_message(message);
+	};
+
+	const auto processor = entry.create();
+
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+
+	while(true) {
+		const auto buffer_tmp = source.read();
+		if( !buffer_tmp ) {
+			break;
+		}
+
+		const buffer_c8_t buffer {
+			buffer_tmp.p, buffer_tmp.count, sampling_rate
+		};
+		processor->execute_transfer(buffer);
+
+		/* Deferred spectrum work, done by the M4 event loop on the device. */
+		const auto events = event_loop.pending_events;
+		event_loop.pending_events = 0;
+		if( events & EVT_MASK_SPECTRUM ) {
+			const UpdateSpectrumMessage message;
+			processor->on_message(&message);
+		}
+
+		sink.drain();
+
+		if( sink.sweep_step_due ) {
+			sink.sweep_step_due = false;
+			const SpectrumSweepStepMessage message { sink.sweep_step_next, sweep_settle_samples };
+			processor->on_message(&message);
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = clock::now() - start;
+	const auto state_used = dsp::state_arena().used();
+	processor_arena.destroy();
+	shared_memory.application_queue.handler = nullptr;
+
+	std::fprintf(stderr, "%s: %zu buffers of %zu (%.3f s of signal) in %.3f s: %.0f buffers/s, %.1f ns/sample, %.1fx real time, %zu packets",
+		entry.name, source.buffers_read(), transfer_samples, source.signal_seconds(), elapsed.count(),
+		source.buffers_read() / elapsed.count(),
+		elapsed.count() * 1e9 / (source.buffers_read() * transfer_samples),
+		source.signal_seconds() / elapsed.count(),
+		sink.packets
+	);
+	if( sink.spectra ) {
+		std::fprintf(stderr, ", %zu spectra", sink.spectra);
+	}
+	if( sink.sweep_steps ) {
+		std::fprintf(stderr, ", %zu sweep steps (%.0f MHz/s)", sink.sweep_steps, sink.sweep_steps * sweep_step_mhz / source.signal_seconds());
+	}
+	if( sink.capture_blocks ) {
+		std::fprintf(stderr, ", %zu capture blocks", sink.capture_blocks);
+	}
+	std::fprintf(stderr, ", %zu + %zu bytes\n", entry.object_size, state_used);
+	for(size_t i=0; i<sink.stages.stage_count; i++) {
+		const auto& stage = sink.stages.stages[i];
+		std::fprintf(stderr, "  %-11s %8u avg %8u max ns/buffer\n", stage.name, stage.avg, stage.max);
+	}
+
+	return 0;
+}
+
+int usage() {
+	std::fprintf(stderr,
+		"usage: replay_baseband [--realtime] [--quiet] [--passes n] [--transfer n] <processor> <file.c8> [sampling rate]\n"
+		"       replay_baseband --synthesize <ais|tpms|ert> <file.c8>\n"
+		"       replay_baseband --list\n"
+	);
+	return 2;
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	if( !args.empty() && (args[0] == "--list") ) {
+		std::printf("%-10s %8s %8s %8s\n", "processor", "rate", "object", "state");
+		for(const auto& entry : processors) {
+			entry.create();
+			std::printf("%-10s %8u %8zu %8zu\n", entry.name, entry.sampling_rate, entry.object_size, dsp::state_arena().used());
+			processor_arena.destroy();
+		}
+		std::printf("arena %zu + %zu bytes\n", processor_arena.size, dsp::state_arena().size());
+		return 0;
+	}
+
+	if( !args.empty() && (args[0] == "--synthesize") ) {
+		if( args.size() != 3 ) {
+			return usage();
+		}
+		if( !iq_synth::synthesize(args[1], args[2]) ) {
+			std::fprintf(stderr, "%s: can't synthesize %s\n", args[2].c_str(), args[1].c_str());
+			return 1;
+		}
+		return 0;
+	}
+
+	auto pacing = FileSource::Pacing::AsFastAsPossible;
+	size_t passes = 1;
+	size_t transfer_samples = 2048;
+	bool print_packets = true;
+	while( !args.empty() && (args[0].compare(0, 2, "--") == 0) ) {
+		if( args[0] == "--realtime" ) {
+			pacing = FileSource::Pacing::Realtime;
+		} else if( args[0] == "--quiet" ) {
+			print_packets = false;
+		} else if( (args[0] == "--passes") && (args.size() > 1) ) {
+			passes = std::max(1UL, std::stoul(args[1]));
+			args.erase(args.begin());
+		} else if( (args[0] == "--transfer") && (args.size() > 1) ) {
+			transfer_samples = std::stoul(args[1]);
+			args.erase(args.begin());
+		} else {
+			return usage();
+		}
+		args.erase(args.begin());
+	}
+
+	if( (args.size() < 2) || (args.size() > 3) ) {
+		return usage();
+	}
+
+	const auto entry = find_processor(args[0]);
+	if( entry == nullptr ) {
+		std::fprintf(stderr, "%s: no such processor (see --list)\n", args[0].c_str());
+		return 2;
+	}
+
+	const uint32_t sampling_rate = (args.size() == 3) ? std::stoul(args[2]) : entry->sampling_rate;
+
+	return replay(*entry, args[1], sampling_rate, pacing, passes, transfer_samples, print_packets);
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Checks of SpectrumAverager, through the ChannelSpectrum it hands the
+ * display:
+ *
+ * - calibration: a bin-centred tone, with a little noise, reads the same
+ *   as on the old display (256-point FFT, three-point Hamming kernel) for
+ *   every window and FFT size, and for WOLA-presummed input, within 0.2dB
+ * - averaging: the spread of the noise floor falls with the number of
+ *   segments averaged as it should for a chi-square power estimate
+ * - holds: MaxHold never falls, MinHold never rises, frame to frame
+ *
+ * Exits non-zero if any of them fail.
+ */
+
+#include "spectrum_averager.hpp"
+#include "dsp_wola.hpp"
+#include "complex.hpp"
+#include "message.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <array>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+namespace {
+
+using Window = SpectrumAverager::Window;
+using Trace = SpectrumAverager::Trace;
+
+struct WindowEntry {
+	const char* const name;
+	const Window window;
+};
+
+const std::array<WindowEntry, 3> windows { {
+	{ "hann", Window::Hann },
+	{ "blackman-harris", Window::BlackmanHarris },
+	{ "flat-top", Window::FlatTop },
+} };
+
+const std::array<size_t, 5> fft_sizes { { 64, 128, 256, 512, 1024 } };
+
+constexpr double calibration_tolerance_db = 0.2;
+
+/* One display step: ChannelSpectrum::db counts 5 to the dB. */
+constexpr double db_step = 0.2;
+
+/* Gaussian noise that comes out the same everywhere: mt19937's output is
+ * fixed by the standard, std::normal_distribution's isn't.
+ */
+class Noise {
+public:
+	double next() {
+		if( have_spare ) {
+			have_spare = false;
+			return spare;
+		}
+		const double u1 = (rng() + 1.0) / 4294967296.0;
+		const double u2 = rng() / 4294967296.0;
+		const double r = std::sqrt(-2.0 * std::log(u1));
+		spare = r * std::sin(2.0 * M_PI * u2);
+		have_spare = true;
+		return r * std::cos(2.0 * M_PI * u2);
+	}
+
+private:
+	std::mt19937 rng { 20160101 };
+	double spare { 0.0 };
+	bool have_spare { false };
+};
+
+int16_t saturate(const double v) {
+	return std::max(-32768L, std::min(32767L, std::lround(v)));
+}
+
+/* Tone at a sixteenth of the sampling rate, bin-centred at every size
+ * checked, plus noise of sigma per component.
+ */
+std::vector<std::complex<double>> tone_plus_noise(
+	const size_t count,
+	const double amplitude,
+	const double sigma,
+	Noise& noise
+) {
+	std::vector<std::complex<double>> samples(count);
+	for(size_t n=0; n<count; n++) {
+		const double phase = 2.0 * M_PI * n / 16.0;
+		samples[n] = {
+			amplitude * std::cos(phase) + sigma * noise.next(),
+			amplitude * std::sin(phase) + sigma * noise.next()
+		};
+	}
+	return samples;
+}
+
+std::vector<complex16_t> to_c16(const std::vector<std::complex<double>>& samples) {
+	std::vector<complex16_t> result(samples.size());
+	for(size_t n=0; n<samples.size(); n++) {
+		result[n] = { saturate(samples[n].real()), saturate(samples[n].imag()) };
+	}
+	return result;
+}
+
+/* The old display, for a bin-centred tone of this amplitude: 256-point
+ * DFT (A * 256), 0.54 centre tap of the kernel, Q15 normalization and the
+ * 2^-30 of mag2_scale.
+ */
+double reference_db(const double amplitude) {
+	return 20.0 * std::log10(0.54 * amplitude * 256.0 / 32768.0);
+}
+
+double reading_db(const uint8_t count) {
+	return (count - 255.0) * db_step;
+}
+
+uint8_t peak(const ChannelSpectrum& spectrum) {
+	return *std::max_element(&spectrum.db[0], &spectrum.db[spectrum.bin_count]);
+}
+
+/* A display count truncates: on its own it only places the level within a
+ * 0.2dB step. Measured at ten amplitudes a tenth of a step apart, each
+ * against its own reference, the truncation averages out to -0.45 of a
+ * step, leaving the calibration error itself.
+ */
+template<typename PeakOf>
+double calibration_error_db(const double level_db, PeakOf peak_of) {
+	double error_sum = 0.0;
+	constexpr size_t offsets = 10;
+	for(size_t i=0; i<offsets; i++) {
+		const double db = level_db + i * db_step / offsets;
+		const double amplitude = 32768.0 / (0.54 * 256.0) * std::pow(10.0, db / 20.0);
+		error_sum += reading_db(peak_of(amplitude)) - reference_db(amplitude);
+	}
+	return error_sum / offsets + 0.45 * db_step;
+}
+
+/* Tone 10dB below the top of the display, noise 50dB below the tone. */
+constexpr double tone_level_db = -10.0;
+constexpr double tone_sigma = 4.0;
+constexpr size_t tone_segments = 4;
+
+double windowed_error_db(SpectrumAverager& averager, const Window window, const size_t fft_size) {
+	Noise noise;
+	return calibration_error_db(tone_level_db, [&](const double amplitude) {
+		averager.configure(fft_size, window, Trace::Average);
+		for(size_t s=0; s<tone_segments; s++) {
+			const auto segment = to_c16(tone_plus_noise(fft_size, amplitude, tone_sigma, noise));
+			averager.add(segment.data(), fft_size - 1, 0);
+		}
+		ChannelSpectrum spectrum;
+		averager.spectrum(spectrum);
+		return peak(spectrum);
+	});
+}
+
+/* WidebandSpectrum's path: 2048 samples through a 2048-point symmetric
+ * Blackman-Harris window, presummed to 1024, averaged as prewindowed. The
+ * presum is done here in double: the check is of the averager's
+ * calibration, not of WindowPresum's arithmetic (the bench covers that).
+ */
+double prewindowed_error_db(SpectrumAverager& averager) {
+	constexpr size_t src_count = dsp::wola::WindowPresum::src_count;
+	constexpr size_t dst_count = dsp::wola::WindowPresum::dst_count;
+
+	std::array<double, src_count> w;
+	for(size_t n=0; n<src_count; n++) {
+		const double x = n * (2.0 * M_PI / (src_count - 1));
+		w[n] = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+	}
+
+	Noise noise;
+	return calibration_error_db(tone_level_db, [&](const double amplitude) {
+		averager.configure_prewindowed(dst_count, dsp::wola::WindowPresum::coherent_gain, Trace::Average);
+		for(size_t s=0; s<tone_segments; s++) {
+			const auto src = tone_plus_noise(src_count, amplitude, tone_sigma, noise);
+			std::vector<std::complex<double>> presummed(dst_count);
+			for(size_t i=0; i<dst_count; i++) {
+				presummed[i] = w[i] * src[i] + w[i + dst_count] * src[i + dst_count];
+			}
+			const auto segment = to_c16(presummed);
+			averager.add(segment.data(), dst_count - 1, 0);
+		}
+		ChannelSpectrum spectrum;
+		averager.spectrum(spectrum);
+		return peak(spectrum);
+	});
+}
+
+/* White noise reads about 13dB below the top of the display at 256 points,
+ * clear of both ends even for single segments.
+ */
+constexpr double floor_sigma = 512.0;
+constexpr size_t floor_fft_size = 256;
+
+std::vector<complex16_t> noise_segment(Noise& noise) {
+	return to_c16(tone_plus_noise(floor_fft_size, 0.0, floor_sigma, noise));
+}
+
+/* Standard deviation in dB of the mean of K exponentially distributed
+ * powers (chi-square, 2K degrees of freedom): 10/ln(10) * sqrt(trigamma(K)).
+ */
+double expected_floor_sd_db(const size_t segments) {
+	double trigamma = M_PI * M_PI / 6.0;
+	for(size_t j=1; j<segments; j++) {
+		trigamma -= 1.0 / (static_cast<double>(j) * j);
+	}
+	return 10.0 / std::log(10.0) * std::sqrt(trigamma);
+}
+
+double floor_sd_db(SpectrumAverager& averager, const size_t segments) {
+	constexpr size_t frames = 64;
+
+	Noise noise;
+	averager.configure(floor_fft_size, Window::Hann, Trace::Average);
+	double sum = 0.0, sum2 = 0.0;
+	size_t count = 0;
+	for(size_t f=0; f<frames; f++) {
+		for(size_t s=0; s<segments; s++) {
+			const auto segment = noise_segment(noise);
+			averager.add(segment.data(), floor_fft_size - 1, 0);
+		}
+		ChannelSpectrum spectrum;
+		averager.spectrum(spectrum);
+		for(size_t i=0; i<spectrum.bin_count; i++) {
+			const double db = reading_db(spectrum.db[i]);
+			sum += db;
+			sum2 += db * db;
+			count++;
+		}
+	}
+	const double mean = sum / count;
+	return std::sqrt(sum2 / count - mean * mean);
+}
+
+/* Frames of one segment each; every bin has to move only one way. */
+bool hold_is_monotonic(SpectrumAverager& averager, const Trace trace) {
+	constexpr size_t frames = 32;
+
+	Noise noise;
+	averager.configure(floor_fft_size, Window::Hann, trace);
+	ChannelSpectrum previous;
+	bool changed = false;
+	for(size_t f=0; f<frames; f++) {
+		const auto segment = noise_segment(noise);
+		averager.add(segment.data(), floor_fft_size - 1, 0);
+		ChannelSpectrum spectrum;
+		averager.spectrum(spectrum);
+		if( f > 0 ) {
+			for(size_t i=0; i<spectrum.bin_count; i++) {
+				const bool wrong_way = (trace == Trace::MaxHold)
+					? (spectrum.db[i] < previous.db[i])
+					: (spectrum.db[i] > previous.db[i]);
+				if( wrong_way ) {
+					return false;
+				}
+				changed |= (spectrum.db[i] != previous.db[i]);
+			}
+		}
+		previous = spectrum;
+	}
+	/* A hold that never moves isn't holding anything. */
+	return changed;
+}
+
+} /* namespace */
+
+int main() {
+	std::unique_ptr<SpectrumAverager> averager { new SpectrumAverager() };
+	bool pass = true;
+
+	std::printf("calibration error (dB), tone at %.0fdB\n", tone_level_db);
+	std::printf("%-16s", "window");
+	for(const auto fft_size : fft_sizes) {
+		std::printf(" %7zu", fft_size);
+	}
+	std::printf("\n");
+	for(const auto& entry : windows) {
+		std::printf("%-16s", entry.name);
+		for(const auto fft_size : fft_sizes) {
+			const double error = windowed_error_db(*averager, entry.window, fft_size);
+			pass &= (std::abs(error) <= calibration_tolerance_db);
+			std::printf(" %7.3f", error);
+		}
+		std::printf("\n");
+	}
+	{
+		const double error = prewindowed_error_db(*averager);
+		pass &= (std::abs(error) <= calibration_tolerance_db);
+		std::printf("%-16s %31s %7.3f\n", "wola presum", "", error);
+	}
+
+	std::printf("\nnoise floor sd (dB), hann, %zu points\n", floor_fft_size);
+	std::printf("%-8s %8s %8s\n", "segments", "measured", "expected");
+	double sd_previous = 1e9;
+	for(const size_t segments : { 1, 2, 4, 7, 16 }) {
+		const double sd = floor_sd_db(*averager, segments);
+		const double expected = expected_floor_sd_db(segments);
+		pass &= (std::abs(sd - expected) <= 0.1 * expected) && (sd < sd_previous);
+		sd_previous = sd;
+		std::printf("%-8zu %8.2f %8.2f\n", segments, sd, expected);
+	}
+
+	std::printf("\n");
+	for(const auto trace : { Trace::MaxHold, Trace::MinHold }) {
+		const bool monotonic = hold_is_monotonic(*averager, trace);
+		pass &= monotonic;
+		std::printf("%-8s %s\n", (trace == Trace::MaxHold) ? "max hold" : "min hold", monotonic ? "monotonic" : "NOT MONOTONIC");
+	}
+
+	std::printf("\n%s\n", pass ? "pass" : "FAIL");
+	return pass ? 0 : 1;
+}
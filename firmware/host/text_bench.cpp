@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Text rendering throughput on font::fixed_8x16, strings per second:
+ *
+ * - per glyph: a window and a bit-by-bit expansion for every character, as
+ *   ILI9341::draw_glyph() does
+ * - run: ui::TextRun, one window per string, rows expanded from the
+ *   cached patterns
+ *
+ * Both methods are first checked against each other pixel for pixel, on an
+ * emulated panel (window plus frame memory). The timed runs only checksum
+ * the pixels: bus timing isn't modelled, the window counts show what the
+ * run saves there.
+ */
+
+#include "ui.hpp"
+#include "ui_text.hpp"
+#include "ui_font_fixed_8x16.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+
+namespace {
+
+/* Enough of the ILI9341 memory write model: a window, filled row by row. */
+class Panel {
+public:
+	void start(const ui::Rect r) {
+		window = r;
+		x = r.left();
+		y = r.top();
+		windows++;
+	}
+
+	void write(const ui::Color pixel) {
+		frame[y * width + x] = pixel.v;
+		if( ++x == window.right() ) {
+			x = window.left();
+			y++;
+		}
+	}
+
+	void write(const ui::Color* const pixels, const size_t count) {
+		for(size_t i=0; i<count; i++) {
+			write(pixels[i]);
+		}
+	}
+
+	bool operator==(const Panel& other) const {
+		return frame == other.frame;
+	}
+
+	static constexpr int width = 240;
+	static constexpr int height = 320;
+
+	uint32_t windows { 0 };
+
+private:
+	std::array<uint16_t, width * height> frame { };
+	ui::Rect window;
+	int x { 0 };
+	int y { 0 };
+};
+
+/* Stands in for the bus in the timed runs. */
+class Checksum {
+public:
+	void start(const ui::Rect) {
+		windows++;
+	}
+
+	void write(const ui::Color pixel) {
+		sum += pixel.v;
+	}
+
+	void write(const ui::Color* const pixels, const size_t count) {
+		for(size_t i=0; i<count; i++) {
+			sum += pixels[i].v;
+		}
+	}
+
+	uint32_t windows { 0 };
+	uint32_t sum { 0 };
+};
+
+struct Line {
+	ui::Point p;
+	std::string text;
+	ui::Color foreground;
+	ui::Color background;
+};
+
+/* A screenful of recent-entries table: header, one highlighted row, and
+ * rows of IDs and readings.
+ */
+std::vector<Line> table_lines() {
+	std::vector<Line> lines;
+	lines.push_back({ { 0, 0 }, "MMSI/Name                Cnt", ui::Color::white(), ui::Color::blue() });
+	for(int i=1; i<20; i++) {
+		const auto background = (i == 3) ? ui::Color::white() : ui::Color::black();
+		const auto foreground = (i == 3) ? ui::Color::black() : ui::Color::white();
+		char text[32];
+		std::snprintf(text, sizeof(text), "%09d %-13.13s %4d", 366998410 + i * 7919, (i & 1) ? "EVER GIVEN" : "PACIFIC TRADER", i * 13);
+		lines.push_back({ { 0, static_cast<int16_t>(i * 16) }, text, foreground, background });
+	}
+	return lines;
+}
+
+template<typename Sink>
+void draw_per_glyph(Sink& panel, const Line& line) {
+	const auto& font = ui::font::fixed_8x16;
+	auto p = line.p;
+	for(const auto c : line.text) {
+		const auto glyph = font.glyph(c);
+		panel.start({ p, glyph.size() });
+		const auto bits = glyph.pixels();
+		const size_t count = glyph.w() * glyph.h();
+		for(size_t i=0; i<count; i++) {
+			const bool set = (bits[i >> 3] >> (i & 7)) & 1;
+			panel.write(set ? line.foreground : line.background);
+		}
+		p += glyph.advance();
+	}
+}
+
+template<typename Sink>
+void draw_run(Sink& panel, ui::TextRun& text_run, const Line& line) {
+	const auto& font = ui::font::fixed_8x16;
+	auto p = line.p;
+	const char* text = line.text.data();
+	size_t length = line.text.size();
+	while( length > 0 ) {
+		const auto n = text_run.fit(font, length);
+		const ui::Size size { static_cast<int>(n * font.char_width()), font.line_height() };
+		panel.start({ p, size });
+		text_run.render(font, text, n, line.foreground, line.background,
+			[&panel](const ui::Color* const pixels, const size_t count) {
+				panel.write(pixels, count);
+			}
+		);
+		p.x += size.w;
+		text += n;
+		length -= n;
+	}
+}
+
+template<typename Draw>
+void report(const char* const name, const std::vector<Line>& lines, const size_t passes, Draw draw) {
+	Checksum panel;
+	const auto start = std::chrono::steady_clock::now();
+	for(size_t pass=0; pass<passes; pass++) {
+		for(const auto& line : lines) {
+			draw(panel, line);
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration<double>(end - start).count();
+	const double strings = static_cast<double>(passes * lines.size());
+	std::printf("%-10s %12.0f %12.1f %12.1f   (checksum %08x)\n",
+		name,
+		strings / seconds,
+		seconds * 1e9 / strings,
+		panel.windows / strings,
+		panel.sum
+	);
+}
+
+} /* namespace */
+
+int main(int argc, char* argv[]) {
+	size_t passes = 20000;
+	if( (argc == 3) && (std::strcmp(argv[1], "--passes") == 0) ) {
+		passes = std::strtoul(argv[2], nullptr, 10);
+	}
+
+	const auto lines = table_lines();
+	ui::TextRun text_run;
+
+	Panel expected;
+	Panel actual;
+	for(const auto& line : lines) {
+		draw_per_glyph(expected, line);
+		draw_run(actual, text_run, line);
+	}
+	if( !(actual == expected) ) {
+		std::fprintf(stderr, "text run differs from per-glyph rendering\n");
+		return 1;
+	}
+
+	std::printf("%-10s %12s %12s %12s\n", "method", "strings/s", "ns/string", "windows/str");
+	report("per glyph", lines, passes,
+		[](Checksum& sink, const Line& line) { draw_per_glyph(sink, line); }
+	);
+	report("run", lines, passes,
+		[&text_run](Checksum& sink, const Line& line) { draw_run(sink, text_run, line); }
+	);
+	return 0;
+}